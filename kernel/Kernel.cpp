@@ -5,6 +5,7 @@
 #include <kernel/arch/x86/Gdt.hpp>
 #include <kernel/arch/x86/Pmm.hpp>
 #include <kernel/arch/x86/Vmm.hpp>
+#include <kernel/arch/x86/KMap.hpp>
 #include <kernel/arch/x86/Syscalls.hpp>
 
 #include <kernel/drivers/Pic.hpp>
@@ -17,15 +18,18 @@
 
 #include <kernel/task/ProcessManager.hpp>
 #include <kernel/task/Scheduler.hpp>
+#include <kernel/task/SharedData.hpp>
 #include <kernel/task/ipc/Ipc.hpp>
 
 #include <kernel/syscalls/SyscallsHandler.hpp>
+#include <kernel/syscalls/SyscallsStats.hpp>
 
 #include <kernel/lib/StdIo.hpp>
 #include <kernel/lib/StdLib.hpp>
 #include <kernel/lib/List.hpp>
 
 #include <kernel/module/Module.hpp>
+#include <kernel/module/ImageCache.hpp>
 
 #include <kernel/handle/HandleManager.h>
 
@@ -51,6 +55,7 @@
 Kernel::Kernel()
 {
     info.pPageDirectory.pdEntry = (PageDirectoryEntry *)KERNEL_PAGE_DIR_P_ADDR;
+    info.pPageDirectory.counters = nullptr;
     info.pPageTables = (PageTableEntry *)KERNEL_PAGES_TABLE_P_ADDR;
     info.pKernelLimit = KERNEL_LIMIT_P_ADDR;
     info.pStackAddr = KERNEL_STACK_P_ADDR;
@@ -90,13 +95,18 @@ void Kernel::Init(MultibootPartialInfo * mbi, u32 multibootMagicNumber)
 
     gPmm.Init();
     gVmm.Init();
+    gKMap.Init();
     gHeap.Init();
+    gPmm.InitReferenceCounters();
     gPagePool.Init();
+    gSharedData.Init();
     gProcessManager.Init();
     gHandleManager.Init();
     gScheduler.Init();
     gIpcHandler.Init();
+    gSyscallsStats.Init();
     gSyscallsX86.Init();
+    gImageCache.Init();
     
     PrintHello();
 }
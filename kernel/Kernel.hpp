@@ -14,7 +14,9 @@
 #define KERNEL_PAGE_POOL_V_BASE_ADDR     0x800000   // Kernel page pool area base virtual address
 #define KERNEL_PAGE_POOL_V_LIMIT_ADDR    0x1000000  // Kernel page pool area limit virtual address
 #define KERNEL_HEAP_V_BASE_ADDR          0x1000000  // Kernel heap base virtual address
-#define KERNEL_HEAP_V_LIMIT_ADDR         0x40000000 // Kernel heap limit virtual address
+#define KERNEL_HEAP_V_LIMIT_ADDR         0x3FC00000 // Kernel heap limit virtual address
+#define KERNEL_KMAP_V_BASE_ADDR          0x3FC00000 // Kernel map window base virtual address (see KMap.hpp)
+#define KERNEL_KMAP_V_LIMIT_ADDR         0x3FC20000 // Kernel map window limit virtual address (KMAP_NB_SLOTS pages)
 #define KERNEL_IMAGE_NAME                "ltkernel.img" // Kernel image name
 
 struct KernelInfo
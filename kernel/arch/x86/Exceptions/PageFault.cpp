@@ -1,4 +1,5 @@
 #include <kernel/task/ProcessManager.hpp>
+#include <kernel/task/Scheduler.hpp>
 #include <kernel/debug/LtDbg.hpp>
 #include <kernel/arch/x86/Process.hpp>
 #include <kernel/lib/StdIo.hpp>
@@ -33,6 +34,7 @@ struct PageFaultDetails
 };
 
 static void PrintPageFaultException(ExceptionContextWithCode* context, PageFaultDetails* const details);
+static void TerminateCurrentThread(Process * const process);
 
 void PageFaultExceptionHandler(ExceptionContextWithCode* const context)
 {
@@ -49,6 +51,13 @@ void PageFaultExceptionHandler(ExceptionContextWithCode* const context)
         {
             KLOG(LOG_ERROR, "Process::ResolvePageFault() failed with code %t (addr : %x)", status, context->cr2);
 
+            // A user stack overflow or a process out of memory only concerns the faulting thread, the system keeps running
+            if (details.us && (status == STATUS_STACK_OVERFLOW || status == STATUS_PROCESS_MEMORY_LIMIT_REACHED || status == STATUS_PHYSICAL_MEMORY_FULL))
+            {
+                TerminateCurrentThread(process);
+                return;
+            }
+
             if (gLtDbg.IsConnected())
             {
                 // gLtDbg.BreakOnError(context);
@@ -67,6 +76,16 @@ void PageFaultExceptionHandler(ExceptionContextWithCode* const context)
     }
     else
     {
+        // Writing in a read-only page may be a write on a copy-on-write page
+        if (details.wr && process != nullptr)
+        {
+            KeStatus status = process->ResolveCopyOnWriteFault((void*)context->cr2);
+            if (!FAILED(status))
+                return;
+
+            KLOG(LOG_ERROR, "Process::ResolveCopyOnWriteFault() failed with code %t (addr : %x)", status, context->cr2);
+        }
+
         PrintPageFaultException(context, &details);
 
         if (process != nullptr)
@@ -78,6 +97,18 @@ void PageFaultExceptionHandler(ExceptionContextWithCode* const context)
     }
 }
 
+/// @brief The current thread is set as dead and is never scheduled again, its process keeps its other threads and its memory
+static void TerminateCurrentThread(Process * const process)
+{
+    Thread * thread = gScheduler.GetCurrentThread();
+
+    KLOG(LOG_ERROR, "Thread %d of process %d is terminated", thread->tid, process->pid);
+
+    thread->state = THREAD_STATE_DEAD;
+
+    gScheduler.ContextSwitchInterrupt();
+}
+
 static void PrintPageFaultException(ExceptionContextWithCode* context, PageFaultDetails * const details)
 {
 
@@ -0,0 +1,90 @@
+#define __KMAP__
+#include "KMap.hpp"
+
+#include <kernel/Kernel.hpp>
+#include <kernel/arch/x86/Vmm.hpp>
+
+#include <kernel/Logger.hpp>
+#define KLOG(LOG_LEVEL, format, ...) KLOGGER("KMAP", LOG_LEVEL, format, ##__VA_ARGS__)
+
+/// @addgroup ArchX86Group
+/// @{
+
+#if KMAP_NB_SLOTS > 32
+#error The kernel map window slots must fit in a 32 bits mask
+#endif
+
+void KMapWindow::Init()
+{
+    _criticalSection = CriticalSection();
+    _usedSlots = 0;
+
+    for (u32 slot = 0; slot < KMAP_NB_SLOTS; slot++)
+    {
+        u32 vAddr = KERNEL_KMAP_V_BASE_ADDR + (slot * PAGE_SIZE);
+        PageTableEntry pte = gVmm.GetPageTableFromVirtualAddress(vAddr);
+
+        gVmm.SetPageTableEntry(&pte, 0, PAGE_EMPTY);
+        gVmm.SetPageTableFromVirtualAddress(vAddr, pte);
+    }
+}
+
+void * KMapWindow::Map(const u32 pAddr)
+{
+    u32 slot = 0;
+    u32 vAddr = 0;
+
+    _criticalSection.Enter();
+
+    while (slot < KMAP_NB_SLOTS && (_usedSlots & (1 << slot)) != 0)
+        slot++;
+
+    if (slot < KMAP_NB_SLOTS)
+        _usedSlots |= (1 << slot);
+
+    _criticalSection.Leave();
+
+    if (slot == KMAP_NB_SLOTS)
+    {
+        KLOG(LOG_ERROR, "Every slot of the kernel map window is used");
+        return nullptr;
+    }
+
+    vAddr = KERNEL_KMAP_V_BASE_ADDR + (slot * PAGE_SIZE);
+
+    gVmm.AddPageToKernelPageDirectory(vAddr, pAddr & 0xFFFFF000, PAGE_PRESENT | PAGE_WRITEABLE);
+
+    return (void*)vAddr;
+}
+
+void KMapWindow::Unmap(const void * const vAddr)
+{
+    u32 vPage = (u32)vAddr & 0xFFFFF000;
+    u32 slot = 0;
+    PageTableEntry pte = { 0 };
+
+    if (!Contains(vAddr))
+    {
+        KLOG(LOG_ERROR, "%x is not in the kernel map window", vAddr);
+        return;
+    }
+
+    slot = (vPage - KERNEL_KMAP_V_BASE_ADDR) / PAGE_SIZE;
+
+    pte = gVmm.GetPageTableFromVirtualAddress(vPage);
+    gVmm.SetPageTableEntry(&pte, 0, PAGE_EMPTY);
+    gVmm.SetPageTableFromVirtualAddress(vPage, pte);
+
+    _criticalSection.Enter();
+
+    _usedSlots &= ~(1 << slot);
+
+    _criticalSection.Leave();
+}
+
+bool KMapWindow::Contains(const void * const vAddr) const
+{
+    return ((u32)vAddr >= KERNEL_KMAP_V_BASE_ADDR && (u32)vAddr < KERNEL_KMAP_V_LIMIT_ADDR);
+}
+
+/// @}
@@ -0,0 +1,49 @@
+#pragma once
+
+/// @file
+
+#include <kernel/lib/Types.hpp>
+#include <kernel/lib/CriticalSection.hpp>
+
+/// @addgroup ArchX86Group
+/// @{
+
+/// @brief Number of pages of the kernel map window, at most 32 (one bit per slot)
+#define KMAP_NB_SLOTS 32
+
+/// @brief Kernel map window : a few pages of the kernel address space where physical pages are mapped temporarily.
+///        The kernel page tables are shared by every page directory, so a page mapped in the window is reachable whatever
+///        the current address space is. It is used to read or write the memory and the page tables of another process
+///        without reloading cr3, only the window entry is invalidated with invlpg.
+///        There is a single processor, so a single window.
+class KMapWindow
+{
+public:
+    /// @brief Clears the window entries
+    void Init();
+
+    /// @brief Maps a physical page in a free slot of the window
+    /// @param[in] pAddr A page aligned physical address
+    /// @return The kernel virtual address of the page, nullptr if every slot is used
+    void * Map(const u32 pAddr);
+
+    /// @brief Unmaps a page mapped with Map(), the slot can be used again
+    /// @param[in] vAddr An address returned by Map(), or any address in the same page
+    void Unmap(const void * const vAddr);
+
+    /// @brief Tells if an address is in the window
+    bool Contains(const void * const vAddr) const;
+
+private:
+    CriticalSection _criticalSection;
+    /// @brief One bit per slot, set if the slot is used
+    u32 _usedSlots;
+};
+
+#ifdef __KMAP__
+KMapWindow gKMap;
+#else
+extern KMapWindow gKMap;
+#endif
+
+/// @}
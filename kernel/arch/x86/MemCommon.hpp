@@ -8,4 +8,7 @@
 /// @brief Page size
 #define PAGE_SIZE 4096
 
+/// @brief Large page size, a large page is mapped by a single page directory entry (PSE)
+#define LARGE_PAGE_SIZE 0x400000
+
 /// @}
@@ -10,12 +10,21 @@
 #include <kernel/multiboot.hpp>
 #include <kernel/Kernel.hpp>
 
+#include <kernel/Logger.hpp>
+#define KLOG(LOG_LEVEL, format, ...) KLOGGER("PMM", LOG_LEVEL, format, ##__VA_ARGS__)
+
 /// @brief Macro used to set a specific bit corresponding on the given page and set it to indicates that the page is used
 #define SET_PAGE_USED(page)   memBitmap[((u32)page) / 8] |= (1 << (((u32)page) % 8))
 
 /// @brief Macro used to set a specific bit corresponding on the given page and set it to indicates that the page is unused
 #define SET_PAGE_UNUSED(addr) memBitmap[((u32)addr / PAGE_SIZE) / 8] &= ~(1 << (((u32)addr / PAGE_SIZE) % 8))
 
+/// @brief Maximum number of references on a physical page, a saturated counter is never decremented
+#define PAGE_MAX_REF_COUNT 0xFFFF
+
+/// @brief Number of bitmap bytes describing a large page
+#define LARGE_PAGE_BITMAP_BYTES ((LARGE_PAGE_SIZE / PAGE_SIZE) / 8)
+
 void PmmBitmap::Init()
 {
     int page = 0;
@@ -25,6 +34,10 @@ void PmmBitmap::Init()
     // We calculate the last page in RAM
     int lastPage = (gMbi.high_mem * 1024) / PAGE_SIZE;
 
+    // Reference counters can't be allocated before the heap is initialized
+    pagesRefCount = nullptr;
+    nbRamPages = (u32)lastPage;
+
     // We set the non-existing pages as used
     for (page = lastPage / 8; page < RAM_MAXPAGE / 8; page++)
         memBitmap[page] = 0xFF;
@@ -48,17 +61,142 @@ void * PmmBitmap::GetFreePage()
                 {
                     u32 page = 8 * byte + bit;
                     SET_PAGE_USED(page);
+
+                    if (pagesRefCount != nullptr && page < nbRamPages)
+                        pagesRefCount[page] = 1;
+
                     return (void*)(page * PAGE_SIZE);
                 }
             }
         }
     }
-    return (void*)(-1);
+    return nullptr;
+}
+
+unsigned int PmmBitmap::GetFreePages(void ** const pages, const unsigned int nbPages)
+{
+    unsigned int nbFound = 0;
+
+    if (pages == nullptr)
+        return 0;
+
+    for (int byte = 0; byte < MEM_BITMAP_SIZE && nbFound < nbPages; byte++)
+    {
+        if (memBitmap[byte] == 0xFF)
+            continue;
+
+        for (int bit = 0; bit < 8 && nbFound < nbPages; bit++)
+        {
+            if (!(memBitmap[byte] & (1 << bit)))
+            {
+                u32 page = 8 * byte + bit;
+                SET_PAGE_USED(page);
+
+                if (pagesRefCount != nullptr && page < nbRamPages)
+                    pagesRefCount[page] = 1;
+
+                pages[nbFound++] = (void*)(page * PAGE_SIZE);
+            }
+        }
+    }
+
+    return nbFound;
+}
+
+void * PmmBitmap::GetFreeLargePage()
+{
+    // A large page is 4Mo aligned, so it is described by a group of bytes of the bitmap that must all be 0
+    for (int byte = 0; byte + LARGE_PAGE_BITMAP_BYTES <= MEM_BITMAP_SIZE; byte += LARGE_PAGE_BITMAP_BYTES)
+    {
+        int index = 0;
+        u32 firstPage = 8 * byte;
+
+        while (index < LARGE_PAGE_BITMAP_BYTES && memBitmap[byte + index] == 0)
+            index++;
+
+        if (index < LARGE_PAGE_BITMAP_BYTES)
+            continue;
+
+        MemSet(&memBitmap[byte], 0xFF, LARGE_PAGE_BITMAP_BYTES);
+
+        if (pagesRefCount != nullptr)
+        {
+            for (u32 page = firstPage; page < firstPage + (LARGE_PAGE_SIZE / PAGE_SIZE) && page < nbRamPages; page++)
+                pagesRefCount[page] = 1;
+        }
+
+        return (void*)(firstPage * PAGE_SIZE);
+    }
+
+    return nullptr;
+}
+
+void PmmBitmap::ReleaseLargePage(void * addr)
+{
+    for (u32 offset = 0; offset < LARGE_PAGE_SIZE; offset += PAGE_SIZE)
+        ReleasePage((void*)((u32)addr + offset));
 }
 
 void PmmBitmap::ReleasePage(void * addr)
 {
+    u32 page = PAGE((u32)addr);
+
+    if (pagesRefCount != nullptr && page < nbRamPages)
+    {
+        // The page is still mapped somewhere else
+        if (pagesRefCount[page] == PAGE_MAX_REF_COUNT)
+            return;
+
+        if (pagesRefCount[page] > 1)
+        {
+            pagesRefCount[page]--;
+            return;
+        }
+
+        pagesRefCount[page] = 0;
+    }
+
     SET_PAGE_UNUSED(addr);
 }
 
+void PmmBitmap::InitReferenceCounters()
+{
+    pagesRefCount = (u16 *)HeapAlloc(nbRamPages * sizeof(u16));
+    if (pagesRefCount == nullptr)
+    {
+        KLOG(LOG_ERROR, "Couldn't allocate %d bytes", nbRamPages * sizeof(u16));
+        gKernel.Panic();
+    }
+
+    MemSet(pagesRefCount, 0, nbRamPages * sizeof(u16));
+}
+
+void PmmBitmap::AddPageReference(void * addr)
+{
+    u32 page = PAGE((u32)addr);
+
+    if (pagesRefCount == nullptr || page >= nbRamPages)
+    {
+        KLOG(LOG_ERROR, "Can't add a reference on page %x", addr);
+        return;
+    }
+
+    // A used page allocated before the counters initialization is owned once
+    if (pagesRefCount[page] == 0)
+        pagesRefCount[page] = 1;
+
+    if (pagesRefCount[page] < PAGE_MAX_REF_COUNT)
+        pagesRefCount[page]++;
+}
+
+unsigned int PmmBitmap::GetPageReferenceCount(void * addr) const
+{
+    u32 page = PAGE((u32)addr);
+
+    if (pagesRefCount == nullptr || page >= nbRamPages)
+        return 0;
+
+    return pagesRefCount[page];
+}
+
 /// @}
\ No newline at end of file
@@ -60,12 +60,45 @@ public:
     /// @return A valid physical page address or nullptr if nothing was found
     void * GetFreePage() override;
 
-    /// @brief Set free a used physical page thanks to its address
+    /// @brief Looks for several free pages in a single pass over the bitmap
+    /// @param[out] pages Array that will hold the physical addresses of the pages
+    /// @param[in]  nbPages Number of pages wanted, the size of the pages array
+    /// @return The number of pages found, which may be lower than nbPages if the memory is almost full
+    unsigned int GetFreePages(void ** const pages, const unsigned int nbPages);
+
+    /// @brief Looks for 4Mo of free, contiguous and 4Mo aligned physical memory, to be mapped as a large page
+    /// @return The physical address of the large page or nullptr if nothing was found
+    void * GetFreeLargePage();
+
+    /// @brief Drops a reference on each physical page of a large page allocated with GetFreeLargePage()
+    /// @param[in] addr The physical address of the large page
+    void ReleaseLargePage(void * addr);
+
+    /// @brief Drops a reference on a used physical page thanks to its address.
+    ///        The page is set free when its last reference is released.
     /// @param[in] The physical page address to be freed
     void ReleasePage(void * addr) override;
 
+    /// @brief Allocates the pages reference counters, so that a physical page can be mapped by more than one virtual page
+    /// @warning Must be called after the kernel heap initialization
+    void InitReferenceCounters();
+
+    /// @brief Adds a reference to a used physical page, it is shared by one more mapping
+    /// @param[in] addr The physical page address
+    void AddPageReference(void * addr);
+
+    /// @brief Retrieves the number of mappings referencing a used physical page
+    /// @param[in] addr The physical page address
+    /// @return The number of references, 0 if the page is not tracked
+    unsigned int GetPageReferenceCount(void * addr) const;
+
 private:
     u8 memBitmap[MEM_BITMAP_SIZE];
+
+    /// Number of references on each physical page (RAM pages only)
+    u16 * pagesRefCount;
+    /// Number of pages in RAM, size of pagesRefCount
+    u32 nbRamPages;
 };
 
 #ifdef __PMM__
@@ -4,9 +4,12 @@
 
 #include <kernel/arch/x86/Vmm.hpp>
 #include <kernel/arch/x86/Pmm.hpp>
+#include <kernel/arch/x86/KMap.hpp>
 #include <kernel/Kernel.hpp>
 #include <kernel/lib/StdLib.hpp>
 #include <kernel/mem/Vad.hpp>
+#include <kernel/syscalls/UKSyscallsCommon.h>
+#include <kernel/syscalls/SyscallsStats.hpp>
 
 #include <kernel/lib/StdIo.hpp>
 
@@ -20,6 +23,13 @@
 
 static int s_ProcessId = 1;
 
+static KeStatus _LookForReservedVad(Vad * const baseVad, void * const address, const unsigned int size, Vad ** const outVad);
+static void _SetPageCopyOnWrite(const u32 vAddr);
+static KeStatus _MapUserPageInKernel(Process * const process, const u32 vPage, u8 ** const kernelPage);
+static KeStatus _MapFilePage(Process * const process, Vad * const vad, const u32 vPage);
+static KeStatus _ClearPage(const void * const pPage);
+static KeStatus _CopyLargePages(Process * const source, Process * const clone, Vad * const vad);
+
 void Process::AddThread(Thread * thread)
 {
     if (thread == nullptr)
@@ -57,29 +67,9 @@ KeStatus Process::IncreaseHeap(unsigned int nbPages, u8 ** allocatedBlockAddr)
         return STATUS_PROCESS_HEAP_LIMIT_REACHED;
     }
 
-    // TODO : revoir le fonctionnement de la heap
-
-    //PageDirectoryEntry * pde = gVmm.GetCurrentPageDirectory();
-    //gVmm.SetCurrentPageDirectory(pageDirectory.pdEntry);
-
-    //for (unsigned int i = 0; i < nbPages; i++)
-    //{
-    //    u32 newBlock = heapLimitAddress + (i * PAGE_SIZE);
-    //    u32 pHeap = (u32)gPmm.GetFreePage();
-
-    //    gVmm.AddPageToPageDirectory(newBlock, pHeap, PAGE_PRESENT | PAGE_WRITEABLE | PAGE_NON_PRIVILEGED_ACCESS, pageDirectory);
-    //}
-
-    //gVmm.SetCurrentPageDirectory(pde);
-
+    // The heap vad is reserved without physical pages, the new ones are committed when they are first touched
     defaultHeap.limitAddress += (nbPages * PAGE_SIZE);
 
-    //if ((defaultHeap.limitAddress - defaultHeap.baseAddress) > PAGE_SIZE)
-    //{
-    //    KLOG(LOG_ERROR, "IncreaseHeap not implemented");
-    //    gKernel.Panic();
-    //}
-
     *allocatedBlockAddr = newBlockAddress;
 
     return STATUS_SUCCESS;
@@ -136,6 +126,12 @@ KeStatus Process::Create(const char * name, Process ** newProcess, Process * par
     process->childrenList = childrenList;
     process->mainThread = nullptr;
     process->baseVad = baseVad;
+    process->ioRing = nullptr;
+    process->syscallTrace = nullptr;
+
+    // The page directory itself comes from the page pool, it isn't counted as one of the process page tables
+    MemSet(&process->memoryCounters, 0, sizeof(MemoryCounters));
+    process->pageDirectory.counters = &process->memoryCounters;
 
     MemCopy(name, &process->name, 512);
 
@@ -194,6 +190,12 @@ KeStatus Process::CreateSystem(Process ** newProcess)
     process->pageDirectory = gKernel.info.pPageDirectory;
     process->pid = 0;
     process->childrenList = childrenList;
+    process->baseVad = nullptr;
+    process->ioRing = nullptr;
+    process->syscallTrace = nullptr;
+
+    // The kernel page directory isn't accounted, the system process has no user memory
+    MemSet(&process->memoryCounters, 0, sizeof(MemoryCounters));
 
     MemCopy(gKernel.info.imageName, &process->name, 512);
 
@@ -234,6 +236,12 @@ void Process::Delete(Process * process)
         process->childrenList = nullptr;
     }
 
+    if (process->syscallTrace != nullptr)
+    {
+        HeapFree(process->syscallTrace);
+        process->syscallTrace = nullptr;
+    }
+
     ReleaseProcessPageDirectoryEntry(process->pageDirectory);
 
     HeapFree(process);
@@ -299,51 +307,77 @@ void Process::ReleaseProcessPageDirectoryEntry(PageDirectory pd)
     }
 }
 
-void Process::MemoryCopy(const u8 * const sourceAddress, u8 * const destAddress, const unsigned int size)
+KeStatus Process::MemoryCopy(const u8 * const sourceAddress, u8 * const destAddress, const unsigned int size)
 {
-    PageDirectoryEntry * currentPd = gVmm.GetCurrentPageDirectory();
-
     if (sourceAddress == nullptr)
     {
         KLOG(LOG_ERROR, "Invalid sourceAddress parameter");
-        return;
+        return STATUS_NULL_PARAMETER;
     }
 
     if (destAddress == nullptr)
     {
         KLOG(LOG_ERROR, "Invalid destAddress parameter");
-        return;
+        return STATUS_NULL_PARAMETER;
     }
 
-    gVmm.SetCurrentPageDirectory(this->pageDirectory.pdEntry);
-
-    MemCopy(sourceAddress, destAddress, size);
-
-    gVmm.SetCurrentPageDirectory(currentPd);
+    return MemorySetAndCopy(sourceAddress, destAddress, size, size, 0);
 }
 
-void Process::MemorySetAndCopy(const u8 * const sourceAddress, u8 * const destAddress, const unsigned int size, const u8 byte)
+KeStatus Process::MemorySetAndCopy(const u8 * const sourceAddress, u8 * const destAddress, const unsigned int size, const unsigned int copySize, const u8 byte)
 {
-    PageDirectoryEntry * currentPd = gVmm.GetCurrentPageDirectory();
+    KeStatus status = STATUS_FAILURE;
+    unsigned int offset = 0;
 
     if (sourceAddress == nullptr)
     {
         KLOG(LOG_ERROR, "Invalid sourceAddress parameter");
-        return;
+        return STATUS_NULL_PARAMETER;
     }
 
     if (destAddress == nullptr)
     {
         KLOG(LOG_ERROR, "Invalid destAddress parameter");
-        return;
+        return STATUS_NULL_PARAMETER;
     }
 
-    gVmm.SetCurrentPageDirectory(this->pageDirectory.pdEntry);
+    if (copySize > size)
+    {
+        KLOG(LOG_ERROR, "Invalid copySize parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
 
-    MemSet(destAddress, byte, size);
-    MemCopy(sourceAddress, destAddress, size);
+    // The destination is reached page by page through the kernel map window, the process address space is never loaded
+    while (offset < size)
+    {
+        u32 vAddr = (u32)destAddress + offset;
+        u32 pageOffset = vAddr & (PAGE_SIZE - 1);
+        unsigned int chunkSize = PAGE_SIZE - pageOffset;
+        unsigned int chunkCopySize = 0;
+        u8 * kernelPage = nullptr;
 
-    gVmm.SetCurrentPageDirectory(currentPd);
+        if (chunkSize > size - offset)
+            chunkSize = size - offset;
+
+        if (offset < copySize)
+            chunkCopySize = (chunkSize < copySize - offset) ? chunkSize : copySize - offset;
+
+        status = _MapUserPageInKernel(this, vAddr & 0xFFFFF000, &kernelPage);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "_MapUserPageInKernel() failed with code %t (addr : %x)", status, vAddr);
+            return status;
+        }
+
+        MemCopy(sourceAddress + offset, kernelPage + pageOffset, chunkCopySize);
+        MemSet(kernelPage + pageOffset + chunkCopySize, byte, chunkSize - chunkCopySize);
+
+        gKMap.Unmap(kernelPage);
+
+        offset += chunkSize;
+    }
+
+    return STATUS_SUCCESS;
 }
 
 KeStatus Process::AllocateMemory(const unsigned int size, const bool reservePhysicalPages, void ** const outAddress)
@@ -378,6 +412,107 @@ clean:
     return status;
 }
 
+KeStatus Process::AllocateStack(const unsigned int size, void ** const outLimit)
+{
+    KeStatus status = STATUS_FAILURE;
+    Vad * newVad = nullptr;
+    void * pTopPage = nullptr;
+
+    if (size == 0)
+    {
+        KLOG(LOG_ERROR, "Invalid size parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (outLimit == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid outLimit parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = baseVad->Allocate(size + STACK_GUARD_SIZE, &pageDirectory, false, &newVad);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Vad::Allocate() failed with code %t", status);
+        newVad = nullptr;
+        goto clean;
+    }
+
+    newVad->guardSize = STACK_GUARD_SIZE;
+
+    // The first frames are pushed in the top page, the following ones fault the pages below it in
+    pTopPage = gPmm.GetFreePage();
+    if (pTopPage == nullptr)
+    {
+        KLOG(LOG_ERROR, "Pmm::GetFreePage() failed to find an available physical page");
+        status = STATUS_PHYSICAL_MEMORY_FULL;
+        goto clean;
+    }
+
+    // The page may still hold the data of its previous owner
+    status = _ClearPage(pTopPage);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "_ClearPage() failed with code %t", status);
+        gPmm.ReleasePage(pTopPage);
+        goto clean;
+    }
+
+    status = gVmm.MapPageInDirectory(pageDirectory, (u32)newVad->limitAddress - PAGE_SIZE, (u32)pTopPage, PAGE_PRESENT | PAGE_WRITEABLE | PAGE_NON_PRIVILEGED_ACCESS);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Vmm::MapPageInDirectory() failed with code %t", status);
+        gPmm.ReleasePage(pTopPage);
+        goto clean;
+    }
+
+    *outLimit = newVad->limitAddress;
+    newVad = nullptr;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    if (newVad != nullptr)
+        newVad->Release(&pageDirectory);
+
+    return status;
+}
+
+KeStatus Process::AllocateLargePages(const unsigned int size, void ** const outAddress)
+{
+    KeStatus status = STATUS_FAILURE;
+    Vad * newVad = nullptr;
+
+    if (size == 0)
+    {
+        KLOG(LOG_ERROR, "Invalid size parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (outAddress == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid outAddress parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (!gVmm.AreLargePagesEnabled())
+        return STATUS_NOT_SUPPORTED;
+
+    status = baseVad->AllocateLargePages((size + LARGE_PAGE_SIZE - 1) & ~(LARGE_PAGE_SIZE - 1), &pageDirectory, &newVad);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Vad::AllocateLargePages() failed with code %t", status);
+        goto clean;
+    }
+
+    *outAddress = newVad->baseAddress;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
 KeStatus Process::AllocateMemoryAtAddress(void * const address, const bool reservePhysicalPages, const unsigned int size)
 {
     KeStatus status = STATUS_FAILURE;
@@ -408,6 +543,52 @@ clean:
     return status;
 }
 
+KeStatus Process::AllocateFileMemoryAtAddress(void * const address, const unsigned int size, u8 * const fileData, const unsigned int fileSize, const bool writable)
+{
+    KeStatus status = STATUS_FAILURE;
+    Vad * newVad = nullptr;
+
+    if (address == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid address parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (((u32)address & (PAGE_SIZE - 1)) != 0)
+    {
+        KLOG(LOG_ERROR, "Address %x is not page aligned", address);
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (size == 0 || fileSize > size)
+    {
+        KLOG(LOG_ERROR, "Invalid size parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (fileData == nullptr && fileSize > 0)
+    {
+        KLOG(LOG_ERROR, "Invalid fileData parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = baseVad->AllocateAtAddress(address, size, &pageDirectory, false, &newVad);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Vad::AllocateAtAddresss() failed with code %t", status);
+        goto clean;
+    }
+
+    newVad->fileData = (fileSize > 0) ? fileData : nullptr;
+    newVad->fileSize = fileSize;
+    newVad->writable = writable;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
 KeStatus Process::CreateDefaultHeapAndStack()
 {
     KeStatus status = STATUS_FAILURE;
@@ -470,37 +651,1098 @@ KeStatus Process::ResolvePageFault(void* const address)
         goto clean;
     }
 
+    // The stack grew down to its guard, the caller must not map anything
+    if ((u32)address < (u32)vad->baseAddress + vad->guardSize)
     {
-        void* pNewPage = gPmm.GetFreePage();
-        if (pNewPage == nullptr)
+        KLOG(LOG_ERROR, "Stack overflow at %x, the stack vad is [%x - %x] (Process %d)", address, vad->baseAddress + vad->guardSize, vad->limitAddress, this->pid);
+        status = STATUS_STACK_OVERFLOW;
+        goto clean;
+    }
+
+    {
+        u32 faultPage = (u32)address & 0xFFFFF000;
+        u32 windowBase = faultPage & ~((PAGE_FAULT_AROUND_PAGES * PAGE_SIZE) - 1);
+        u32 windowLimit = windowBase + (PAGE_FAULT_AROUND_PAGES * PAGE_SIZE);
+        u32 vPages[PAGE_FAULT_AROUND_PAGES];
+        void * pPages[PAGE_FAULT_AROUND_PAGES];
+        unsigned int nbPages = 0;
+        unsigned int nbFound = 0;
+        unsigned int maxPages = PAGE_FAULT_AROUND_PAGES;
+
+        // The fault-around window is shrunk to the pages the process may still commit
+        if (memoryCounters.residentPagesLimit != 0)
+        {
+            if (memoryCounters.residentPages >= memoryCounters.residentPagesLimit)
+            {
+                KLOG(LOG_ERROR, "Resident pages limit reached at %x (%d pages, Process %d)", address, memoryCounters.residentPagesLimit, this->pid);
+                status = STATUS_PROCESS_MEMORY_LIMIT_REACHED;
+                goto clean;
+            }
+
+            if (memoryCounters.residentPagesLimit - memoryCounters.residentPages < maxPages)
+                maxPages = memoryCounters.residentPagesLimit - memoryCounters.residentPages;
+        }
+
+        if (windowBase < (u32)vad->baseAddress + vad->guardSize)
+            windowBase = (u32)vad->baseAddress + vad->guardSize;
+
+        // The window limit is 0 if it is the last window of the address space
+        if (windowLimit == 0 || windowLimit > (u32)vad->limitAddress)
+            windowLimit = (u32)vad->limitAddress;
+
+        // The faulting page comes first, so that it is the one mapped if the memory is almost full
+        vPages[nbPages++] = faultPage;
+
+        // The page tables are edited through the recursive mapping if the process is the current one, else through the kernel map window
+        for (u32 vPage = windowBase; vPage < windowLimit; vPage += PAGE_SIZE)
+        {
+            PageTableEntry pte = { 0 };
+
+            if (nbPages < maxPages && vPage != faultPage && !FAILED(gVmm.GetPageTableEntryInDirectory(this->pageDirectory, vPage, &pte)) && !pte.present)
+                vPages[nbPages++] = vPage;
+        }
+
+        // File backed pages are mapped one by one, most of them don't need a new physical page
+        if (vad->fileData != nullptr || !vad->writable)
+        {
+            for (unsigned int i = 0; i < nbPages; i++)
+            {
+                status = _MapFilePage(this, vad, vPages[i]);
+                if (FAILED(status))
+                {
+                    // The pages around the faulting one are only a bonus
+                    if (i == 0)
+                    {
+                        KLOG(LOG_ERROR, "_MapFilePage() failed with code %t", status);
+                        goto clean;
+                    }
+
+                    break;
+                }
+            }
+
+            status = STATUS_SUCCESS;
+            goto clean;
+        }
+
+        nbFound = gPmm.GetFreePages(pPages, nbPages);
+
+        for (unsigned int i = 0; i < nbFound; i++)
+        {
+            // Anonymous memory reads as zeros, the page may still hold the data of its previous owner
+            status = _ClearPage(pPages[i]);
+            if (!FAILED(status))
+                status = gVmm.MapPageInDirectory(this->pageDirectory, vPages[i], (u32)pPages[i], PAGE_PRESENT | PAGE_WRITEABLE | PAGE_NON_PRIVILEGED_ACCESS);
+
+            if (FAILED(status))
+            {
+                KLOG(LOG_ERROR, "Page %x couldn't be cleared and mapped, code %t", vPages[i], status);
+
+                for (unsigned int j = i; j < nbFound; j++)
+                    gPmm.ReleasePage(pPages[j]);
+
+                goto clean;
+            }
+        }
+
+        if (nbFound == 0)
         {
             // TODO : we should kill the process or something like that... but not have a kernel panic if it is related to a user process
+            KLOG(LOG_ERROR, "Pmm::GetFreePages() failed to find an available physical page");
+            status = STATUS_PHYSICAL_MEMORY_FULL;
+            goto clean;
+        }
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
+KeStatus Process::CommitMemory(const void * const address, const unsigned int size, const bool write)
+{
+    KeStatus status = STATUS_FAILURE;
+    const u32 firstPage = (u32)address & 0xFFFFF000;
+    u32 lastPage = 0;
+
+    if (size == 0)
+        return STATUS_SUCCESS;
+
+    lastPage = ((u32)address + size - 1) & 0xFFFFF000;
+
+    // The last page is checked before moving on, the area may end with the address space
+    for (u32 vPage = firstPage; ; vPage += PAGE_SIZE)
+    {
+        PageTableEntry pte = { 0 };
+
+        status = gVmm.GetPageTableEntryInDirectory(this->pageDirectory, vPage, &pte);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "Vmm::GetPageTableEntryInDirectory() failed with code %t", status);
+            return status;
+        }
+
+        if (!pte.present)
+        {
+            status = ResolvePageFault((void*)vPage);
+            if (FAILED(status))
+            {
+                KLOG(LOG_DEBUG, "ResolvePageFault() failed with code %t (addr : %x)", status, vPage);
+                return status;
+            }
+
+            status = gVmm.GetPageTableEntryInDirectory(this->pageDirectory, vPage, &pte);
+            if (FAILED(status))
+            {
+                KLOG(LOG_ERROR, "Vmm::GetPageTableEntryInDirectory() failed with code %t", status);
+                return status;
+            }
+        }
+
+        if (write && !pte.writable && pte.avail == PAGE_AVAIL_COPY_ON_WRITE)
+        {
+            status = ResolveCopyOnWriteFault((void*)vPage);
+            if (FAILED(status))
+            {
+                KLOG(LOG_DEBUG, "ResolveCopyOnWriteFault() failed with code %t (addr : %x)", status, vPage);
+                return status;
+            }
+        }
+
+        if (vPage == lastPage)
+            break;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus Process::ResolveCopyOnWriteFault(void* const address)
+{
+    KeStatus status = STATUS_FAILURE;
+    Vad * vad = nullptr;
+    u32 vPage = (u32)address & 0xFFFFF000;
+    u32 pPage = 0;
+    PageTableEntry pte = { 0 };
+    PageDirectoryEntry * currentPd = nullptr;
+    u8 * pageCopy = nullptr;
+
+    if (address == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid address parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = _LookForReservedVad(this->baseVad, (void*)vPage, PAGE_SIZE, &vad);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "_LookForReservedVad() failed with code %t", status);
+        return status;
+    }
+
+    currentPd = gVmm.GetCurrentPageDirectory();
+    gVmm.SetCurrentPageDirectory(this->pageDirectory.pdEntry);
+
+    pte = gVmm.GetPageTableFromVirtualAddress(vPage);
+    if (!pte.present || pte.avail != PAGE_AVAIL_COPY_ON_WRITE)
+    {
+        status = STATUS_ACCESS_DENIED;
+        goto clean;
+    }
+
+    pPage = pte.pageAddr << 12;
+
+    // The page isn't shared anymore, it can be written directly
+    if (gPmm.GetPageReferenceCount((void*)pPage) <= 1)
+    {
+        pte.writable = 1;
+        pte.avail = 0;
+        gVmm.SetPageTableFromVirtualAddress(vPage, pte);
+
+        status = STATUS_SUCCESS;
+        goto clean;
+    }
+
+    {
+        void * pNewPage = gPmm.GetFreePage();
+        if (pNewPage == nullptr)
+        {
             KLOG(LOG_ERROR, "Pmm::GetFreePage() failed to find an available physical page");
+            status = STATUS_PHYSICAL_MEMORY_FULL;
+            goto clean;
+        }
+
+        // The shared page content is saved before mapping the new page at the same address
+        pageCopy = (u8 *)HeapAlloc(PAGE_SIZE);
+        if (pageCopy == nullptr)
+        {
+            KLOG(LOG_ERROR, "Couldn't allocate %d bytes", PAGE_SIZE);
+            gPmm.ReleasePage(pNewPage);
+            status = STATUS_ALLOC_FAILED;
             goto clean;
         }
 
-        PageDirectoryEntry* currentPd = gVmm.GetCurrentPageDirectory();
-        gVmm.SetCurrentPageDirectory(this->pageDirectory.pdEntry);
+        MemCopy((void*)vPage, pageCopy, PAGE_SIZE);
 
-        gVmm.AddPageToPageDirectory((u32)address, (u32)pNewPage, PAGE_PRESENT | PAGE_WRITEABLE | PAGE_NON_PRIVILEGED_ACCESS, this->pageDirectory);
+        gVmm.AddPageToPageDirectory(vPage, (u32)pNewPage, PAGE_PRESENT | PAGE_WRITEABLE | PAGE_NON_PRIVILEGED_ACCESS, this->pageDirectory);
 
-        gVmm.SetCurrentPageDirectory(currentPd);
+        MemCopy(pageCopy, (void*)vPage, PAGE_SIZE);
+
+        // Drops this mapping reference on the shared page
+        gPmm.ReleasePage((void*)pPage);
     }
 
     status = STATUS_SUCCESS;
 
 clean:
+    gVmm.SetCurrentPageDirectory(currentPd);
+
+    if (pageCopy != nullptr)
+    {
+        HeapFree(pageCopy);
+        pageCopy = nullptr;
+    }
+
     return status;
 }
 
-void Process::PrintState()
+KeStatus Process::CloneAddressSpace(Process * const clone)
 {
-    kprint("\nProcess %d at address %x\n", pid, this);
-    kprint("Page directory entry : %x\n", pageDirectory.pdEntry);
-    kprint("Default heap (%x - %x, %d bytes)\n", defaultHeap.baseAddress, defaultHeap.limitAddress, defaultHeap.vad->size);
-    kprint("Base vad : [%x - %x, %d bytes]\n\n", baseVad->baseAddress, baseVad->limitAddress, baseVad->size);
+    KeStatus status = STATUS_FAILURE;
 
-    mainThread->PrintList();
+    if (clone == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid clone parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    // The limits are set first, a clone that would exceed them isn't created
+    clone->memoryCounters.residentPagesLimit = this->memoryCounters.residentPagesLimit;
+    clone->memoryCounters.committedBytesLimit = this->memoryCounters.committedBytesLimit;
+
+    // The vads are chained in address order from the base vad
+    for (Vad * vad = this->baseVad; vad != nullptr; vad = vad->next)
+    {
+        Vad * cloneVad = nullptr;
+
+        if (vad->free || (u32)vad->baseAddress == USER_SHARED_DATA_ADDR)
+            continue;
+
+        // The thread stacks belong to the threads of the process, the clone main thread gets its own stack
+        if (vad->guardSize != 0)
+            continue;
+
+        // Large pages can't be copy-on-write, the clone gets its own large pages straight away
+        if (vad->largePages)
+        {
+            status = clone->baseVad->AllocateLargePagesAtAddress(vad->baseAddress, vad->size, &clone->pageDirectory, &cloneVad);
+            if (FAILED(status))
+            {
+                KLOG(LOG_ERROR, "Vad::AllocateLargePagesAtAddress() failed with code %t", status);
+                return status;
+            }
+
+            cloneVad->origin = vad->origin;
+
+            status = _CopyLargePages(this, clone, vad);
+            if (FAILED(status))
+            {
+                KLOG(LOG_ERROR, "_CopyLargePages() failed with code %t", status);
+                return status;
+            }
+
+            continue;
+        }
+
+        status = clone->baseVad->AllocateAtAddress(vad->baseAddress, vad->size, &clone->pageDirectory, false, &cloneVad);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "Vad::AllocateAtAddress() failed with code %t", status);
+            return status;
+        }
+
+        // Pages that are not present yet are resolved by the clone from its own vad
+        cloneVad->fileData = vad->fileData;
+        cloneVad->fileSize = vad->fileSize;
+        cloneVad->writable = vad->writable;
+        cloneVad->origin = vad->origin;
+
+        if (vad == this->defaultHeap.vad)
+        {
+            clone->defaultHeap = this->defaultHeap;
+            clone->defaultHeap.vad = cloneVad;
+        }
+
+        for (u32 vPage = (u32)vad->baseAddress & 0xFFFFF000; vPage < (u32)vad->limitAddress; vPage += PAGE_SIZE)
+        {
+            PageTableEntry pte = { 0 };
+
+            status = gVmm.GetPageTableEntryInDirectory(this->pageDirectory, vPage, &pte);
+            if (FAILED(status))
+            {
+                KLOG(LOG_ERROR, "Vmm::GetPageTableEntryInDirectory() failed with code %t", status);
+                return status;
+            }
+
+            if (!pte.present)
+                continue;
+
+            // Read-only pages are simply shared, the writable ones are copied by the first process writing in them
+            if (pte.writable)
+            {
+                pte.writable = 0;
+                pte.avail = PAGE_AVAIL_COPY_ON_WRITE;
+
+                status = gVmm.SetPageTableEntryInDirectory(this->pageDirectory, vPage, pte);
+                if (FAILED(status))
+                {
+                    KLOG(LOG_ERROR, "Vmm::SetPageTableEntryInDirectory() failed with code %t", status);
+                    return status;
+                }
+            }
+
+            gPmm.AddPageReference((void*)(pte.pageAddr << 12));
+
+            status = gVmm.SetPageTableEntryInDirectory(clone->pageDirectory, vPage, pte);
+            if (FAILED(status))
+            {
+                KLOG(LOG_ERROR, "Vmm::SetPageTableEntryInDirectory() failed with code %t", status);
+                gPmm.ReleasePage((void*)(pte.pageAddr << 12));
+                return status;
+            }
+        }
+    }
+
+    return STATUS_SUCCESS;
+}
+
+void Process::ReleaseAddressSpace()
+{
+    VadTree * tree = nullptr;
+
+    if (this->baseVad == nullptr)
+        return;
+
+    // Releasing a vad merges it with its free neighbors, the chain is walked again from the base vad after each one
+    while (1)
+    {
+        Vad * vad = this->baseVad;
+
+        while (vad != nullptr && (vad->free || (u32)vad->baseAddress == USER_SHARED_DATA_ADDR))
+            vad = vad->next;
+
+        if (vad == nullptr)
+            break;
+
+        if (FAILED(vad->Release(&this->pageDirectory)))
+        {
+            KLOG(LOG_ERROR, "Vad::Release() failed for [%x - %x]", vad->baseAddress, vad->limitAddress);
+            return;
+        }
+    }
+
+    tree = this->baseVad->tree;
+
+    for (Vad * vad = this->baseVad; vad != nullptr;)
+    {
+        Vad * next = vad->next;
+
+        HeapFree(vad);
+        vad = next;
+    }
+
+    HeapFree(tree);
+
+    this->baseVad = nullptr;
+    this->defaultHeap.vad = nullptr;
+}
+
+KeStatus Process::ReleaseMemory(void * const address)
+{
+    KeStatus status = STATUS_FAILURE;
+    Vad * vad = nullptr;
+
+    if (address == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid address parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = this->baseVad->LookForVadFromAddress(address, &vad);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Vad::LookForVadFromAddress() failed with code %t", status);
+        goto clean;
+    }
+
+    if (vad->free || vad->baseAddress != address)
+    {
+        KLOG(LOG_ERROR, "%x is not the base address of a reserved vad", address);
+        status = STATUS_INVALID_PARAMETER;
+        goto clean;
+    }
+
+    // The shared data page is mapped in every process, it would be given back to the physical memory manager
+    if ((u32)address == USER_SHARED_DATA_ADDR)
+    {
+        KLOG(LOG_ERROR, "The shared data page can't be released");
+        status = STATUS_ACCESS_DENIED;
+        goto clean;
+    }
+
+    if (vad == defaultHeap.vad)
+    {
+        KLOG(LOG_ERROR, "The default heap can't be released");
+        status = STATUS_ACCESS_DENIED;
+        goto clean;
+    }
+
+    status = vad->Release(&this->pageDirectory);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Vad::Release() failed with code %t", status);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
+KeStatus Process::SetMemoryOrigin(void * const address, const VadOrigin origin)
+{
+    KeStatus status = STATUS_FAILURE;
+    Vad * vad = nullptr;
+
+    if (address == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid address parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = this->baseVad->LookForVadFromAddress(address, &vad);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Vad::LookForVadFromAddress() failed with code %t", status);
+        goto clean;
+    }
+
+    if (vad->free || vad->baseAddress != address)
+    {
+        KLOG(LOG_ERROR, "%x is not the base address of a reserved vad", address);
+        status = STATUS_INVALID_PARAMETER;
+        goto clean;
+    }
+
+    vad->origin = origin;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
+KeStatus Process::GetMemoryOrigin(void * const address, VadOrigin * const origin)
+{
+    KeStatus status = STATUS_FAILURE;
+    Vad * vad = nullptr;
+
+    if (address == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid address parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (origin == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid origin parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = this->baseVad->LookForVadFromAddress(address, &vad);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Vad::LookForVadFromAddress() failed with code %t", status);
+        goto clean;
+    }
+
+    if (vad->free || vad->baseAddress != address)
+    {
+        KLOG(LOG_ERROR, "%x is not the base address of a reserved vad", address);
+        status = STATUS_INVALID_PARAMETER;
+        goto clean;
+    }
+
+    *origin = vad->origin;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
+KeStatus Process::ProtectMemory(void * const address, const bool writable)
+{
+    KeStatus status = STATUS_FAILURE;
+    Vad * vad = nullptr;
+
+    if (address == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid address parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = this->baseVad->LookForVadFromAddress(address, &vad);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Vad::LookForVadFromAddress() failed with code %t", status);
+        goto clean;
+    }
+
+    if (vad->free || vad->baseAddress != address)
+    {
+        KLOG(LOG_ERROR, "%x is not the base address of a reserved vad", address);
+        status = STATUS_INVALID_PARAMETER;
+        goto clean;
+    }
+
+    // The process would write in the kernel shared data page
+    if ((u32)address == USER_SHARED_DATA_ADDR)
+    {
+        KLOG(LOG_ERROR, "The shared data page protection can't be changed");
+        status = STATUS_ACCESS_DENIED;
+        goto clean;
+    }
+
+    // The protection of the image, the stacks, the heap and the ipc rings is managed by the kernel
+    if (vad->origin == VAD_ORIGIN_KERNEL)
+    {
+        KLOG(LOG_ERROR, "The protection of %x can't be changed", address);
+        status = STATUS_ACCESS_DENIED;
+        goto clean;
+    }
+
+    if (vad->largePages)
+    {
+        KLOG(LOG_ERROR, "The protection of a large pages vad can't be changed");
+        status = STATUS_NOT_SUPPORTED;
+        goto clean;
+    }
+
+    vad->writable = writable;
+
+    // The pages not committed yet will be mapped by ResolvePageFault() according to vad->writable
+    for (u32 vPage = (u32)vad->baseAddress; vPage < (u32)vad->limitAddress; vPage += PAGE_SIZE)
+    {
+        PageTableEntry pte = { 0 };
+
+        status = gVmm.GetPageTableEntryInDirectory(this->pageDirectory, vPage, &pte);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "Vmm::GetPageTableEntryInDirectory() failed with code %t", status);
+            goto clean;
+        }
+
+        if (!pte.present)
+            continue;
+
+        if (!writable)
+        {
+            pte.writable = 0;
+            pte.avail = 0;
+        }
+        // A read-only page may be shared (module image, cloned process), the write fault decides whether it must be copied
+        else if (!pte.writable)
+        {
+            pte.avail = PAGE_AVAIL_COPY_ON_WRITE;
+        }
+
+        status = gVmm.SetPageTableEntryInDirectory(this->pageDirectory, vPage, pte);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "Vmm::SetPageTableEntryInDirectory() failed with code %t", status);
+            goto clean;
+        }
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
+KeStatus Process::DetachPhysicalPages(void * const address, const unsigned int nbPages, const bool copyOnWrite, u32 * const pAddrs)
+{
+    KeStatus status = STATUS_FAILURE;
+    Vad * vad = nullptr;
+    PageDirectoryEntry * currentPd = nullptr;
+    u32 vAddr = (u32)address;
+    unsigned int i = 0;
+
+    if (address == nullptr || ((u32)address & (PAGE_SIZE - 1)) != 0)
+    {
+        KLOG(LOG_ERROR, "Invalid address parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (nbPages == 0)
+    {
+        KLOG(LOG_ERROR, "Invalid nbPages parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (pAddrs == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid pAddrs parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = _LookForReservedVad(this->baseVad, address, nbPages * PAGE_SIZE, &vad);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "_LookForReservedVad() failed with code %t", status);
+        return status;
+    }
+
+    // The 4Ko pages of a large page can't be shared or moved one by one
+    if (vad->largePages)
+    {
+        KLOG(LOG_ERROR, "The area [%x - %x] is mapped by large pages", address, vAddr + nbPages * PAGE_SIZE);
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    currentPd = gVmm.GetCurrentPageDirectory();
+    gVmm.SetCurrentPageDirectory(this->pageDirectory.pdEntry);
+
+    for (i = 0; i < nbPages; i++, vAddr += PAGE_SIZE)
+    {
+        PageTableEntry pte = { 0 };
+
+        // A page that has never been accessed gets its physical page now
+        if (!gVmm.IsVirtualAddressAvailable(vAddr))
+        {
+            status = ResolvePageFault((void*)vAddr);
+            if (FAILED(status))
+            {
+                KLOG(LOG_ERROR, "ResolvePageFault() failed with code %t", status);
+                goto clean;
+            }
+        }
+
+        pte = gVmm.GetPageTableFromVirtualAddress(vAddr);
+
+        if (copyOnWrite)
+        {
+            pAddrs[i] = pte.pageAddr << 12;
+
+            gPmm.AddPageReference((void*)pAddrs[i]);
+
+            // A read-only page stays read-only, it can be shared as it is
+            if (vad->writable)
+                _SetPageCopyOnWrite(vAddr);
+        }
+        else
+        {
+            // A page already shared can't be moved, we take a private copy of it first
+            if (pte.avail == PAGE_AVAIL_COPY_ON_WRITE)
+            {
+                status = ResolveCopyOnWriteFault((void*)vAddr);
+                if (FAILED(status))
+                {
+                    KLOG(LOG_ERROR, "ResolveCopyOnWriteFault() failed with code %t", status);
+                    goto clean;
+                }
+
+                pte = gVmm.GetPageTableFromVirtualAddress(vAddr);
+            }
+
+            pAddrs[i] = pte.pageAddr << 12;
+
+            // The page reference is given to the new mapping, the process will get a new page on its next access
+            gVmm.SetPageTableEntry(&pte, 0, PAGE_WRITEABLE | PAGE_NON_PRIVILEGED_ACCESS);
+            gVmm.SetPageTableFromVirtualAddress(vAddr, pte);
+
+            // The recursive mapping doesn't go through the accounted Vmm functions
+            memoryCounters.residentPages--;
+        }
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    // The pages detached before the failure are given back to the process, the caller won't own them
+    if (FAILED(status))
+    {
+        vAddr = (u32)address;
+
+        for (unsigned int j = 0; j < i; j++, vAddr += PAGE_SIZE)
+        {
+            if (copyOnWrite)
+            {
+                // The page stays copy-on-write, the next write fault finds a single reference and makes it writable again
+                gPmm.ReleasePage((void*)pAddrs[j]);
+            }
+            else
+            {
+                PageTableEntry pte = { 0 };
+
+                gVmm.SetPageTableEntry(&pte, pAddrs[j], PAGE_PRESENT | PAGE_NON_PRIVILEGED_ACCESS | (vad->writable ? PAGE_WRITEABLE : 0));
+                gVmm.SetPageTableFromVirtualAddress(vAddr, pte);
+
+                memoryCounters.residentPages++;
+            }
+        }
+    }
+
+    gVmm.SetCurrentPageDirectory(currentPd);
+
+    return status;
+}
+
+KeStatus Process::AttachPhysicalPages(void * const address, const u32 * const pAddrs, const unsigned int nbPages, const bool copyOnWrite)
+{
+    KeStatus status = STATUS_FAILURE;
+    Vad * vad = nullptr;
+    u32 vAddr = (u32)address;
+    PAGE_FLAG flags = PAGE_PRESENT | PAGE_NON_PRIVILEGED_ACCESS;
+
+    if (address == nullptr || ((u32)address & (PAGE_SIZE - 1)) != 0)
+    {
+        KLOG(LOG_ERROR, "Invalid address parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (pAddrs == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid pAddrs parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (nbPages == 0)
+    {
+        KLOG(LOG_ERROR, "Invalid nbPages parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    status = _LookForReservedVad(this->baseVad, address, nbPages * PAGE_SIZE, &vad);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "_LookForReservedVad() failed with code %t", status);
+        return status;
+    }
+
+    if (!copyOnWrite)
+        flags |= PAGE_WRITEABLE;
+
+    for (unsigned int i = 0; i < nbPages; i++, vAddr += PAGE_SIZE)
+    {
+        status = gVmm.MapPageInDirectory(this->pageDirectory, vAddr, pAddrs[i], flags, copyOnWrite ? PAGE_AVAIL_COPY_ON_WRITE : 0);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "Vmm::MapPageInDirectory() failed with code %t", status);
+            return status;
+        }
+    }
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus Process::MapSharedDataPage(const u32 pAddr)
+{
+    KeStatus status = STATUS_FAILURE;
+
+    status = AllocateMemoryAtAddress((void*)USER_SHARED_DATA_ADDR, false, PAGE_SIZE);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Process::AllocateMemoryAtAddress() failed with code %t", status);
+        return status;
+    }
+
+    // Not writable : the process can only read it, the kernel writes it through its own mapping
+    status = gVmm.MapPageInDirectory(this->pageDirectory, USER_SHARED_DATA_ADDR, pAddr, PAGE_PRESENT | PAGE_NON_PRIVILEGED_ACCESS);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Vmm::MapPageInDirectory() failed with code %t", status);
+        return status;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+void Process::PrintState()
+{
+    kprint("\nProcess %d at address %x\n", pid, this);
+    kprint("Page directory entry : %x\n", pageDirectory.pdEntry);
+    kprint("Default heap (%x - %x, %d bytes)\n", defaultHeap.baseAddress, defaultHeap.limitAddress, defaultHeap.vad->size);
+    kprint("Base vad : [%x - %x, %d bytes]\n\n", baseVad->baseAddress, baseVad->limitAddress, baseVad->size);
+
+    mainThread->PrintList();
+}
+
+void Process::GetMemoryStats(ProcessMemoryStats * const stats)
+{
+    u32 kernelHeapBytes = sizeof(Process);
+    u32 residentBytes = memoryCounters.residentPages * PAGE_SIZE;
+
+    if (stats == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid stats parameter");
+        return;
+    }
+
+    for (Thread * thread = mainThread; thread != nullptr; thread = thread->neighbor)
+        kernelHeapBytes += sizeof(Thread);
+
+    for (Vad * vad = baseVad; vad != nullptr; vad = vad->next)
+        kernelHeapBytes += sizeof(Vad);
+
+    if (syscallTrace != nullptr)
+        kernelHeapBytes += sizeof(SyscallTrace);
+
+    stats->pid = pid;
+    stats->residentPages = memoryCounters.residentPages;
+    stats->peakResidentPages = memoryCounters.peakResidentPages;
+    stats->committedBytes = memoryCounters.committedBytes;
+    stats->untouchedBytes = (memoryCounters.committedBytes > residentBytes) ? memoryCounters.committedBytes - residentBytes : 0;
+    stats->pageTablePages = memoryCounters.pageTablePages;
+    stats->kernelHeapBytes = kernelHeapBytes;
+    stats->residentPagesLimit = memoryCounters.residentPagesLimit;
+    stats->committedBytesLimit = memoryCounters.committedBytesLimit;
+}
+
+/// @brief Looks for the reserved vad containing a whole memory area
+/// @param[in]  baseVad The process base vad
+/// @param[in]  address The area base address
+/// @param[in]  size The area size in bytes
+/// @param[out] outVad Pointer that will hold the found vad
+/// @return STATUS_SUCCESS on success, STATUS_INVALID_VIRTUAL_USER_ADDRESS if the area isn't in a reserved vad, an error code otherwise
+static KeStatus _LookForReservedVad(Vad * const baseVad, void * const address, const unsigned int size, Vad ** const outVad)
+{
+    KeStatus status = STATUS_FAILURE;
+    Vad * vad = nullptr;
+
+    status = baseVad->LookForVadFromAddress(address, &vad);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "No vad found for address %x", address);
+        return STATUS_INVALID_VIRTUAL_USER_ADDRESS;
+    }
+
+    if (vad->free || ((u32)address + size) > (u32)vad->limitAddress || ((u32)address + size) < (u32)address)
+    {
+        KLOG(LOG_DEBUG, "The area [%x - %x] is not in a reserved vad", address, (u32)address + size);
+        return STATUS_INVALID_VIRTUAL_USER_ADDRESS;
+    }
+
+    *outVad = vad;
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Marks a present page of the current address space as read-only and copy-on-write
+/// @param[in] vAddr A 32bits virtual address
+static void _SetPageCopyOnWrite(const u32 vAddr)
+{
+    PageTableEntry pte = gVmm.GetPageTableFromVirtualAddress(vAddr);
+
+    pte.writable = 0;
+    pte.avail = PAGE_AVAIL_COPY_ON_WRITE;
+
+    gVmm.SetPageTableFromVirtualAddress(vAddr, pte);
+}
+
+/// @brief Zero-fills a physical page through the kernel map window, before it is mapped in a process
+/// @param[in] pPage The physical page address
+/// @return STATUS_SUCCESS on success, an error code otherwise
+static KeStatus _ClearPage(const void * const pPage)
+{
+    u8 * kernelPage = (u8*)gKMap.Map((u32)pPage);
+    if (kernelPage == nullptr)
+        return STATUS_ALLOC_FAILED;
+
+    MemSet(kernelPage, 0, PAGE_SIZE);
+
+    gKMap.Unmap(kernelPage);
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Maps a not present page of a file backed (or read-only) vad.
+///        A page entirely made of page aligned file data is mapped in place, read-only, or copy-on-write if the vad is writable.
+///        The other pages get a private physical page holding their part of the file data, the remaining bytes being zeroed.
+/// @param[in] process The process owning the vad, it doesn't have to be the current one
+/// @param[in] vad The reserved vad holding the page
+/// @param[in] vPage The page aligned virtual address
+/// @return STATUS_SUCCESS on success, an error code otherwise
+static KeStatus _MapFilePage(Process * const process, Vad * const vad, const u32 vPage)
+{
+    KeStatus status = STATUS_FAILURE;
+    u32 offset = vPage - (u32)vad->baseAddress;
+    u8 * data = vad->fileData + offset;
+    PAGE_FLAG flags = PAGE_PRESENT | PAGE_NON_PRIVILEGED_ACCESS;
+    u8 * pPage = nullptr;
+    u8 * kernelPage = nullptr;
+    unsigned int copySize = 0;
+
+    if (vad->fileData != nullptr && offset + PAGE_SIZE <= vad->fileSize && ((u32)data & (PAGE_SIZE - 1)) == 0)
+    {
+        // The module image keeps its own reference on the page, it is never set free by the mappings
+        gPmm.AddPageReference(data);
+
+        status = gVmm.MapPageInDirectory(process->pageDirectory, vPage, (u32)data, flags, vad->writable ? PAGE_AVAIL_COPY_ON_WRITE : 0);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "Vmm::MapPageInDirectory() failed with code %t", status);
+            gPmm.ReleasePage(data);
+        }
+
+        return status;
+    }
+
+    pPage = (u8*)gPmm.GetFreePage();
+    if (pPage == nullptr)
+    {
+        KLOG(LOG_ERROR, "Pmm::GetFreePage() failed to find an available physical page");
+        return STATUS_PHYSICAL_MEMORY_FULL;
+    }
+
+    kernelPage = (u8*)gKMap.Map((u32)pPage);
+    if (kernelPage == nullptr)
+    {
+        gPmm.ReleasePage(pPage);
+        return STATUS_ALLOC_FAILED;
+    }
+
+    if (vad->fileData != nullptr && offset < vad->fileSize)
+        copySize = (vad->fileSize - offset < PAGE_SIZE) ? vad->fileSize - offset : PAGE_SIZE;
+
+    MemCopy(data, kernelPage, copySize);
+    MemSet(kernelPage + copySize, 0, PAGE_SIZE - copySize);
+
+    gKMap.Unmap(kernelPage);
+
+    if (vad->writable)
+        flags |= PAGE_WRITEABLE;
+
+    status = gVmm.MapPageInDirectory(process->pageDirectory, vPage, (u32)pPage, flags);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Vmm::MapPageInDirectory() failed with code %t", status);
+        gPmm.ReleasePage(pPage);
+    }
+
+    return status;
+}
+
+/// @brief Maps a page of a process in the kernel map window, so that the kernel can write it whatever the current address space is.
+///        A page that has never been accessed gets its physical page first.
+/// @param[in]  process The process owning the page
+/// @param[in]  vPage The page aligned virtual address in the process
+/// @param[out] kernelPage Pointer that will hold the page address in the window, it must be unmapped with KMapWindow::Unmap()
+/// @return STATUS_SUCCESS on success, an error code otherwise
+static KeStatus _MapUserPageInKernel(Process * const process, const u32 vPage, u8 ** const kernelPage)
+{
+    KeStatus status = STATUS_FAILURE;
+    PageTableEntry pte = { 0 };
+
+    status = gVmm.GetPageTableEntryInDirectory(process->pageDirectory, vPage, &pte);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Vmm::GetPageTableEntryInDirectory() failed with code %t", status);
+        return status;
+    }
+
+    if (!pte.present)
+    {
+        status = process->ResolvePageFault((void*)vPage);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "Process::ResolvePageFault() failed with code %t", status);
+            return status;
+        }
+
+        status = gVmm.GetPageTableEntryInDirectory(process->pageDirectory, vPage, &pte);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "Vmm::GetPageTableEntryInDirectory() failed with code %t", status);
+            return status;
+        }
+    }
+
+    // A copy-on-write page gets its private copy first, like on a user write
+    if (!pte.writable && pte.avail == PAGE_AVAIL_COPY_ON_WRITE)
+    {
+        status = process->ResolveCopyOnWriteFault((void*)vPage);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "Process::ResolveCopyOnWriteFault() failed with code %t", status);
+            return status;
+        }
+
+        status = gVmm.GetPageTableEntryInDirectory(process->pageDirectory, vPage, &pte);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "Vmm::GetPageTableEntryInDirectory() failed with code %t", status);
+            return status;
+        }
+    }
+
+    // A read-only page may be shared with another mapping, it mustn't be modified behind its back
+    if (!pte.writable)
+        return STATUS_ACCESS_DENIED;
+
+    *kernelPage = (u8*)gKMap.Map(pte.pageAddr << 12);
+    if (*kernelPage == nullptr)
+        return STATUS_ALLOC_FAILED;
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Copies the content of a large pages vad in the vad at the same address in a clone, 4Ko at a time through the kernel map window
+/// @param[in] source The process owning the vad
+/// @param[in] clone The clone, its vad must be mapped with large pages too
+/// @param[in] vad The vad of the source process
+static KeStatus _CopyLargePages(Process * const source, Process * const clone, Vad * const vad)
+{
+    KeStatus status = STATUS_FAILURE;
+
+    for (u32 vPage = (u32)vad->baseAddress; vPage < (u32)vad->limitAddress; vPage += PAGE_SIZE)
+    {
+        PageTableEntry sourcePte = { 0 };
+        PageTableEntry clonePte = { 0 };
+        u8 * sourcePage = nullptr;
+        u8 * clonePage = nullptr;
+
+        status = gVmm.GetPageTableEntryInDirectory(source->pageDirectory, vPage, &sourcePte);
+        if (FAILED(status))
+            return status;
+
+        status = gVmm.GetPageTableEntryInDirectory(clone->pageDirectory, vPage, &clonePte);
+        if (FAILED(status))
+            return status;
+
+        if (!sourcePte.present || !clonePte.present)
+            return STATUS_UNEXPECTED;
+
+        sourcePage = (u8*)gKMap.Map(sourcePte.pageAddr << 12);
+        if (sourcePage == nullptr)
+            return STATUS_ALLOC_FAILED;
+
+        clonePage = (u8*)gKMap.Map(clonePte.pageAddr << 12);
+        if (clonePage == nullptr)
+        {
+            gKMap.Unmap(sourcePage);
+            return STATUS_ALLOC_FAILED;
+        }
+
+        MemCopy(sourcePage, clonePage, PAGE_SIZE);
+
+        gKMap.Unmap(clonePage);
+        gKMap.Unmap(sourcePage);
+    }
+
+    return STATUS_SUCCESS;
 }
 
 /// @}
\ No newline at end of file
@@ -15,7 +15,19 @@
 /// TEST : 4 pages
 #define DEFAULT_HEAP_SIZE 0x1000 * 0x4
 
+/// @brief Number of pages of the fault-around window. A demand paging fault maps the faulting page and the not present
+///        pages of its vad in the aligned window holding it, so that sequential accesses don't trap on every page.
+///        Must be a power of two, 1 disables the fault-around.
+#define PAGE_FAULT_AROUND_PAGES 8
+
+/// @brief Size of the guard at the base of a stack vad. It is never mapped, so that a stack overflow is a page fault
+///        detected as such, instead of a write in the memory below the stack.
+#define STACK_GUARD_SIZE PAGE_SIZE
+
 struct Thread;
+struct IoRingQueues;
+struct SyscallTrace;
+struct ProcessMemoryStats;
 
 struct ProcessHeap
 {
@@ -43,11 +55,18 @@ struct Process
     ProcessHeap defaultHeap;
     /// @brief Vads list
     Vad * baseVad;
+    /// @brief Syscalls submission and completion queues, in the process address space, or nullptr
+    IoRingQueues * ioRing;
+    /// @brief Last syscalls of the process, or nullptr if they are not traced
+    SyscallTrace * syscallTrace;
+    /// @brief Memory used by the process, pageDirectory.counters points to it
+    MemoryCounters memoryCounters;
 
     /// @brief Adds a thread to the process. The mainThread is null, it is set with this thread
     void AddThread(Thread * thread);
 
-    /// @brief Increases the process heap of x pages
+    /// @brief Increases the process heap of x pages, inside the default heap vad.
+    ///        The pages are not mapped here, they are committed on the first access by ResolvePageFault().
     /// @param[in]  nbPages The number of pages required
     /// @param[out] allocatedBlockAddr Pointer that will hold the allocated block virtual address
     /// @return STATUS_SUCCESS on success, an error code otherwise
@@ -86,18 +105,23 @@ struct Process
     /// @param[in] pd A page directory structure
     static void ReleaseProcessPageDirectoryEntry(PageDirectory pd);
 
-    /// @brief Copies a source area to a destination
+    /// @brief Copies a kernel area to a destination in the process address space.
+    ///        The process doesn't have to be the current one, its pages are reached through the kernel map window.
     /// @param[in] sourceAddress A pointer to the memory we want to copy
     /// @param[in] destAddress A pointer to the memory where to copy
     /// @param[in] size The memory size in bytes we want to copy
-    void MemoryCopy(const u8 * const sourceAddress, u8 * const destAddress, const unsigned int size);
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus MemoryCopy(const u8 * const sourceAddress, u8 * const destAddress, const unsigned int size);
 
-    /// @brief Sets at memory area with a given byte, and copies a source area to a destination
+    /// @brief Sets at memory area with a given byte, and copies a source area to a destination.
+    ///        The process doesn't have to be the current one, its pages are reached through the kernel map window.
     /// @param[in] sourceAddress A pointer to the memory we want to copy
     /// @param[in] destAddress A pointer to the memory where to copy
-    /// @param[in] size The memory size in bytes we want to copy
+    /// @param[in] size The memory size in bytes we want to set
+    /// @param[in] copySize The memory size in bytes we want to copy, it can't be greater than size
     /// @param[in] byte The byte used to set memory
-    void MemorySetAndCopy(const u8 * const sourceAddress, u8 * const destAddress, const unsigned int size, const u8 byte);
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus MemorySetAndCopy(const u8 * const sourceAddress, u8 * const destAddress, const unsigned int size, const unsigned int copySize, const u8 byte);
 
     /// @brief Looks for a new vad and allocates the required size
     /// @param[in]  size The required size
@@ -106,6 +130,20 @@ struct Process
     /// @return STATUS_SUCCESS on success, an error code otherwise
     KeStatus AllocateMemory(const unsigned int size, const bool reservePhysicalPages, void ** const outAddress);
 
+    /// @brief Reserves a stack growing down from the vad limit. Only its top page is committed, the other ones are mapped on fault
+    ///        as the stack grows, and a STACK_GUARD_SIZE guard is reserved below it : ResolvePageFault() fails with STATUS_STACK_OVERFLOW there.
+    /// @param[in]  size The maximum stack size, without the guard
+    /// @param[out] outLimit Pointer that will hold the stack limit address, the stack pointer starts below it
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus AllocateStack(const unsigned int size, void ** const outLimit);
+
+    /// @brief Looks for a new 4Mo aligned vad and maps it with large pages, committed immediately.
+    ///        Such a vad is released with ReleaseMemory(), it is copied (not shared) when the process is cloned and can't be sent as IPC pages.
+    /// @param[in]  size The required size, rounded up to a multiple of LARGE_PAGE_SIZE
+    /// @param[out] outAddress Pointer that will hold the new address
+    /// @return STATUS_SUCCESS on success, STATUS_NOT_SUPPORTED if the processor doesn't support large pages, an error code otherwise
+    KeStatus AllocateLargePages(const unsigned int size, void ** const outAddress);
+
     /// @brief Looks for a new vad at the asked address and allocates the required size
     /// @param[in] address The asked address
     /// @param[in] reservePhysicalPages Boolean telling if the physical pages must be reserved immediately
@@ -113,10 +151,109 @@ struct Process
     /// @return STATUS_SUCCESS on success, an error code otherwise
     KeStatus AllocateMemoryAtAddress(void * const address, const bool reservePhysicalPages, const unsigned int size);
 
+    /// @brief Looks for a new vad at the asked address, backed by data that stays in kernel memory.
+    ///        No physical page is reserved : on fault, the pages entirely made of page aligned data are mapped in place
+    ///        (copy-on-write if the vad is writable), the other ones get a private copy of their data, zero-filled beyond fileSize.
+    /// @param[in] address The asked address, page aligned
+    /// @param[in] size The required size
+    /// @param[in] fileData The data backing the first bytes of the vad, in an identity mapped module image that is never released
+    /// @param[in] fileSize The number of bytes backed by fileData, lower or equal to size
+    /// @param[in] writable Boolean telling if the process may write in the vad
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus AllocateFileMemoryAtAddress(void * const address, const unsigned int size, u8 * const fileData, const unsigned int fileSize, const bool writable);
+
     /// @brief Try to resolve the page fault given an address by looking for the related VAD in process
     ///        If a VAD in use is found, a new physical page is reserved, and the PTE is updated to set the page as in memory.
+    ///        The not present pages of the VAD in the PAGE_FAULT_AROUND_PAGES window holding the address are mapped too.
+    ///        If the process is the current one, its page tables are edited through the recursive mapping without reloading cr3.
+    /// @return STATUS_SUCCESS on success, STATUS_STACK_OVERFLOW if the address is in the guard of a stack, an error code otherwise
     KeStatus ResolvePageFault(void* const address);
 
+    /// @brief Try to resolve a write access fault on a read-only page marked as copy-on-write.
+    ///        If the physical page is still shared, it is copied in a new physical page mapped as writable,
+    ///        else the page is simply set as writable.
+    /// @param[in] address The faulting address
+    /// @return STATUS_SUCCESS on success, STATUS_ACCESS_DENIED if the page is not a copy-on-write page, an error code otherwise
+    KeStatus ResolveCopyOnWriteFault(void* const address);
+
+    /// @brief Commits the pages of a memory area as the page fault handler would, so that the kernel can access it without faulting.
+    ///        A fault the kernel takes on a user page can't fail the syscall, ResolvePageFault() errors are given back here instead.
+    /// @param[in] address The area address, in reserved vads (see ProbeUserMemory())
+    /// @param[in] size The area size in bytes
+    /// @param[in] write Boolean telling if the kernel is going to write in the area, copy-on-write pages then get their private copy
+    /// @return STATUS_SUCCESS on success, STATUS_PROCESS_MEMORY_LIMIT_REACHED or STATUS_STACK_OVERFLOW if a page can't be committed,
+    ///         an error code otherwise
+    KeStatus CommitMemory(const void * const address, const unsigned int size, const bool write);
+
+    /// @brief Clones the user memory of the process in another process, used to spawn a process from a template.
+    ///        The reserved vads are created at the same addresses in the clone, and the present pages are shared :
+    ///        writable ones are set copy-on-write in both processes, so that the first one writing in a page gets its own copy.
+    ///        The clone heap is the process heap. The shared data page is skipped, every process already maps it,
+    ///        and so are the thread stacks : the clone main thread creates its own one.
+    /// @param[in] clone The new process, its user address space must be empty apart from the shared data page
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus CloneAddressSpace(Process * const clone);
+
+    /// @brief Releases every reserved vad of the process with the physical pages mapped in them, then frees the vads.
+    ///        The shared data page is left to the kernel. Used when the process is deleted, no thread of it may run anymore.
+    void ReleaseAddressSpace();
+
+    /// @brief Releases a memory block allocated with AllocateMemory() or AllocateMemoryAtAddress() and the physical pages mapped in it.
+    ///        The default heap can't be released, IncreaseHeap() keeps handing out addresses in it.
+    /// @param[in] address The memory block base address
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus ReleaseMemory(void * const address);
+
+    /// @brief Records which path reserved a memory block, so that the syscalls releasing memory only accept their own blocks
+    /// @param[in] address The memory block base address
+    /// @param[in] origin The path that reserved the block
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus SetMemoryOrigin(void * const address, const VadOrigin origin);
+
+    /// @brief Retrieves which path reserved a memory block
+    /// @param[in]  address The memory block base address
+    /// @param[out] origin Pointer that will hold the path that reserved the block
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus GetMemoryOrigin(void * const address, VadOrigin * const origin);
+
+    /// @brief Changes the access rights of a whole memory block, including its pages not committed yet.
+    ///        Present pages made read-only are no longer copy-on-write, and the present read-only pages of a block
+    ///        made writable become copy-on-write : a page shared with another mapping is copied on the first write.
+    /// @param[in] address The memory block base address
+    /// @param[in] writable Boolean telling if the process may write in the block
+    /// @return STATUS_SUCCESS on success, STATUS_ACCESS_DENIED for a block reserved by the kernel (VAD_ORIGIN_KERNEL),
+    ///         STATUS_NOT_SUPPORTED for a large pages block, an error code otherwise
+    KeStatus ProtectMemory(void * const address, const bool writable);
+
+    /// @brief Retrieves the physical pages backing a memory area of the process, so that they can be mapped in another address space.
+    ///        If copyOnWrite is true, the process keeps access to the pages : they are shared and become read-only until the next write.
+    ///        Otherwise the pages are moved out of the process : they are unmapped, and a new page is reserved on the next access.
+    /// @param[in]  address The page aligned base address of the area
+    /// @param[in]  nbPages The number of pages in the area
+    /// @param[in]  copyOnWrite Boolean telling if the pages are shared (copy-on-write) or moved
+    /// @param[out] pAddrs Array that will hold the nbPages physical addresses
+    /// @return STATUS_SUCCESS on success, an error code otherwise. On failure, no page is detached.
+    KeStatus DetachPhysicalPages(void * const address, const unsigned int nbPages, const bool copyOnWrite, u32 * const pAddrs);
+
+    /// @brief Maps physical pages retrieved with DetachPhysicalPages() in a reserved memory area of the process
+    /// @param[in] address The page aligned base address of the area, allocated with AllocateMemory() without reserving physical pages
+    /// @param[in] pAddrs Array of nbPages physical addresses
+    /// @param[in] nbPages The number of pages to map
+    /// @param[in] copyOnWrite Boolean telling if the pages are shared with another mapping, and must be mapped as copy-on-write
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus AttachPhysicalPages(void * const address, const u32 * const pAddrs, const unsigned int nbPages, const bool copyOnWrite);
+
+    /// @brief Maps the kernel shared data page read-only at USER_SHARED_DATA_ADDR.
+    ///        The page belongs to the kernel, ReleaseMemory() refuses to release it.
+    /// @param[in] pAddr The shared data page physical address
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus MapSharedDataPage(const u32 pAddr);
+
+    /// @brief Retrieves the memory used by the process. The kernel heap bytes are computed from the structures describing it,
+    ///        the other values come from its memory counters.
+    /// @param[out] stats Pointer that will hold the process memory stats
+    void GetMemoryStats(ProcessMemoryStats * const stats);
+
     void PrintState();
 };
 
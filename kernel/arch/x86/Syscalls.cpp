@@ -2,16 +2,48 @@
 #include "Syscalls.hpp"
 
 #include <kernel/arch/x86/Idt.hpp>
+#include <kernel/arch/x86/Gdt.hpp>
+#include <kernel/arch/x86/Vmm.hpp>
 #include <kernel/arch/x86/InterruptContext.hpp>
 
 #include <kernel/syscalls/SyscallsHandler.hpp>
+#include <kernel/syscalls/UserMemory.hpp>
+#include <kernel/task/ThreadManager.hpp>
+#include <kernel/task/SharedData.hpp>
 
 #include <kernel/Logger.hpp>
 #define KLOG(LOG_LEVEL, format, ...) KLOGGER("SYSCALLSX86", LOG_LEVEL, format, ##__VA_ARGS__)
 
 #define ISR_INDEX_SYSCALL 48
 
+#define IA32_SYSENTER_CS  0x174
+#define IA32_SYSENTER_ESP 0x175
+#define IA32_SYSENTER_EIP 0x176
+
+#define CPUID_FEATURES_LEAF 1
+#define CPUID_FEATURE_SEP   (1 << 11)
+
+/// @brief The entry stub switches to the thread kernel stack straight away, this one is only
+///        used by the processor to load esp on sysenter
+#define SYSENTER_STACK_SIZE 64
+
 extern "C" void _asm_syscall_isr(void);
+extern "C" void _asm_sysenter_isr(void);
+
+static u8 SysenterStack[SYSENTER_STACK_SIZE] __attribute__((aligned(16)));
+
+static inline void Cpuid(const u32 leaf, u32 * const eax, u32 * const edx)
+{
+    u32 ebx = 0;
+    u32 ecx = 0;
+
+    asm volatile("cpuid" : "=a"(*eax), "=b"(ebx), "=c"(ecx), "=d"(*edx) : "a"(leaf));
+}
+
+static inline void WriteMsr(const u32 msr, const u32 value)
+{
+    asm volatile("wrmsr" :: "c"(msr), "a"(value), "d"(0));
+}
 
 extern "C" void syscall_isr(InterruptFromUserlandContext * context)
 {
@@ -24,8 +56,82 @@ extern "C" void syscall_isr(InterruptFromUserlandContext * context)
     SyscallsHandler::ExecuteSyscall((SyscallId)context->eax, context);
 }
 
+extern "C" void sysenter_isr(InterruptFromUserlandContext * context)
+{
+    KeStatus status = STATUS_FAILURE;
+    Thread * thread = nullptr;
+    u32 * userStack = nullptr;
+    u32 returnAddress = 0;
+
+    if (context == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid context parameter");
+        return;
+    }
+
+    thread = gThreadManager.GetCurrentThread();
+    if (thread == nullptr || thread->process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Sysenter made without a current thread");
+        return;
+    }
+
+    // The user stub passed its stack pointer, the address to return to is on top of it.
+    // We return to it the way ret would, so that the stub finds its stack as it left it.
+    userStack = (u32*)context->esp_i;
+    status = CopyFromUser(thread->process, &returnAddress, userStack, sizeof(returnAddress));
+    if (FAILED(status))
+    {
+        // The syscall fails, there is nowhere to return to and the thread faults on its way back to user land
+        KLOG(LOG_ERROR, "Invalid user stack %x on sysenter", userStack);
+        context->eax = status;
+        return;
+    }
+
+    context->eip = returnAddress;
+    context->esp_i = (u32)(userStack + 1);
+
+    SyscallsHandler::ExecuteSyscall((SyscallId)context->eax, context);
+}
+
 void SyscallsX86::Init()
 {
     gIdt.InitDescriptor((u32)(_asm_syscall_isr), SYSCALL_GATE, ISR_INDEX_SYSCALL);
     gIdt.Reload();
+
+    // The interrupt gate stays installed, user stubs fall back to it when sysenter is not supported
+    _fastEntryEnabled = _InitFastEntry();
+
+    // The user stubs choose their entry from the shared data page, they can't disagree with the kernel
+    gSharedData.SetFastSyscallEntry(_fastEntryEnabled);
+
+    KLOG(LOG_INFO, "Fast syscall entry %s", _fastEntryEnabled ? "enabled" : "not supported");
+}
+
+bool SyscallsX86::IsFastEntryEnabled() const
+{
+    return _fastEntryEnabled;
+}
+
+bool SyscallsX86::_InitFastEntry()
+{
+    u32 signature = 0;
+    u32 features = 0;
+
+    Cpuid(CPUID_FEATURES_LEAF, &signature, &features);
+
+    if ((features & CPUID_FEATURE_SEP) == 0)
+        return false;
+
+    // The first Pentium Pro (family 6, model and stepping below 3) report SEP without supporting sysenter
+    if ((signature & 0xF00) == 0x600 && (signature & 0xFF) < 0x33)
+        return false;
+
+    // sysenter loads ss from IA32_SYSENTER_CS + 8, sysexit loads cs and ss from + 16 and + 24,
+    // which matches the gdt layout
+    WriteMsr(IA32_SYSENTER_CS, KERNEL_CODE_SELECTOR);
+    WriteMsr(IA32_SYSENTER_ESP, (u32)&SysenterStack[SYSENTER_STACK_SIZE]);
+    WriteMsr(IA32_SYSENTER_EIP, (u32)_asm_sysenter_isr);
+
+    return true;
 }
@@ -3,7 +3,19 @@
 class SyscallsX86
 {
 public:
+    /// @brief Installs the syscall interrupt gate, and the sysenter entry if the processor supports it.
+    ///        The choice is published in the shared data page, gSharedData must be initialized first.
     void Init();
+
+    /// @brief Indicates if the sysenter entry is set up on this processor
+    bool IsFastEntryEnabled() const;
+
+private:
+    /// @brief Sets the sysenter MSRs up. They are per processor, this must be done on each one of them.
+    /// @return true if the processor supports sysenter, false otherwise
+    bool _InitFastEntry();
+
+    bool _fastEntryEnabled;
 };
 
 #ifdef __SYSCALLS_X86__
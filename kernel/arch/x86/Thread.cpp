@@ -15,7 +15,8 @@
 /// @addgroup ArchX86Group
 /// @{
 
-#define USER_STACK_DEFAULT_SIZE PAGE_SIZE
+/// @brief Maximum size of a user thread stack, only the pages it really uses are committed
+#define USER_STACK_DEFAULT_SIZE (256 * PAGE_SIZE)
 
 static int s_ThreadId = 0;
 
@@ -198,6 +199,7 @@ KeStatus Thread::CreateThread(u32 entryAddr, Process * process, PrivilegeLevel p
     localThread->privilegeLevel = privLevel;
     localThread->neighbor = nullptr;
     localThread->threadPriority = THREAD_PRIORITY_NORMAL;
+    localThread->nextEventWaiter = nullptr;
 
     *thread = localThread;
     localThread = nullptr;
@@ -214,6 +216,21 @@ clean:
     return status;
 }
 
+void Thread::Delete(Thread * thread)
+{
+    if (thread == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid thread parameter");
+        return;
+    }
+
+    if (thread->kernelStackPage.vAddr != 0)
+        PageFree(thread->kernelStackPage);
+
+    HeapFree(thread);
+    thread = nullptr;
+}
+
 KeStatus Thread::_InitUserThread(Thread * thread, Process * process, SecurityAttribute attribute, u32 entryAddr)
 {
     KeStatus status = STATUS_FAILURE;
@@ -267,6 +284,7 @@ KeStatus Thread::_InitUserThread(Thread * thread, Process * process, SecurityAtt
 
     thread->kstack.esp0 = (((u32)kernelStackPage.vAddr + PAGE_SIZE) - (u32)(sizeof(void*)));
     thread->kstack.ss0 = KERNEL_DATA_SELECTOR;
+    thread->kernelStackPage = kernelStackPage;
 
     status = STATUS_SUCCESS;
 
@@ -310,6 +328,7 @@ KeStatus Thread::_InitKernelThread(Thread * thread, u32 entryAddr)
     // These registers shouldn't be used the thread beeing running the kernel land
     thread->kstack.esp0 = 0;
     thread->kstack.ss0 = KERNEL_DATA_SELECTOR;
+    thread->kernelStackPage = kernelStackPage;
 
     status = STATUS_SUCCESS;
 
@@ -322,15 +341,15 @@ KeStatus Thread::CreateDefaultStack()
     KeStatus status = STATUS_FAILURE;
     u32 vUserStack = 0;
 
-    // We create the user thread stack
-    status = this->process->AllocateMemory(USER_STACK_DEFAULT_SIZE, true, (void**)&vUserStack);
+    // We create the user thread stack, vUserStack is its limit : the stack grows down from there
+    status = this->process->AllocateStack(USER_STACK_DEFAULT_SIZE, (void**)&vUserStack);
     if (FAILED(status))
     {
-        KLOG(LOG_ERROR, "Process::AllocateMemory() failed to allocate %d bytes", USER_STACK_DEFAULT_SIZE);
+        KLOG(LOG_ERROR, "Process::AllocateStack() failed to reserve %d bytes", USER_STACK_DEFAULT_SIZE);
         goto clean;
     }
 
-    this->regs.esp = ((vUserStack + (u32)USER_STACK_DEFAULT_SIZE) - (u32)(sizeof(void*)));
+    this->regs.esp = (vUserStack - (u32)(sizeof(void*)));
 
     status = STATUS_SUCCESS;
 
@@ -55,6 +55,8 @@ struct Thread
     ThreadPriorityLevel threadPriority;
     /// @brief Value of the tics member of ClockDrv when the thread is started or resumed
     u32 ticsOnResume;
+    /// @brief Next thread waiting for the same event, see Event
+    Thread * nextEventWaiter;
 
     /// @brief Describes the kernel stack that will be used if an interrupt occured with this thread running
     struct
@@ -63,6 +65,9 @@ struct Thread
         u16 ss0;
     } kstack;
 
+    /// @brief The page holding the kernel stack of the thread, allocated from the page pool
+    Page kernelStackPage;
+
     /// @brief Describes all registers, used to same the current thread state by the scheduler before switching to another task
     struct
     {
@@ -84,7 +89,8 @@ struct Thread
     /// @brief Starts or resumes a thread execution by pushing all necessary registers and using iret instruction (in fact, calls a asm function to do that stuff)
     void StartOrResume();
 
-    /// @brief Creates the default user thread stack
+    /// @brief Creates the default user thread stack : a large range is reserved, with a guard below it, and only its top page is committed.
+    ///        The stack pages are committed on fault as it grows down.
     /// @return STATUS_SUCCESS on success, an error code otherwise
     KeStatus CreateDefaultStack();
 
@@ -106,6 +112,10 @@ struct Thread
     /// @return STATUS_SUCCESS on success, an error code otherwise
     static KeStatus CreateThread(u32 entryAddr, Process * process, PrivilegeLevel privLevel, SecurityAttribute attribute, Thread ** thread);
 
+    /// @brief Frees a thread created with CreateThread() and its kernel stack. The thread must not be running or scheduled.
+    /// @param[in] thread A pointer to the thread to delete
+    static void Delete(Thread * thread);
+
 private:
     static KeStatus _InitUserThread(Thread * thread, Process * process, SecurityAttribute attribute, u32 entryAddr);
     static KeStatus _InitKernelThread(Thread * thread, u32 entryAddr);
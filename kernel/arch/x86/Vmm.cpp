@@ -3,6 +3,8 @@
 
 #include <kernel/lib/StdLib.hpp>
 #include <kernel/arch/x86/Pmm.hpp>
+#include <kernel/arch/x86/KMap.hpp>
+#include <kernel/lib/StdMem.hpp>
 #include <kernel/Kernel.hpp>
 
 #include <kernel/Logger.hpp>
@@ -16,10 +18,20 @@
 #define PD_OFFSET(addr) ((addr) & 0xFFC00000) >> 20
 #define PT_OFFSET(addr) (addr & 0x003FF000) >> 12
 
+#define CPUID_FEATURES_LEAF 1
+#define CPUID_FEATURE_PSE   (1 << 3)
+
+/// @brief Bits of a 4Mo page directory entry that are kept in the equivalent page table entry :
+///        the page base address, the access flags, the global bit and the avail field
+#define LARGE_PAGE_ENTRY_MASK 0xFFC00F7F
+
 /// @brief Assembly routine that set the page directory (by setting the cr3 register) and enables pagging (by setting the cr0 register)
 /// @param[in] pd0_addr A 32bits address of the first page directory entry
 extern "C" void _init_vmm(PageDirectoryEntry * pd0_addr);
 
+/// @brief Assembly routine that enables the page size extension (by setting the cr4 register), must be called before _init_vmm()
+extern "C" void _enable_large_pages();
+
 /// @brief Routine written in assembly that set the current page directory used by the processor (so set the cr3 register)
 /// @param[in] pd A pointer to a physical 32bits address to a page directory entry
 extern "C" void _setCurrentPageDirectory(PageDirectoryEntry * pd);
@@ -28,18 +40,59 @@ extern "C" void _setCurrentPageDirectory(PageDirectoryEntry * pd);
 /// @return A pointer to a page directory entry (physical address)
 extern "C" PageDirectoryEntry * _getCurrentPageDirectory();
 
+/// @brief Invalidates the TLB entry of the page holding a virtual address
+static inline void InvalidatePage(const u32 vAddr)
+{
+    asm volatile("invlpg (%0)" :: "r"(vAddr) : "memory");
+}
+
+static inline void Cpuid(const u32 leaf, u32 * const eax, u32 * const edx)
+{
+    u32 ebx = 0;
+    u32 ecx = 0;
+
+    asm volatile("cpuid" : "=a"(*eax), "=b"(ebx), "=c"(ecx), "=d"(*edx) : "a"(leaf));
+}
+
+/// @brief Builds the page table entry the processor would use for a 4Ko page of a 4Mo page
+/// @param[in]  pde The page directory entry mapping the 4Mo page
+/// @param[in]  vAddr A 32bits virtual address in the 4Mo page
+/// @param[out] pte Will hold the page table entry
+static void GetLargePageTableEntry(const PageDirectoryEntry & pde, const u32 vAddr, PageTableEntry * const pte)
+{
+    *(u32 *)pte = (*(const u32 *)&pde & LARGE_PAGE_ENTRY_MASK) | (vAddr & 0x003FF000);
+}
+
 Vmm::Vmm()
 {
     s_SavedPageDirectoryEntry = nullptr;
+    _largePagesEnabled = false;
 }
 
 void Vmm::Init()
 {
+    u32 signature = 0;
+    u32 features = 0;
+
+    Cpuid(CPUID_FEATURES_LEAF, &signature, &features);
+    _largePagesEnabled = FlagOn(features, CPUID_FEATURE_PSE);
+
     InitKernelPageDirectoryAndPageTables();
     SetIdentityMapping();
 
+    if (_largePagesEnabled)
+        _enable_large_pages();
+
     _init_vmm(gKernel.info.pPageDirectory.pdEntry);
     KLOG(LOG_INFO, "Pagging enabled");
+
+    if (_largePagesEnabled)
+        KLOG(LOG_INFO, "Large pages enabled");
+}
+
+bool Vmm::AreLargePagesEnabled() const
+{
+    return _largePagesEnabled;
 }
 
 void Vmm::InitKernelPageDirectoryAndPageTables()
@@ -71,6 +124,15 @@ void Vmm::SetIdentityMapping()
     PageTableEntry * kernelFirstPt = gKernel.info.pPageTables;
     PageTableEntry * kernelSecondPt = (PageTableEntry *)((unsigned int)kernelFirstPt + PAGE_SIZE);
 
+    // Each 4Mo of the identity mapping is a single page directory entry, the first two page tables are not used
+    if (_largePagesEnabled)
+    {
+        for (u32 pAddr = 0; pAddr < gKernel.info.pKernelLimit; pAddr += LARGE_PAGE_SIZE)
+            SetPageDirectoryEntry(&(gKernel.info.pPageDirectory.pdEntry[pAddr >> 22]), pAddr, PAGE_PRESENT | PAGE_WRITEABLE | PAGE_SIZE_4MO);
+
+        return;
+    }
+
     SetPageDirectoryEntry(gKernel.info.pPageDirectory.pdEntry, (u32)kernelFirstPt, PAGE_PRESENT | PAGE_WRITEABLE);
     SetPageDirectoryEntry(&(gKernel.info.pPageDirectory.pdEntry[1]), (u32)kernelSecondPt, PAGE_PRESENT | PAGE_WRITEABLE);
 
@@ -172,6 +234,10 @@ u32 Vmm::GetPhysicalAddressOf(u32 virtualAddress)
 
     if ((*pde & PAGE_PRESENT))
     {
+        // A 4Mo page has no page table
+        if ((*pde & PAGE_SIZE_4MO))
+            return ((*pde & 0xFFC00000) + (((u32)virtualAddress) & 0x003FFFFF));
+
         // Now, we retrieve the page table entry...
         pte = (u32 *)(0xFFC00000 | (((u32)virtualAddress & 0xFFFFF000) >> 10));
         if ((*pte & PAGE_PRESENT))
@@ -204,13 +270,20 @@ void Vmm::AddPageToKernelPageDirectory(u32 vAddr, u32 pAddr, PAGE_FLAG flags)
         return;
     }
 
+    if (FlagOn(*pde, PAGE_SIZE_4MO))
+    {
+        KLOG(LOG_ERROR, "%p is mapped by a large page", vAddr);
+        gKernel.Panic();
+        return;
+    }
+
     // We retrieve the page table entry and set it with the given physical address
     pte = (u32 *)(0xFFC00000 | ((vAddr & 0xFFFFF000) >> 10));
 
     SetPageTableEntry((PageTableEntry *)pte, pAddr, PAGE_PRESENT | PAGE_WRITEABLE);
 
-    asm("invlpg %0"::"m"(pte));
-    asm("invlpg %0"::"m"(vAddr));
+    InvalidatePage((u32)pte);
+    InvalidatePage((u32)vAddr);
 }
 
 void Vmm::AddPageToPageDirectory(u32 vAddr, u32 pAddr, PAGE_FLAG flags, PageDirectory pd)
@@ -231,7 +304,7 @@ void Vmm::AddPageToPageDirectory(u32 vAddr, u32 pAddr, PAGE_FLAG flags, PageDire
         pt = (u32 *)new_page.vAddr;
 
         SetPageDirectoryEntry((PageDirectoryEntry *)pde, (u32)new_page.pAddr, PAGE_PRESENT | PAGE_WRITEABLE | flags);
-        asm("invlpg %0"::"m"(pde));
+        InvalidatePage((u32)pde);
 
         // TODO : Is it necessary ?
         CleanPageTable((PageTableEntry *)pt);
@@ -243,8 +316,8 @@ void Vmm::AddPageToPageDirectory(u32 vAddr, u32 pAddr, PAGE_FLAG flags, PageDire
     pte = (u32 *)(0xFFC00000 | ((vAddr & 0xFFFFF000) >> 10));
 
     SetPageTableEntry((PageTableEntry *)pte, pAddr, flags);
-    asm("invlpg %0"::"m"(pte));
-    asm("invlpg %0"::"m"(vAddr));
+    InvalidatePage((u32)pte);
+    InvalidatePage((u32)vAddr);
 }
 
 PageTableEntry Vmm::GetPageTableFromVirtualAddress(u32 vAddr) const
@@ -260,6 +333,14 @@ PageTableEntry Vmm::GetPageTableFromVirtualAddress(u32 vAddr) const
         gKernel.Panic();
     }
 
+    if (FlagOn(*pde, PAGE_SIZE_4MO))
+    {
+        PageTableEntry largePageEntry;
+
+        GetLargePageTableEntry(*(PageDirectoryEntry *)pde, vAddr, &largePageEntry);
+        return largePageEntry;
+    }
+
     // We do the same with the page table entry
     pte = (u32 *)(0xFFC00000 | ((vAddr & 0xFFFFF000) >> 10));
     return *((PageTableEntry *)pte);
@@ -278,12 +359,422 @@ void Vmm::SetPageTableFromVirtualAddress(u32 vAddr, const PageTableEntry & pageT
         gKernel.Panic();
     }
 
+    if (FlagOn(*pde, PAGE_SIZE_4MO))
+    {
+        KLOG(LOG_ERROR, "%p is mapped by a large page", vAddr);
+        gKernel.Panic();
+    }
+
     // We do the same with the page table entry
     pte = (u32 *)(0xFFC00000 | ((vAddr & 0xFFFFF000) >> 10));
     *((PageTableEntry *)pte) = pageTableEntry;
 
-    asm("invlpg %0"::"m"(pte));
-    asm("invlpg %0"::"m"(vAddr));
+    InvalidatePage((u32)pte);
+    InvalidatePage((u32)vAddr);
+}
+
+KeStatus Vmm::MapPageInDirectory(const PageDirectory & pd, u32 vAddr, u32 pAddr, PAGE_FLAG flags, u8 avail)
+{
+    KeStatus status = STATUS_FAILURE;
+    PageTableEntry * pte = nullptr;
+
+    status = _AcquirePageTableEntry(pd, vAddr, true, &pte);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "_AcquirePageTableEntry() failed with code %t", status);
+        return status;
+    }
+
+    _CountResidentPages(pd, vAddr, pte->present, FlagOn(flags, PAGE_PRESENT), 1);
+
+    SetPageTableEntryEx(pte, pAddr, flags, 0, avail);
+
+    _ReleasePageTableEntry(pte, vAddr);
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus Vmm::GetPageTableEntryInDirectory(const PageDirectory & pd, u32 vAddr, PageTableEntry * const pageTableEntry)
+{
+    KeStatus status = STATUS_FAILURE;
+    PageTableEntry * pte = nullptr;
+
+    if (pageTableEntry == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid pageTableEntry parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = _AcquirePageTableEntry(pd, vAddr, false, &pte);
+    if (status == STATUS_NOT_FOUND)
+    {
+        SetPageTableEntry(pageTableEntry, 0, PAGE_EMPTY);
+        return STATUS_SUCCESS;
+    }
+
+    if (status == STATUS_NOT_SUPPORTED)
+    {
+        PageDirectoryEntry pde = { 0 };
+
+        status = GetPageDirectoryEntryInDirectory(pd, vAddr, &pde);
+        if (FAILED(status))
+            return status;
+
+        GetLargePageTableEntry(pde, vAddr, pageTableEntry);
+        return STATUS_SUCCESS;
+    }
+
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "_AcquirePageTableEntry() failed with code %t", status);
+        return status;
+    }
+
+    *pageTableEntry = *pte;
+
+    _ReleasePageTableEntry(pte, vAddr);
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus Vmm::SetPageTableEntryInDirectory(const PageDirectory & pd, u32 vAddr, const PageTableEntry & pageTableEntry)
+{
+    KeStatus status = STATUS_FAILURE;
+    PageTableEntry * pte = nullptr;
+
+    status = _AcquirePageTableEntry(pd, vAddr, false, &pte);
+    if (FAILED(status))
+        return status;
+
+    _CountResidentPages(pd, vAddr, pte->present, pageTableEntry.present, 1);
+
+    *pte = pageTableEntry;
+
+    _ReleasePageTableEntry(pte, vAddr);
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus Vmm::_AcquirePageTableEntry(const PageDirectory & pd, u32 vAddr, bool create, PageTableEntry ** const outPageTableEntry)
+{
+    const bool current = (pd.pdEntry == GetCurrentPageDirectory());
+    PageDirectoryEntry * pde = nullptr;
+    PageDirectoryEntry * pdMapping = nullptr;
+    PageTableEntry * ptMapping = nullptr;
+    u32 ptAddr = 0;
+
+    if (current)
+    {
+        pde = (PageDirectoryEntry *)(0xFFFFF000 | PD_OFFSET(vAddr));
+    }
+    else
+    {
+        pdMapping = (PageDirectoryEntry *)gKMap.Map((u32)pd.pdEntry);
+        if (pdMapping == nullptr)
+            return STATUS_ALLOC_FAILED;
+
+        pde = &pdMapping[vAddr >> 22];
+    }
+
+    if (!pde->present)
+    {
+        Page newPage = { 0 };
+
+        if (!create)
+        {
+            if (pdMapping != nullptr)
+                gKMap.Unmap(pdMapping);
+
+            return STATUS_NOT_FOUND;
+        }
+
+        // The new page table is cleaned through its page pool mapping, before being reachable from the directory
+        newPage = PageAlloc();
+        if (newPage.vAddr == 0)
+        {
+            KLOG(LOG_ERROR, "PageAlloc() failed");
+
+            if (pdMapping != nullptr)
+                gKMap.Unmap(pdMapping);
+
+            return STATUS_ALLOC_FAILED;
+        }
+
+        CleanPageTable((PageTableEntry *)newPage.vAddr);
+
+        SetPageDirectoryEntry(pde, newPage.pAddr, PAGE_PRESENT | PAGE_WRITEABLE | PAGE_NON_PRIVILEGED_ACCESS);
+
+        if (pd.counters != nullptr && vAddr >= V_USER_BASE_ADDR)
+            pd.counters->pageTablePages++;
+
+        if (current)
+            InvalidatePage(0xFFC00000 | ((vAddr & 0xFFC00000) >> 10));
+    }
+    else if (pde->pageSize)
+    {
+        if (pdMapping != nullptr)
+            gKMap.Unmap(pdMapping);
+
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    ptAddr = pde->pageTableAddr << 12;
+
+    if (current)
+    {
+        *outPageTableEntry = (PageTableEntry *)(0xFFC00000 | ((vAddr & 0xFFFFF000) >> 10));
+        return STATUS_SUCCESS;
+    }
+
+    gKMap.Unmap(pdMapping);
+
+    ptMapping = (PageTableEntry *)gKMap.Map(ptAddr);
+    if (ptMapping == nullptr)
+        return STATUS_ALLOC_FAILED;
+
+    *outPageTableEntry = &ptMapping[PT_OFFSET(vAddr)];
+
+    return STATUS_SUCCESS;
+}
+
+void Vmm::_ReleasePageTableEntry(PageTableEntry * const pageTableEntry, u32 vAddr)
+{
+    // The entry of another directory was reached through the kernel map window, its address space isn't in the TLB
+    if (gKMap.Contains(pageTableEntry))
+    {
+        gKMap.Unmap(pageTableEntry);
+        return;
+    }
+
+    InvalidatePage(vAddr);
+}
+
+KeStatus Vmm::MapLargePageInDirectory(const PageDirectory & pd, u32 vAddr, u32 pAddr, PAGE_FLAG flags)
+{
+    KeStatus status = STATUS_FAILURE;
+    PageDirectoryEntry * pde = nullptr;
+    u32 ptAddr = 0;
+
+    if (!_largePagesEnabled)
+        return STATUS_NOT_SUPPORTED;
+
+    if ((vAddr & (LARGE_PAGE_SIZE - 1)) != 0 || (pAddr & (LARGE_PAGE_SIZE - 1)) != 0)
+    {
+        KLOG(LOG_ERROR, "%x or %x is not 4Mo aligned", vAddr, pAddr);
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    status = _AcquirePageDirectoryEntry(pd, vAddr, &pde);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "_AcquirePageDirectoryEntry() failed with code %t", status);
+        return status;
+    }
+
+    status = _CheckReplacedPageTable(vAddr, *pde, FlagOn(flags, PAGE_PRESENT), &ptAddr);
+    if (FAILED(status))
+    {
+        _ReleasePageDirectoryEntry(pde, vAddr);
+        return status;
+    }
+
+    _CountLargePageDirectoryEntry(pd, vAddr, *pde, FlagOn(flags, PAGE_PRESENT));
+
+    SetPageDirectoryEntry(pde, pAddr, flags | PAGE_SIZE_4MO);
+
+    _ReleasePageDirectoryEntry(pde, vAddr);
+
+    if (ptAddr != 0)
+        PageFreeFromPhysicalAddress(ptAddr);
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus Vmm::MapKernelLargePage(u32 vAddr, u32 * const pAddr)
+{
+    KeStatus status = STATUS_FAILURE;
+    void * largePage = nullptr;
+
+    if (!_largePagesEnabled)
+        return STATUS_NOT_SUPPORTED;
+
+    if (vAddr >= V_USER_BASE_ADDR)
+    {
+        KLOG(LOG_ERROR, "%p is not in kernel space !", vAddr);
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    largePage = gPmm.GetFreeLargePage();
+    if (largePage == nullptr)
+    {
+        KLOG(LOG_WARNING, "Pmm::GetFreeLargePage() failed to find an available large page");
+        return STATUS_PHYSICAL_MEMORY_FULL;
+    }
+
+    status = MapLargePageInDirectory(gKernel.info.pPageDirectory, vAddr, (u32)largePage, PAGE_PRESENT | PAGE_WRITEABLE);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "MapLargePageInDirectory() failed with code %t", status);
+        gPmm.ReleaseLargePage(largePage);
+        return status;
+    }
+
+    if (pAddr != nullptr)
+        *pAddr = (u32)largePage;
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus Vmm::GetPageDirectoryEntryInDirectory(const PageDirectory & pd, u32 vAddr, PageDirectoryEntry * const pageDirectoryEntry)
+{
+    KeStatus status = STATUS_FAILURE;
+    PageDirectoryEntry * pde = nullptr;
+
+    if (pageDirectoryEntry == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid pageDirectoryEntry parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = _AcquirePageDirectoryEntry(pd, vAddr, &pde);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "_AcquirePageDirectoryEntry() failed with code %t", status);
+        return status;
+    }
+
+    *pageDirectoryEntry = *pde;
+
+    _ReleasePageDirectoryEntry(pde, vAddr);
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus Vmm::SetPageDirectoryEntryInDirectory(const PageDirectory & pd, u32 vAddr, const PageDirectoryEntry & pageDirectoryEntry)
+{
+    KeStatus status = STATUS_FAILURE;
+    PageDirectoryEntry * pde = nullptr;
+    const bool largePresent = pageDirectoryEntry.present && pageDirectoryEntry.pageSize;
+    u32 ptAddr = 0;
+
+    status = _AcquirePageDirectoryEntry(pd, vAddr, &pde);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "_AcquirePageDirectoryEntry() failed with code %t", status);
+        return status;
+    }
+
+    status = _CheckReplacedPageTable(vAddr, *pde, largePresent, &ptAddr);
+    if (FAILED(status))
+    {
+        _ReleasePageDirectoryEntry(pde, vAddr);
+        return status;
+    }
+
+    _CountLargePageDirectoryEntry(pd, vAddr, *pde, largePresent);
+
+    *pde = pageDirectoryEntry;
+
+    _ReleasePageDirectoryEntry(pde, vAddr);
+
+    if (ptAddr != 0)
+        PageFreeFromPhysicalAddress(ptAddr);
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus Vmm::_AcquirePageDirectoryEntry(const PageDirectory & pd, u32 vAddr, PageDirectoryEntry ** const outPageDirectoryEntry)
+{
+    PageDirectoryEntry * pdMapping = nullptr;
+
+    if (pd.pdEntry == GetCurrentPageDirectory())
+    {
+        *outPageDirectoryEntry = (PageDirectoryEntry *)(0xFFFFF000 | PD_OFFSET(vAddr));
+        return STATUS_SUCCESS;
+    }
+
+    pdMapping = (PageDirectoryEntry *)gKMap.Map((u32)pd.pdEntry);
+    if (pdMapping == nullptr)
+        return STATUS_ALLOC_FAILED;
+
+    *outPageDirectoryEntry = &pdMapping[vAddr >> 22];
+
+    return STATUS_SUCCESS;
+}
+
+void Vmm::_ReleasePageDirectoryEntry(PageDirectoryEntry * const pageDirectoryEntry, u32 vAddr)
+{
+    if (gKMap.Contains(pageDirectoryEntry))
+    {
+        gKMap.Unmap(pageDirectoryEntry);
+        return;
+    }
+
+    // A single invalidation flushes a 4Mo page, the recursive mapping of its page table may be cached too
+    InvalidatePage(vAddr & 0xFFC00000);
+    InvalidatePage(0xFFC00000 | ((vAddr & 0xFFC00000) >> 10));
+}
+
+void Vmm::_CountResidentPages(const PageDirectory & pd, u32 vAddr, bool wasPresent, bool present, u32 nbPages)
+{
+    MemoryCounters * counters = pd.counters;
+
+    if (counters == nullptr || vAddr < V_USER_BASE_ADDR || wasPresent == present)
+        return;
+
+    if (!present)
+    {
+        counters->residentPages -= nbPages;
+        return;
+    }
+
+    counters->residentPages += nbPages;
+
+    if (counters->residentPages > counters->peakResidentPages)
+        counters->peakResidentPages = counters->residentPages;
+}
+
+void Vmm::_CountLargePageDirectoryEntry(const PageDirectory & pd, u32 vAddr, const PageDirectoryEntry & oldEntry, bool largePresent)
+{
+    const bool wasLarge = oldEntry.present && oldEntry.pageSize;
+
+    // A page table replaced by a large page isn't used by the address space anymore
+    if (pd.counters != nullptr && vAddr >= V_USER_BASE_ADDR && oldEntry.present && !oldEntry.pageSize && largePresent)
+        pd.counters->pageTablePages--;
+
+    _CountResidentPages(pd, vAddr, wasLarge, largePresent, LARGE_PAGE_SIZE / PAGE_SIZE);
+}
+
+KeStatus Vmm::_CheckReplacedPageTable(u32 vAddr, const PageDirectoryEntry & oldEntry, bool largePresent, u32 * const ptAddr)
+{
+    PageTableEntry * pageTable = nullptr;
+    bool empty = true;
+
+    *ptAddr = 0;
+
+    // The kernel page tables are shared by every directory, they are never replaced
+    if (vAddr < V_USER_BASE_ADDR || !oldEntry.present || oldEntry.pageSize || !largePresent)
+        return STATUS_SUCCESS;
+
+    pageTable = (PageTableEntry *)gKMap.Map(oldEntry.pageTableAddr << 12);
+    if (pageTable == nullptr)
+        return STATUS_ALLOC_FAILED;
+
+    for (unsigned int index = 0; index < NB_PAGES_PER_TABLE && empty; index++)
+        empty = !pageTable[index].present;
+
+    gKMap.Unmap(pageTable);
+
+    // The pages still mapped by the table would be lost with it
+    if (!empty)
+    {
+        KLOG(LOG_ERROR, "The page table of %x still maps pages, it can't be replaced by a large page", vAddr);
+        return STATUS_UNEXPECTED;
+    }
+
+    *ptAddr = oldEntry.pageTableAddr << 12;
+
+    return STATUS_SUCCESS;
 }
 
 bool Vmm::IsVirtualAddressAvailable(u32 vAddr)
@@ -298,6 +789,11 @@ bool Vmm::IsVirtualAddressAvailable(u32 vAddr)
         return FALSE;
     }
 
+    if (FlagOn(*pde, PAGE_SIZE_4MO))
+    {
+        return TRUE;
+    }
+
     // We do the same with the page table entry
     pte = (u32 *)(0xFFC00000 | ((vAddr & 0xFFFFF000) >> 10));
     if (!FlagOn(*pte, PAGE_PRESENT))
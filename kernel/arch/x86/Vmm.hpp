@@ -5,6 +5,7 @@
 #include "MemCommon.hpp"
 
 #include <kernel/lib/Types.hpp>
+#include <kernel/lib/Status.hpp>
 #include <kernel/lib/List.hpp>
 
 /// @addgroup ArchX86Group
@@ -19,9 +20,10 @@
 
     Kernel virtual address space organisation
 
-           0x0 - 0x800000    Identity mapping
-      0x800000 - 0x1000000   Page Heap
-     0x1000000 - 0x40000000  Heap
+           0x0 - 0x800000    Identity mapping (two 4Mo pages when PSE is supported)
+      0x800000 - 0x1000000   Page Heap (its first 4Mo are a large page when PSE is supported)
+     0x1000000 - 0x3FC00000  Heap (its first 4Mo are a large page when PSE is supported)
+    0x3FC00000 - 0x3FC20000  Kernel map window (KMap.hpp)
     0x40000000 - 0x100000000 User space
 
 */
@@ -50,6 +52,9 @@ typedef u32 PAGE_FLAG;
 #define PAGE_WRITTEN               64
 #define PAGE_G                     256
 
+/// @brief Value of the avail field of a page table entry, used to mark a read-only page as copy-on-write
+#define PAGE_AVAIL_COPY_ON_WRITE   1
+
 /// @brief Describes a page directory entry
 struct PageDirectoryEntry
 {
@@ -82,6 +87,24 @@ struct PageTableEntry
     u32 pageAddr : 20;
 };
 
+/// @brief Memory used by a user address space. The Vmm counts the pages and page tables as they are mapped,
+///        the vads count the bytes they reserve and check the limits before reserving them.
+struct MemoryCounters
+{
+    /// @brief Number of present user pages, a large page counts as the 4Ko pages it covers
+    u32 residentPages;
+    /// @brief Highest residentPages value
+    u32 peakResidentPages;
+    /// @brief Bytes of the reserved vads, committed or not
+    u32 committedBytes;
+    /// @brief Number of page tables allocated for the user space
+    u32 pageTablePages;
+    /// @brief Maximum residentPages value, 0 if unlimited
+    u32 residentPagesLimit;
+    /// @brief Maximum committedBytes value, 0 if unlimited
+    u32 committedBytesLimit;
+};
+
 /// @brief Describes a page directory
 struct PageDirectory
 {
@@ -89,6 +112,8 @@ struct PageDirectory
     PageDirectoryEntry * pdEntry;
     /// @brief Used to save the list of allocated pages on the page pool (used for storing page tables or directories, ...)
     List * pagesList;
+    /// @brief Counters of the address space, nullptr if it is not accounted (kernel page directory)
+    MemoryCounters * counters;
 };
 
 /// @brief Describes a page, couple of physical and virtual address
@@ -105,9 +130,13 @@ public:
     /// @brief Vmm default class constructor, do nothing special
     Vmm();
 
-    /// @brief Initializes the Virtual Memory Manager
+    /// @brief Initializes the Virtual Memory Manager, large pages are enabled if the processor supports PSE
     void Init();
 
+    /// @brief Indicates if 4Mo pages can be mapped (the processor supports PSE)
+    /// @return true if large pages are enabled, else false
+    bool AreLargePagesEnabled() const;
+
     /// @brief Cleans a page directory by calling SetPageDirectoryEntry with PAGE_EMPTY on each entry.
     /// @param[in] pageDirectoryEntry A pointer to a page directory entry structure
     void CleanPageDirectory(PageDirectoryEntry * pageDirectoryEntry);
@@ -173,6 +202,62 @@ public:
     /// @param[in] pageTableEntry The new page table entry
     void SetPageTableFromVirtualAddress(u32 vAddr, const PageTableEntry & pageTableEntry);
 
+    /// @brief Maps a physical page in a page directory that doesn't have to be the current one.
+    ///        The current directory is edited through the recursive mapping, another one through the kernel map window (KMap.hpp) : cr3 is never reloaded.
+    ///        The page table is created if needed.
+    /// @param[in] pd The page directory that must be modified
+    /// @param[in] vAddr A 32bits virtual address in user space
+    /// @param[in] pAddr A physicial address of the page we want to map
+    /// @param[in] flags Page's flags
+    /// @param[in] avail A value for the avail page table entry field
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus MapPageInDirectory(const PageDirectory & pd, u32 vAddr, u32 pAddr, PAGE_FLAG flags, u8 avail = 0);
+
+    /// @brief Retrieves a page table entry of a page directory that doesn't have to be the current one, without reloading cr3
+    /// @param[in]  pd The page directory
+    /// @param[in]  vAddr A 32bits virtual address in user space
+    /// @param[out] pageTableEntry Will hold a copy of the entry, an empty entry if there is no page table for this address
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus GetPageTableEntryInDirectory(const PageDirectory & pd, u32 vAddr, PageTableEntry * const pageTableEntry);
+
+    /// @brief Updates a page table entry of a page directory that doesn't have to be the current one, without reloading cr3
+    /// @param[in] pd The page directory that must be modified
+    /// @param[in] vAddr A 32bits virtual address in user space, its page table must exist
+    /// @param[in] pageTableEntry The new page table entry
+    /// @return STATUS_SUCCESS on success, STATUS_NOT_FOUND if there is no page table for this address, an error code otherwise
+    KeStatus SetPageTableEntryInDirectory(const PageDirectory & pd, u32 vAddr, const PageTableEntry & pageTableEntry);
+
+    /// @brief Maps a 4Mo physical page with a single entry of a page directory that doesn't have to be the current one, without reloading cr3.
+    ///        No 4Ko page of the area may still be mapped, a page table previously used by this entry is not released.
+    /// @param[in] pd The page directory that must be modified
+    /// @param[in] vAddr A 4Mo aligned 32bits virtual address
+    /// @param[in] pAddr A 4Mo aligned physical address
+    /// @param[in] flags Page's flags, PAGE_SIZE_4MO is added
+    /// @return STATUS_SUCCESS on success, STATUS_NOT_SUPPORTED if large pages are not enabled, an error code otherwise
+    KeStatus MapLargePageInDirectory(const PageDirectory & pd, u32 vAddr, u32 pAddr, PAGE_FLAG flags);
+
+    /// @brief Maps a 4Mo area of the kernel address space with a large page taken from the Pmm
+    /// @warning The kernel page directory entries are copied in each process page directory when it is created,
+    ///          so this must be called before the first process creation
+    /// @param[in]  vAddr A 4Mo aligned 32bits virtual address in kernel space
+    /// @param[out] pAddr Will hold the physical address of the large page, may be nullptr
+    /// @return STATUS_SUCCESS on success, STATUS_NOT_SUPPORTED if large pages are not enabled, an error code otherwise
+    KeStatus MapKernelLargePage(u32 vAddr, u32 * const pAddr);
+
+    /// @brief Retrieves a page directory entry of a page directory that doesn't have to be the current one, without reloading cr3
+    /// @param[in]  pd The page directory
+    /// @param[in]  vAddr A 32bits virtual address
+    /// @param[out] pageDirectoryEntry Will hold a copy of the entry
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus GetPageDirectoryEntryInDirectory(const PageDirectory & pd, u32 vAddr, PageDirectoryEntry * const pageDirectoryEntry);
+
+    /// @brief Updates a page directory entry of a page directory that doesn't have to be the current one, without reloading cr3
+    /// @param[in] pd The page directory that must be modified
+    /// @param[in] vAddr A 32bits virtual address
+    /// @param[in] pageDirectoryEntry The new page directory entry
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus SetPageDirectoryEntryInDirectory(const PageDirectory & pd, u32 vAddr, const PageDirectoryEntry & pageDirectoryEntry);
+
     /// @brief Indicates if a given virtual address is available (the page directory AND the page table entry must have the bit PAGE_PRESENT)
     /// @param[in] vAddr A 32bits virtual address
     /// @return true if available, else false
@@ -201,12 +286,61 @@ public:
 private:
     PageDirectoryEntry * s_SavedPageDirectoryEntry;
 
+    /// @brief True if the processor supports PSE, page directory entries may then map 4Mo pages
+    bool _largePagesEnabled;
+
     /// @brief Initializes the kernel page directory
     ///        The kernel page directory entries must be PAGE_PRESENT and WRITEABLE
     ///        Same as for each page table of these entries
     void InitKernelPageDirectoryAndPageTables();
 
-    /// @brief Indentity mapping for the kernel (v_addr == p_addr from 0x0 to 0x800000)
+    /// @brief Retrieves a pointer to the page table entry of a virtual address in a page directory.
+    ///        It goes through the recursive mapping if the directory is the current one, else its page table is mapped in the kernel map window.
+    ///        The pointer must be given back to _ReleasePageTableEntry().
+    /// @param[in]  pd The page directory
+    /// @param[in]  vAddr A 32bits virtual address in user space
+    /// @param[in]  create Boolean telling if the page table must be created if it doesn't exist
+    /// @param[out] outPageTableEntry Pointer that will hold the page table entry pointer
+    /// @return STATUS_SUCCESS on success, STATUS_NOT_FOUND if there is no page table and create is false,
+    ///         STATUS_NOT_SUPPORTED if the address is mapped by a large page, an error code otherwise
+    KeStatus _AcquirePageTableEntry(const PageDirectory & pd, u32 vAddr, bool create, PageTableEntry ** const outPageTableEntry);
+
+    /// @brief Gives back a page table entry pointer retrieved with _AcquirePageTableEntry(), once it has been modified or read.
+    ///        The TLB entry of the virtual address is invalidated if the directory is the current one.
+    void _ReleasePageTableEntry(PageTableEntry * const pageTableEntry, u32 vAddr);
+
+    /// @brief Retrieves a pointer to the page directory entry of a virtual address, through the recursive mapping if the directory is the current one,
+    ///        else through the kernel map window. The pointer must be given back to _ReleasePageDirectoryEntry().
+    /// @param[in]  pd The page directory
+    /// @param[in]  vAddr A 32bits virtual address
+    /// @param[out] outPageDirectoryEntry Pointer that will hold the page directory entry pointer
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus _AcquirePageDirectoryEntry(const PageDirectory & pd, u32 vAddr, PageDirectoryEntry ** const outPageDirectoryEntry);
+
+    /// @brief Gives back a page directory entry pointer retrieved with _AcquirePageDirectoryEntry().
+    ///        The TLB entries of the 4Mo area and of its page table are invalidated if the directory is the current one.
+    void _ReleasePageDirectoryEntry(PageDirectoryEntry * const pageDirectoryEntry, u32 vAddr);
+
+    /// @brief Updates the resident pages of an accounted address space when an entry of a user address starts or stops mapping pages
+    /// @param[in] pd The page directory, nothing is counted if it has no counters
+    /// @param[in] vAddr The virtual address of the entry
+    /// @param[in] wasPresent Boolean telling if the entry mapped its pages before being modified
+    /// @param[in] present Boolean telling if the entry maps its pages after being modified
+    /// @param[in] nbPages The number of 4Ko pages mapped by the entry
+    void _CountResidentPages(const PageDirectory & pd, u32 vAddr, bool wasPresent, bool present, u32 nbPages);
+
+    /// @brief Updates the counters of an accounted address space when a page directory entry is replaced by a large page or cleared
+    void _CountLargePageDirectoryEntry(const PageDirectory & pd, u32 vAddr, const PageDirectoryEntry & oldEntry, bool largePresent);
+
+    /// @brief Checks the page table a user page directory entry points to before the entry is replaced by a large page
+    /// @param[in]  vAddr The virtual address of the entry
+    /// @param[in]  oldEntry The entry before being modified
+    /// @param[in]  largePresent Boolean telling if the entry maps a large page after being modified
+    /// @param[out] ptAddr Pointer that will hold the physical address of the page table to free once the entry is replaced, 0 if there is none
+    /// @return STATUS_SUCCESS on success, STATUS_UNEXPECTED if the page table still maps pages
+    KeStatus _CheckReplacedPageTable(u32 vAddr, const PageDirectoryEntry & oldEntry, bool largePresent, u32 * const ptAddr);
+
+    /// @brief Indentity mapping for the kernel (v_addr == p_addr from 0x0 to 0x800000), with two 4Mo pages if large pages are enabled
     ///        This area includes :
     ///          - GDT/IDT, 
     ///          - The Kernel page directory,
@@ -2,11 +2,56 @@
 
 %include "arch/x86/isr_utils.asm"
 
+%define USER_CODE_SELECTOR_WITH_RPL 0x1B
+%define USER_DATA_SELECTOR_WITH_RPL 0x23
+%define EFLAGS_IF                   0x200
+;;; Offset of esp0 in the tss structure
+%define TSS_ESP0_OFFSET             4
+
 extern syscall_isr
+extern sysenter_isr
+extern gTss
 
 global _asm_syscall_isr
+global _asm_sysenter_isr
 
 _asm_syscall_isr:
 	INT_PROLOG
 	call syscall_isr
-	INT_EPILOG
\ No newline at end of file
+	INT_EPILOG
+
+;;; Fast system call entry, the processor jumps here on sysenter with interrupts disabled and esp
+;;; loaded from IA32_SYSENTER_ESP. The user stub passes its stack pointer in ebp, the other registers
+;;; hold the syscall id and parameters as with the syscall interrupt.
+;;; The same context as the syscall interrupt is built on the thread kernel stack, so the syscalls
+;;; handlers don't know which entry was used. sysenter_isr() fills the user eip and esp.
+_asm_sysenter_isr:
+	; ds still holds the user selector, the tss is read through ss loaded by sysenter
+	mov esp, [ss:gTss + TSS_ESP0_OFFSET]
+
+	push dword USER_DATA_SELECTOR_WITH_RPL ; ss
+	push ebp                               ; esp
+	pushfd                                 ; eflags, the syscall gate doesn't disable interrupts
+	or dword [esp], EFLAGS_IF
+	push dword USER_CODE_SELECTOR_WITH_RPL ; cs
+	push dword 0                           ; eip
+
+	SAVE_REGS
+	; The user selectors are saved in the context, the C code runs with the kernel ones
+	mov ax, 0x10
+	mov ds, ax
+	mov es, ax
+	sti
+
+	call sysenter_isr
+
+	cli
+	RESTORE_REGS
+
+	; sysexit returns to edx with ecx as stack pointer, they are not given back to the user
+	mov edx, [esp]
+	mov ecx, [esp + 12]
+
+	; sti only takes effect after the next instruction, no interrupt can come before we leave
+	sti
+	sysexit
\ No newline at end of file
@@ -1,11 +1,14 @@
 [BITS 32]
 
 global _init_vmm
+global _enable_large_pages
 global _setCurrentPageDirectory
 global _getCurrentPageDirectory
 
 ;;; Put the page directory physical address in the cr3 register
 ;;; Set the pagging bit (31) in cr0 to enable pagging
+;;; Set the write protect bit (16) in cr0, so that the kernel can't write in a read-only
+;;; user page without a fault (needed by copy-on-write pages)
 _init_vmm:
 	push ebp
 	mov ebp, esp
@@ -14,12 +17,20 @@ _init_vmm:
 	mov cr3, eax
 
 	mov eax, cr0
-	or eax, 0x80000000
+	or eax, 0x80010000
 	mov cr0, eax
 	
 	leave
 	ret
 
+;;; Set the page size extension bit (4) in cr4, so that a page directory entry
+;;; with the page size bit set maps a 4Mo page
+_enable_large_pages:
+	mov eax, cr4
+	or eax, 0x10
+	mov cr4, eax
+	ret
+
 _setCurrentPageDirectory:
 	push ebp
 	mov ebp, esp
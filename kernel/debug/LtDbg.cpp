@@ -12,6 +12,7 @@
 #include <kernel/lib/StdLib.hpp>
 #include <kernel/lib/StdIo.hpp>
 #include <kernel/task/ProcessManager.hpp>
+#include <kernel/syscalls/SyscallsStats.hpp>
 #include <kernel/Kernel.hpp>
 
 #include <kernel/Logger.hpp>
@@ -222,6 +223,18 @@ void LtDbg::WaitForPacket(KeDebugContext * context)
             DKLOG(LOG_DEBUG, "Idt command");
             running = IdtCommand(&request, context, &response);
             break;
+        case CMD_SYSCALLS:
+            DKLOG(LOG_DEBUG, "Syscalls command");
+            running = SyscallsCommand(&request, context, &response);
+            break;
+        case CMD_SYSCALL_TRACE:
+            DKLOG(LOG_DEBUG, "Syscall trace command");
+            running = SyscallTraceCommand(&request, context, &response);
+            break;
+        case CMD_MEMORY_STATS:
+            DKLOG(LOG_DEBUG, "Memory stats command");
+            running = MemoryStatsCommand(&request, context, &response);
+            break;
         default:
             DKLOG(LOG_DEBUG, "Undefined debug command");
             response.header.command = request.command;
@@ -563,6 +576,98 @@ bool LtDbg::IdtCommand(KeDebugRequest * request, KeDebugContext * context, KeDeb
     response->header.dataSize = idtSize;
     response->data = (char*)descriptors;
 
+clean:
+    return false;
+}bool LtDbg::SyscallsCommand(KeDebugRequest * request, KeDebugContext * context, KeDebugResponse * response)
+{
+    const unsigned int statsSize = SYS_INVALID * sizeof(SyscallStatsEntry);
+    SyscallStatsEntry * entries = (SyscallStatsEntry*)HeapAlloc(statsSize);
+
+    response->header.command = CMD_SYSCALLS;
+    response->header.context = *context;
+
+    if (entries == nullptr)
+    {
+        KLOG(LOG_ERROR, "HeapAlloc() failed to allocate %d bytes", statsSize);
+        response->header.dataSize = 0;
+        response->header.status = DBG_STATUS_FAILURE;
+        response->data = nullptr;
+
+        goto clean;
+    }
+
+    MemCopy(gSyscallsStats.GetEntriesUnsafe(), entries, statsSize);
+
+    response->header.status = DBG_STATUS_SUCCESS;
+    response->header.dataSize = statsSize;
+    response->data = (char*)entries;
+
+clean:
+    return false;
+}
+
+bool LtDbg::SyscallTraceCommand(KeDebugRequest * request, KeDebugContext * context, KeDebugResponse * response)
+{
+    Process * currentProcess = gProcessManager.GetCurrentProcess();
+    SyscallTrace * trace = nullptr;
+    SyscallTraceRecord * records = nullptr;
+
+    response->header.command = CMD_SYSCALL_TRACE;
+    response->header.context = *context;
+    response->header.dataSize = 0;
+    response->data = nullptr;
+
+    // The records are only copied, the process still reads them afterwards
+    trace = (currentProcess != nullptr) ? currentProcess->syscallTrace : nullptr;
+    if (trace == nullptr)
+    {
+        response->header.status = DBG_STATUS_FAILURE;
+        goto clean;
+    }
+
+    if (trace->nbRecords > 0)
+    {
+        records = (SyscallTraceRecord*)HeapAlloc(trace->nbRecords * sizeof(SyscallTraceRecord));
+        if (records == nullptr)
+        {
+            KLOG(LOG_ERROR, "HeapAlloc() failed to allocate %d bytes", trace->nbRecords * sizeof(SyscallTraceRecord));
+            response->header.status = DBG_STATUS_FAILURE;
+            goto clean;
+        }
+
+        for (unsigned int index = 0; index < trace->nbRecords; index++)
+            records[index] = trace->records[(trace->first + index) % SYSCALL_TRACE_ENTRIES];
+    }
+
+    response->header.status = DBG_STATUS_SUCCESS;
+    response->header.dataSize = trace->nbRecords * sizeof(SyscallTraceRecord);
+    response->data = (char*)records;
+
+clean:
+    return false;
+}bool LtDbg::MemoryStatsCommand(KeDebugRequest * request, KeDebugContext * context, KeDebugResponse * response)
+{
+    KeStatus status = STATUS_FAILURE;
+    ProcessMemoryStats * stats = nullptr;
+    unsigned int nbProcesses = 0;
+
+    response->header.command = CMD_MEMORY_STATS;
+    response->header.context = *context;
+    response->header.dataSize = 0;
+    response->data = nullptr;
+
+    status = gProcessManager.GetAllProcessesMemoryStats(&stats, &nbProcesses);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "ProcessManager::GetAllProcessesMemoryStats() failed with code %t", status);
+        response->header.status = DBG_STATUS_FAILURE;
+        goto clean;
+    }
+
+    response->header.status = DBG_STATUS_SUCCESS;
+    response->header.dataSize = nbProcesses * sizeof(ProcessMemoryStats);
+    response->data = (char*)stats;
+
 clean:
     return false;
 }
\ No newline at end of file
@@ -68,6 +68,9 @@ private:
     bool StackTraceCommand(KeDebugRequest * request, KeDebugContext * context, KeDebugResponse * response);
     bool MemoryCommand(KeDebugRequest * request, KeDebugContext * context, KeDebugResponse * response);
     bool IdtCommand(KeDebugRequest * request, KeDebugContext * context, KeDebugResponse * response);
+    bool SyscallsCommand(KeDebugRequest * request, KeDebugContext * context, KeDebugResponse * response);
+    bool SyscallTraceCommand(KeDebugRequest * request, KeDebugContext * context, KeDebugResponse * response);
+    bool MemoryStatsCommand(KeDebugRequest * request, KeDebugContext * context, KeDebugResponse * response);
 
 };
 
@@ -17,6 +17,9 @@
 	COMMAND(CMD_BP,          "bp")        \
 	COMMAND(CMD_BL,          "bl")        \
     COMMAND(CMD_IDT,         "idt")       \
+    COMMAND(CMD_SYSCALLS,    "sc")        \
+    COMMAND(CMD_SYSCALL_TRACE, "st")      \
+    COMMAND(CMD_MEMORY_STATS, "ms")       \
 	COMMAND(CMD_UNKNOWN,     "<unknown>") \
 	COMMAND(CMD_END,         "<end>" )    \
 
@@ -6,6 +6,7 @@
 #include <kernel/lib/StdIo.hpp>
 #include <kernel/drivers/proc_io.hpp>
 #include <kernel/task/Scheduler.hpp>
+#include <kernel/task/SharedData.hpp>
 
 /// @addgroup DriversGroup
 /// @{
@@ -37,6 +38,8 @@ extern "C" void clock_isr(InterruptContext * context)
 #endif
     }
 
+    gSharedData.UpdateClock(gClockDrv.secs, gClockDrv.tics * 1000 / TICKS_PER_SECOND);
+
     gScheduler.Schedules(context);
 }
 
@@ -153,6 +153,45 @@ extern "C"
         return data;
     }
 
+    bool ListRemove(List ** list, void * data)
+    {
+        if (list == nullptr || (*list) == nullptr)
+        {
+            KLOG(LOG_ERROR, "Invalid list parameter");
+            return false;
+        }
+
+        for (ListElem * elem = *list; elem != nullptr; elem = elem->next)
+        {
+            if (elem->data != data)
+                continue;
+
+            // The head element is the list itself, it only becomes empty when it is the last one
+            if (elem == *list)
+            {
+                if (elem->next == nullptr)
+                {
+                    elem->data = nullptr;
+                    return true;
+                }
+
+                *list = elem->next;
+                (*list)->prev = nullptr;
+            }
+            else
+            {
+                elem->prev->next = elem->next;
+                if (elem->next != nullptr)
+                    elem->next->prev = elem->prev;
+            }
+
+            HeapFree(elem);
+            return true;
+        }
+
+        return false;
+    }
+
     KeStatus ListEnumerate(List * list, EnumerateFunPtr callback, void * Context)
     {
         KeStatus status = STATUS_FAILURE;
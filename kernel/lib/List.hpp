@@ -27,6 +27,7 @@ extern "C"
     void * ListGet(List * list, unsigned int index);
     void * ListTop(List * list);
     void * ListPop(List ** list);
+    bool ListRemove(List ** list, void * data);
     KeStatus ListEnumerate(List * list, EnumerateFunPtr callback, void * Context);
     bool ListIsEmpty(List* list);
 
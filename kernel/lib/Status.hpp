@@ -25,6 +25,12 @@
     STATUS_ELEM (STATUS_HANDLE_ALREADY_EXIST)         \
     STATUS_ELEM (STATUS_LIST_STOP_ITERATING)          \
     STATUS_ELEM (STATUS_UNEXPECTED)                   \
+    STATUS_ELEM (STATUS_ACCESS_DENIED)                \
+    STATUS_ELEM (IPC_STATUS_BUFFER_TOO_SMALL)         \
+    STATUS_ELEM (IPC_STATUS_MESSAGE_TOO_BIG)          \
+    STATUS_ELEM (STATUS_NOT_SUPPORTED)                \
+    STATUS_ELEM (STATUS_STACK_OVERFLOW)               \
+    STATUS_ELEM (STATUS_PROCESS_MEMORY_LIMIT_REACHED) \
 
 enum KeStatus
 {
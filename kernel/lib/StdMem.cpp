@@ -21,13 +21,21 @@ void PageFree(const Page page)
     gPagePool.Free(page);
 }
 
+void PageFreeFromPhysicalAddress(const u32 pAddr)
+{
+    gPagePool.FreeFromPhysicalAddress(pAddr);
+}
+
 void MemCopy(const void * const src, void * dst, unsigned int size)
 {
     u8 * _dst = (u8 *)dst;
     u8 * _src = (u8 *)src;
+    unsigned int nbDwords = size >> 2;
+    unsigned int nbBytes = size & 3;
 
-    while ((size--) > 0)
-        *(_dst++) = *(_src++);
+    // Copies 4 bytes at a time, then the remaining bytes
+    asm volatile("cld\n\trep movsl" : "+S"(_src), "+D"(_dst), "+c"(nbDwords) : : "memory");
+    asm volatile("rep movsb" : "+S"(_src), "+D"(_dst), "+c"(nbBytes) : : "memory");
 }
 
 void MemSet(void * src, u8 byte, unsigned int size)
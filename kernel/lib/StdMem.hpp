@@ -26,6 +26,10 @@ Page PageAlloc();
 /// @param[in] ptr The page to be freed
 void PageFree(const Page page);
 
+/// @brief Releases a page allocated from the page pool, using its physical address
+/// @param[in] pAddr The page physical address
+void PageFreeFromPhysicalAddress(const u32 pAddr);
+
 /// @brief Copies memory from a source to a destination
 /// @param[in] src A pointer to the source
 /// @param[in] dst A pointer to the destination
@@ -25,17 +25,19 @@ _mod:
 _acquire_lock:
 	push ebp
 	mov ebp, esp
+	push ebx
 
 	mov ebx, [ebp+8]
-	mov eax, 0
 	mov ecx, 1
 
 .spin_wait:
+	;; On failure, cmpxchg loads the current lock value in eax, it must be reset before retrying
+	mov eax, 0
 	lock cmpxchg [ebx], ecx
 
-	cmp dword eax, 1
-	je .spin_wait
+	jne .spin_wait
 
+	pop ebx
 	leave
 	ret
 
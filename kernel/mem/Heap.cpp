@@ -38,6 +38,16 @@ void Heap::Init()
     baseBlock = (MemBlock *)gKernel.info.vHeapBase;
     limitBlock = (MemBlock *)gKernel.info.vHeapLimit;
     lastBlock = baseBlock;
+    largePagesLimit = gKernel.info.vHeapBase;
+
+    // Must be done before the first process creation, its page directory gets a copy of the heap page directory entries
+    for (unsigned int i = 0; i < HEAP_NB_LARGE_PAGES && gVmm.AreLargePagesEnabled(); i++)
+    {
+        if (FAILED(gVmm.MapKernelLargePage(largePagesLimit, nullptr)))
+            break;
+
+        largePagesLimit += LARGE_PAGE_SIZE;
+    }
 
     Sbrk(1);
 }
@@ -65,6 +75,12 @@ MemBlock * Heap::Sbrk(int n)
 
         for (; i < n; i++)
         {
+            if (heap < largePagesLimit)
+            {
+                heap += (u32)PAGE_SIZE;
+                continue;
+            }
+
             void * new_page = gPmm.GetFreePage();
 
             if (new_page == nullptr)
@@ -22,6 +22,9 @@
 /// @brief Indicates that a block if used
 #define BLOCK_USED 1
 
+/// @brief Number of 4Mo pages mapped at the beginning of the heap when large pages are enabled
+#define HEAP_NB_LARGE_PAGES 1
+
 /// @brief Describes a block
 struct MemBlock
 {
@@ -65,6 +68,8 @@ public:
     MemBlock * limitBlock;
     /// @brief Last block address
     MemBlock * lastBlock;
+    /// @brief The heap pages below this virtual address are mapped by large pages, Sbrk() doesn't have to map them
+    u32 largePagesLimit;
 
     /// @brief Used to record how many allocation did the kernel
     int allocCount;
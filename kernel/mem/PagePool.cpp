@@ -19,6 +19,13 @@ void PagePool::Init()
 {
     _base = gKernel.info.vPagePoolBase;
     _limit = gKernel.info.vPagePoolLimit;
+    _largePageLimit = _base;
+    _largePagePAddr = 0;
+
+    // Page tables and directories are mostly allocated at the beginning of the pool, they share a single TLB entry.
+    // Must be done before the first process creation, its page directory gets a copy of the pool page directory entry
+    if (gVmm.AreLargePagesEnabled() && !FAILED(gVmm.MapKernelLargePage(_base, &_largePagePAddr)))
+        _largePageLimit = _base + LARGE_PAGE_SIZE;
 
      // Creates and Initializes the list of pages
     _InitPagesList();
@@ -35,6 +42,24 @@ Page PagePool::Allocate()
     }
 
     PageBlock * newPage = _availPageList;
+    u32 pAddr = 0;
+
+    if ((u32)newPage->addr < _largePageLimit)
+    {
+        pAddr = _largePagePAddr + ((u32)newPage->addr - _base);
+    }
+    else
+    {
+        pAddr = (u32)gPmm.GetFreePage();
+        if (pAddr == 0)
+        {
+            KLOG(LOG_WARNING, "No more physical page available for the page pool !");
+            return resPage;
+        }
+
+        gVmm.AddPageToKernelPageDirectory((u32)newPage->addr, pAddr, PAGE_PRESENT | PAGE_WRITEABLE);
+    }
+
     _availPageList = newPage->next;
 
     if (_availPageList != nullptr)
@@ -48,9 +73,6 @@ Page PagePool::Allocate()
     if (headUsedPage != nullptr)
         headUsedPage->prev = newPage;
 
-    u32 pAddr = (u32)gPmm.GetFreePage();
-    gVmm.AddPageToKernelPageDirectory((u32)newPage->addr, pAddr, PAGE_PRESENT | PAGE_WRITEABLE);
-
     resPage.pAddr = pAddr;
     resPage.vAddr = (u32)newPage->addr;
 
@@ -71,17 +93,22 @@ void PagePool::Free(const Page page)
             }
             else
             {
-                usedPage->prev = usedPage->next;
-                if (usedPage->next != nullptr)
-                    usedPage->next->prev = usedPage->prev;
+                usedPage->prev->next = usedPage->next;
             }
 
-            _availPageList->prev = usedPage;
+            if (usedPage->next != nullptr)
+                usedPage->next->prev = usedPage->prev;
+
+            if (_availPageList != nullptr)
+                _availPageList->prev = usedPage;
+
+            usedPage->prev = nullptr;
             usedPage->next = _availPageList;
             _availPageList = usedPage;
             usedPage->available = true;
 
-            gPmm.ReleasePage((void *)page.pAddr);
+            if (page.vAddr >= _largePageLimit)
+                gPmm.ReleasePage((void *)page.pAddr);
 
             break;
         }
@@ -92,6 +119,23 @@ void PagePool::Free(const Page page)
     }
 }
 
+void PagePool::FreeFromPhysicalAddress(const u32 pAddr)
+{
+    for (PageBlock * usedPage = _usedPageList; usedPage != nullptr; usedPage = usedPage->next)
+    {
+        const u32 vAddr = (u32)usedPage->addr;
+        const u32 usedPAddr = (vAddr < _largePageLimit) ? _largePagePAddr + (vAddr - _base) : gVmm.GetPhysicalAddressOf(vAddr);
+
+        if (usedPAddr == pAddr)
+        {
+            Page page = { pAddr, vAddr };
+
+            Free(page);
+            return;
+        }
+    }
+}
+
 void PagePool::_InitPagesList()
 {
     const unsigned int areaSize = _limit - _base;
@@ -17,6 +17,10 @@ public:
     Page Allocate();
     void Free(const Page page);
 
+    /// @brief Frees a page of the pool known by its physical address only, as a page table referenced by a directory entry
+    /// @param[in] pAddr The page physical address, nothing is done if it isn't a used page of the pool
+    void FreeFromPhysicalAddress(const u32 pAddr);
+
 private:
     /// @brief Used to describe a page in the page pool (availability, a pointer to the next one..)
     struct PageBlock;
@@ -36,6 +40,11 @@ private:
 
     u32 _base;
     u32 _limit;
+
+    /// @brief The pool pages below this virtual address are part of a large page mapped once by Init(), they are never released
+    u32 _largePageLimit;
+    /// @brief Physical address of the large page mapped at _base
+    u32 _largePagePAddr;
 };
 
 #ifdef __PAGE_POOL__
@@ -3,12 +3,238 @@
 #include <kernel/lib/StdMem.hpp>
 #include <kernel/arch/x86/Vmm.hpp>
 #include <kernel/arch/x86/Pmm.hpp>
+#include <kernel/arch/x86/KMap.hpp>
 
 #include <kernel/Logger.hpp>
 #define KLOG(LOG_LEVEL, format, ...) KLOGGER("VAD", LOG_LEVEL, format, ##__VA_ARGS__)
 
 #define VAD_MINIMUM_DELTA PAGE_SIZE
 
+/// @brief Zero-fills a large page through the kernel map window, 4Ko at a time
+static KeStatus ClearLargePage(const u32 pAddr)
+{
+    for (u32 offset = 0; offset < LARGE_PAGE_SIZE; offset += PAGE_SIZE)
+    {
+        u8 * page = (u8 *)gKMap.Map(pAddr + offset);
+        if (page == nullptr)
+            return STATUS_ALLOC_FAILED;
+
+        MemSet(page, 0, PAGE_SIZE);
+
+        gKMap.Unmap(page);
+    }
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Checks that an address space may reserve size more bytes, nbResidentPages of them being committed immediately.
+///        An address space without counters or limits is never refused.
+static KeStatus CheckMemoryLimits(const PageDirectory * const pageDirectory, const u32 size, const u32 nbResidentPages)
+{
+    const MemoryCounters * counters = pageDirectory->counters;
+
+    if (counters == nullptr)
+        return STATUS_SUCCESS;
+
+    if (counters->committedBytesLimit != 0 &&
+        (counters->committedBytes > counters->committedBytesLimit || size > counters->committedBytesLimit - counters->committedBytes))
+    {
+        KLOG(LOG_WARNING, "Commit limit reached (%d + %d bytes, limit %d)", counters->committedBytes, size, counters->committedBytesLimit);
+        return STATUS_PROCESS_MEMORY_LIMIT_REACHED;
+    }
+
+    if (counters->residentPagesLimit != 0 && nbResidentPages > 0 &&
+        (counters->residentPages > counters->residentPagesLimit || nbResidentPages > counters->residentPagesLimit - counters->residentPages))
+    {
+        KLOG(LOG_WARNING, "Resident pages limit reached (%d + %d pages, limit %d)", counters->residentPages, nbResidentPages, counters->residentPagesLimit);
+        return STATUS_PROCESS_MEMORY_LIMIT_REACHED;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+static int TreeHeight(const Vad * const vad)
+{
+    return (vad != nullptr) ? vad->height : 0;
+}
+
+static unsigned int TreeLargestFree(const Vad * const vad)
+{
+    return (vad != nullptr) ? vad->largestFree : 0;
+}
+
+/// @brief Updates the height and the largest free size of a vad from its children
+static void TreeUpdate(Vad * const vad)
+{
+    int leftHeight = TreeHeight(vad->left);
+    int rightHeight = TreeHeight(vad->right);
+    unsigned int largestFree = vad->free ? vad->size : 0;
+
+    if (TreeLargestFree(vad->left) > largestFree)
+        largestFree = TreeLargestFree(vad->left);
+
+    if (TreeLargestFree(vad->right) > largestFree)
+        largestFree = TreeLargestFree(vad->right);
+
+    vad->height = ((leftHeight > rightHeight) ? leftHeight : rightHeight) + 1;
+    vad->largestFree = largestFree;
+}
+
+/// @brief Replaces the child oldChild of parent by newChild, parent being nullptr if oldChild is the root
+static void TreeReplaceChild(VadTree * const tree, Vad * const parent, Vad * const oldChild, Vad * const newChild)
+{
+    if (parent == nullptr)
+        tree->root = newChild;
+    else if (parent->left == oldChild)
+        parent->left = newChild;
+    else
+        parent->right = newChild;
+
+    if (newChild != nullptr)
+        newChild->parent = parent;
+}
+
+/// @return The new root of the rotated subtree
+static Vad * TreeRotateLeft(VadTree * const tree, Vad * const vad)
+{
+    Vad * right = vad->right;
+
+    vad->right = right->left;
+    if (vad->right != nullptr)
+        vad->right->parent = vad;
+
+    TreeReplaceChild(tree, vad->parent, vad, right);
+
+    right->left = vad;
+    vad->parent = right;
+
+    TreeUpdate(vad);
+    TreeUpdate(right);
+
+    return right;
+}
+
+/// @return The new root of the rotated subtree
+static Vad * TreeRotateRight(VadTree * const tree, Vad * const vad)
+{
+    Vad * left = vad->left;
+
+    vad->left = left->right;
+    if (vad->left != nullptr)
+        vad->left->parent = vad;
+
+    TreeReplaceChild(tree, vad->parent, vad, left);
+
+    left->right = vad;
+    vad->parent = left;
+
+    TreeUpdate(vad);
+    TreeUpdate(left);
+
+    return left;
+}
+
+/// @brief Updates the vad and its ancestors up to the root, rotating the unbalanced ones.
+///        It must be called each time the children, the size or the state of a vad change.
+static void TreeRebalance(VadTree * const tree, Vad * vad)
+{
+    while (vad != nullptr)
+    {
+        int balance = 0;
+
+        TreeUpdate(vad);
+
+        balance = TreeHeight(vad->left) - TreeHeight(vad->right);
+        if (balance > 1)
+        {
+            if (TreeHeight(vad->left->left) < TreeHeight(vad->left->right))
+                TreeRotateLeft(tree, vad->left);
+
+            vad = TreeRotateRight(tree, vad);
+        }
+        else if (balance < -1)
+        {
+            if (TreeHeight(vad->right->right) < TreeHeight(vad->right->left))
+                TreeRotateRight(tree, vad->right);
+
+            vad = TreeRotateLeft(tree, vad);
+        }
+
+        vad = vad->parent;
+    }
+}
+
+static void TreeInsert(VadTree * const tree, Vad * const vad)
+{
+    Vad * parent = nullptr;
+    Vad * current = tree->root;
+
+    while (current != nullptr)
+    {
+        parent = current;
+        current = (vad->baseAddress < current->baseAddress) ? current->left : current->right;
+    }
+
+    vad->parent = parent;
+    vad->left = nullptr;
+    vad->right = nullptr;
+
+    if (parent == nullptr)
+        tree->root = vad;
+    else if (vad->baseAddress < parent->baseAddress)
+        parent->left = vad;
+    else
+        parent->right = vad;
+
+    TreeRebalance(tree, vad);
+}
+
+/// @brief Unlinks a vad from the tree. Vads are referenced outside of the tree, so a vad with two children
+///        is replaced by its successor node itself rather than by a copy of it.
+static void TreeRemove(VadTree * const tree, Vad * const vad)
+{
+    Vad * rebalanceFrom = nullptr;
+
+    if (vad->left != nullptr && vad->right != nullptr)
+    {
+        Vad * successor = vad->right;
+
+        while (successor->left != nullptr)
+            successor = successor->left;
+
+        if (successor->parent != vad)
+        {
+            rebalanceFrom = successor->parent;
+
+            TreeReplaceChild(tree, successor->parent, successor, successor->right);
+
+            successor->right = vad->right;
+            successor->right->parent = successor;
+        }
+        else
+        {
+            rebalanceFrom = successor;
+        }
+
+        successor->left = vad->left;
+        successor->left->parent = successor;
+
+        TreeReplaceChild(tree, vad->parent, vad, successor);
+    }
+    else
+    {
+        rebalanceFrom = vad->parent;
+
+        TreeReplaceChild(tree, vad->parent, vad, (vad->left != nullptr) ? vad->left : vad->right);
+    }
+
+    vad->parent = nullptr;
+    vad->left = nullptr;
+    vad->right = nullptr;
+
+    TreeRebalance(tree, rebalanceFrom);
+}
+
 KeStatus Vad::Create(void * const baseAddress, const unsigned int size, bool free, Vad ** const outVad)
 {
     KeStatus status = STATUS_FAILURE;
@@ -39,12 +265,28 @@ KeStatus Vad::Create(void * const baseAddress, const unsigned int size, bool fre
         goto clean;
     }
 
+    localVad->tree = (VadTree*)HeapAlloc(sizeof(VadTree));
+    if (localVad->tree == nullptr)
+    {
+        status = STATUS_ALLOC_FAILED;
+        goto clean;
+    }
+
     localVad->baseAddress = (u8*)baseAddress;
     localVad->limitAddress = (u8*)baseAddress + size;
     localVad->size = size;
     localVad->free = free;
+    localVad->fileData = nullptr;
+    localVad->fileSize = 0;
+    localVad->writable = true;
+    localVad->largePages = false;
+    localVad->guardSize = 0;
+    localVad->origin = VAD_ORIGIN_KERNEL;
     localVad->previous = nullptr;
     localVad->next = nullptr;
+    localVad->tree->root = nullptr;
+
+    TreeInsert(localVad->tree, localVad);
 
     *outVad = localVad;
     localVad = nullptr;
@@ -52,9 +294,51 @@ KeStatus Vad::Create(void * const baseAddress, const unsigned int size, bool fre
     status = STATUS_SUCCESS;
 
 clean:
+    if (localVad != nullptr)
+    {
+        HeapFree(localVad);
+        localVad = nullptr;
+    }
+
     return status;
 }
 
+KeStatus Vad::_CreateNext(void * const baseAddress, const unsigned int size, Vad ** const outVad)
+{
+    Vad * localVad = (Vad*)HeapAlloc(sizeof(Vad));
+    if (localVad == nullptr)
+    {
+        KLOG(LOG_ERROR, "Couldn't allocate %d bytes", sizeof(Vad));
+        return STATUS_ALLOC_FAILED;
+    }
+
+    localVad->baseAddress = (u8*)baseAddress;
+    localVad->limitAddress = (u8*)baseAddress + size;
+    localVad->size = size;
+    localVad->free = true;
+    localVad->fileData = nullptr;
+    localVad->fileSize = 0;
+    localVad->writable = true;
+    localVad->largePages = false;
+    localVad->guardSize = 0;
+    localVad->origin = VAD_ORIGIN_KERNEL;
+    localVad->tree = this->tree;
+
+    localVad->previous = this;
+    localVad->next = this->next;
+
+    if (localVad->next != nullptr)
+        localVad->next->previous = localVad;
+
+    this->next = localVad;
+
+    TreeInsert(this->tree, localVad);
+
+    *outVad = localVad;
+
+    return STATUS_SUCCESS;
+}
+
 KeStatus Vad::Allocate(const unsigned int size, const PageDirectory * pageDirectory, const bool reservePhysicalPages, Vad** const outVad)
 {
     KeStatus status = STATUS_FAILURE;
@@ -140,38 +424,106 @@ KeStatus Vad::AllocateAtAddress(void * const address, const unsigned int size, c
         return STATUS_NULL_PARAMETER;
     }
 
-    status = LookForFreeVadAtAddressOfMinimumSize(address, size, &freeVad);
+    status = _SplitFreeVadAtAddress(address, size, &freeVad);
+    if (FAILED(status))
+        goto clean;
+
+    status = freeVad->ReservePages(pageDirectory, reservePhysicalPages);
     if (FAILED(status))
     {
-        KLOG(LOG_ERROR, "LookForFreeVadAtAddressOfMinimumSize() failed with code %t", status);
+        KLOG(LOG_ERROR, "ReservePages() failed with code %t", status);
         goto clean;
     }
 
-    // If the asked address is in the middle of the free vad,
-    //  or if the vad is too large, we split it
-    if (freeVad->baseAddress != address 
-        || (freeVad->baseAddress == address && ((freeVad->size - size) > VAD_MINIMUM_DELTA)))
+    *outVad = freeVad;
+    freeVad = nullptr;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
+KeStatus Vad::AllocateLargePages(const unsigned int size, const PageDirectory * pageDirectory, Vad ** const outVad)
+{
+    KeStatus status = STATUS_FAILURE;
+    Vad * freeVad = nullptr;
+    u32 address = 0;
+
+    if (size == 0 || (size & (LARGE_PAGE_SIZE - 1)) != 0)
     {
-        status = freeVad->SplitAtAddress(address, size);
+        KLOG(LOG_ERROR, "Invalid size parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    // The free vad must be able to hold the size from its first 4Mo aligned address
+    status = LookForFreeVadOfMinimumSize(size + LARGE_PAGE_SIZE - PAGE_SIZE, &freeVad);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "LookForFreeVadOfMinimumSize() failed with code %t", status);
+        return status;
+    }
+
+    address = ((u32)freeVad->baseAddress + LARGE_PAGE_SIZE - 1) & ~(LARGE_PAGE_SIZE - 1);
+
+    return AllocateLargePagesAtAddress((void*)address, size, pageDirectory, outVad);
+}
+
+KeStatus Vad::AllocateLargePagesAtAddress(void * const address, const unsigned int size, const PageDirectory * pageDirectory, Vad ** const outVad)
+{
+    KeStatus status = STATUS_FAILURE;
+    Vad * freeVad = nullptr;
+
+    if (address == nullptr || ((u32)address & (LARGE_PAGE_SIZE - 1)) != 0)
+    {
+        KLOG(LOG_ERROR, "Invalid address parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (size == 0 || (size & (LARGE_PAGE_SIZE - 1)) != 0)
+    {
+        KLOG(LOG_ERROR, "Invalid size parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (pageDirectory == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid pageDirectory parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (outVad == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid outVad parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (!gVmm.AreLargePagesEnabled())
+        return STATUS_NOT_SUPPORTED;
+
+    status = _SplitFreeVadAtAddress(address, size, &freeVad);
+    if (FAILED(status))
+        goto clean;
+
+    // The last large page would go beyond a vad even one page larger
+    if (freeVad->size > size)
+    {
+        status = freeVad->Split(size);
         if (FAILED(status))
         {
-            KLOG(LOG_ERROR, "SplitAtAddress() failed with code %t", status);
+            KLOG(LOG_ERROR, "Split() failed with code %t", status);
             goto clean;
         }
-
-        if (freeVad->baseAddress != address)
-            freeVad = freeVad->next;
     }
 
-    status = freeVad->ReservePages(pageDirectory, reservePhysicalPages);
+    status = freeVad->ReserveLargePages(pageDirectory);
     if (FAILED(status))
     {
-        KLOG(LOG_ERROR, "ReservePages() failed with code %t", status);
+        KLOG(LOG_ERROR, "ReserveLargePages() failed with code %t", status);
         goto clean;
     }
 
     *outVad = freeVad;
-    freeVad = nullptr;
 
     status = STATUS_SUCCESS;
 
@@ -179,6 +531,39 @@ clean:
     return status;
 }
 
+KeStatus Vad::_SplitFreeVadAtAddress(void * const address, const unsigned int size, Vad ** const outVad)
+{
+    KeStatus status = STATUS_FAILURE;
+    Vad * freeVad = nullptr;
+
+    status = LookForFreeVadAtAddressOfMinimumSize(address, size, &freeVad);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "LookForFreeVadAtAddressOfMinimumSize() failed with code %t", status);
+        return status;
+    }
+
+    // If the asked address is in the middle of the free vad,
+    //  or if the vad is too large, we split it
+    if (freeVad->baseAddress != address 
+        || (freeVad->baseAddress == address && ((freeVad->size - size) > VAD_MINIMUM_DELTA)))
+    {
+        status = freeVad->SplitAtAddress(address, size);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "SplitAtAddress() failed with code %t", status);
+            return status;
+        }
+
+        if (freeVad->baseAddress != address)
+            freeVad = freeVad->next;
+    }
+
+    *outVad = freeVad;
+
+    return STATUS_SUCCESS;
+}
+
 KeStatus Vad::LookForVadFromAddress(void* const address, Vad** const outVad)
 {
     KeStatus status = STATUS_FAILURE;
@@ -196,15 +581,16 @@ KeStatus Vad::LookForVadFromAddress(void* const address, Vad** const outVad)
         return STATUS_NULL_PARAMETER;
     }
 
-    vad = this;
-    do
+    vad = this->tree->root;
+    while (vad != nullptr)
     {
-        if (address >= vad->baseAddress && address < vad->limitAddress)
+        if (address < vad->baseAddress)
+            vad = vad->left;
+        else if (address >= vad->limitAddress)
+            vad = vad->right;
+        else
             break;
-
-        vad = vad->next;
-
-    } while (vad != nullptr);
+    }
 
     if (vad == nullptr)
     {
@@ -239,23 +625,25 @@ KeStatus Vad::LookForFreeVadOfMinimumSize(const unsigned int size, Vad ** const
         return STATUS_NULL_PARAMETER;
     }
 
-    currentVad = this;
-
-    while (currentVad->size < size || !currentVad->free)
-    {
-        currentVad = currentVad->next;
-
-        if (currentVad == nullptr)
-            break;
-    }
-
-    if (currentVad == nullptr)
+    currentVad = this->tree->root;
+    if (TreeLargestFree(currentVad) < size)
     {
         KLOG(LOG_WARNING, "No available VAD was found (size : %d)", size);
         status = STATUS_NOT_FOUND;
         goto clean;
     }
 
+    // The largest free size of the subtrees tells which side holds the lowest free vad that is large enough
+    while (true)
+    {
+        if (TreeLargestFree(currentVad->left) >= size)
+            currentVad = currentVad->left;
+        else if (currentVad->free && currentVad->size >= size)
+            break;
+        else
+            currentVad = currentVad->right;
+    }
+
     freeVad = currentVad;
 
     *outVad = freeVad;
@@ -291,33 +679,17 @@ KeStatus Vad::LookForFreeVadAtAddressOfMinimumSize(void * const address, const u
         return STATUS_NULL_PARAMETER;
     }
 
-    currentVad = this;
-    do
+    status = LookForVadFromAddress(address, &currentVad);
+    if (FAILED(status))
     {
-        if (address >= currentVad->baseAddress && address < currentVad->limitAddress)
-        {
-            unsigned int innerSize = 0;
-
-            // We don't want the vad size, but the size between the wanted address and the limit
-            innerSize = (unsigned int)currentVad->limitAddress - (unsigned int)address;
-
-            if (!currentVad->free || innerSize < size)
-            {
-                KLOG(LOG_DEBUG, "Address %x is in reserved vad or the vad size doesn't match (%d/%d)", address, size, currentVad->size);
-                status = STATUS_NOT_FOUND;
-                goto clean;
-            }
-
-            break;
-        }
-
-        currentVad = currentVad->next;
-
-    } while (currentVad != nullptr && (currentVad->size < size || !currentVad->free));
+        KLOG(LOG_WARNING, "No VAD contains the address %x", address);
+        goto clean;
+    }
 
-    if (currentVad == nullptr)
+    // We don't want the vad size, but the size between the wanted address and the limit
+    if (!currentVad->free || ((unsigned int)currentVad->limitAddress - (unsigned int)address) < size)
     {
-        KLOG(LOG_WARNING, "No available VAD was found (size : %d)", size);
+        KLOG(LOG_DEBUG, "Address %x is in reserved vad or the vad size doesn't match (%d/%d)", address, size, currentVad->size);
         status = STATUS_NOT_FOUND;
         goto clean;
     }
@@ -370,22 +742,18 @@ KeStatus Vad::Split(const unsigned int size)
         nbPages++;
     }
 
-    status = Vad::Create(this->baseAddress + (nbPages * PAGE_SIZE), this->size - (nbPages * PAGE_SIZE), true, &newVad);
+    status = _CreateNext(this->baseAddress + (nbPages * PAGE_SIZE), this->size - (nbPages * PAGE_SIZE), &newVad);
     if (FAILED(status))
     {
-        KLOG(LOG_ERROR, "Create() failed with code %t", status);
+        KLOG(LOG_ERROR, "_CreateNext() failed with code %t", status);
         goto clean;
     }
 
-    newVad->previous = this;
-
-    if (newVad->next != nullptr)
-        newVad->next->previous = newVad;
-
     this->limitAddress = this->baseAddress + (nbPages * PAGE_SIZE);
     this->size = (nbPages * PAGE_SIZE);
-    this->next = newVad;
-    
+
+    TreeRebalance(this->tree, this);
+
     status = STATUS_SUCCESS;
 
 clean:
@@ -443,23 +811,18 @@ KeStatus Vad::SplitAtAddress(void * const address, const unsigned int size)
             goto clean;
         }
 
-        status = Vad::Create(address, secondBlockSize, true, &newVad);
+        status = _CreateNext(address, secondBlockSize, &newVad);
         if (FAILED(status))
         {
-            KLOG(LOG_ERROR, "Create() failed with code %t", status);
+            KLOG(LOG_ERROR, "_CreateNext() failed with code %t", status);
             goto clean;
         }
 
-        newVad->previous = this;
-        newVad->next = this->next;
-
-        if (newVad->next != nullptr)
-            newVad->next->previous = newVad;
-
         // We update the first block size and limit address
         this->limitAddress -= secondBlockSize;
         this->size -= secondBlockSize;
-        this->next = newVad;
+
+        TreeRebalance(this->tree, this);
 
         // If the second block is too big for the asked size, we split it
         if ((newVad->size - size) > VAD_MINIMUM_DELTA)
@@ -491,11 +854,14 @@ clean:
 
 KeStatus Vad::ReservePages(const PageDirectory * pageDirectory, const bool reservePhysicalPages)
 {
+    KeStatus status = STATUS_FAILURE;
     u8 * vAddr = this->baseAddress;
-    PageDirectoryEntry * currentPd = gVmm.GetCurrentPageDirectory();
 
-    gVmm.SetCurrentPageDirectory(pageDirectory->pdEntry);
+    status = CheckMemoryLimits(pageDirectory, this->size, reservePhysicalPages ? this->size / PAGE_SIZE : 0);
+    if (FAILED(status))
+        return status;
 
+    // The page directory doesn't have to be the current one, it is edited through the kernel map window otherwise
     while (vAddr < this->limitAddress)
     {
         if (reservePhysicalPages)
@@ -507,21 +873,195 @@ KeStatus Vad::ReservePages(const PageDirectory * pageDirectory, const bool reser
                 return STATUS_PHYSICAL_MEMORY_FULL;
             }
 
-            gVmm.AddPageToPageDirectory((u32)vAddr, (u32)pAddr, PAGE_PRESENT | PAGE_WRITEABLE | PAGE_NON_PRIVILEGED_ACCESS, *pageDirectory);
+            status = gVmm.MapPageInDirectory(*pageDirectory, (u32)vAddr, (u32)pAddr, PAGE_PRESENT | PAGE_WRITEABLE | PAGE_NON_PRIVILEGED_ACCESS);
         }
         else
         {
             // The virtual address doesn't point to any physical address
             // The page is set as not present in memory, so if we try to access it, a page fault will occured and a physical page will be reserved
-            gVmm.AddPageToPageDirectory((u32)vAddr, 0, PAGE_WRITEABLE | PAGE_NON_PRIVILEGED_ACCESS, *pageDirectory);
+            status = gVmm.MapPageInDirectory(*pageDirectory, (u32)vAddr, 0, PAGE_WRITEABLE | PAGE_NON_PRIVILEGED_ACCESS);
+        }
+
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "Vmm::MapPageInDirectory() failed with code %t", status);
+            return status;
         }
 
         vAddr = (u8 *)((unsigned int)vAddr + (unsigned int)PAGE_SIZE);
     }
 
-    gVmm.SetCurrentPageDirectory(currentPd);
+    this->free = false;
+
+    if (pageDirectory->counters != nullptr)
+        pageDirectory->counters->committedBytes += this->size;
+
+    TreeRebalance(this->tree, this);
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus Vad::ReserveLargePages(const PageDirectory * pageDirectory)
+{
+    KeStatus status = STATUS_FAILURE;
+    u8 * vAddr = this->baseAddress;
+
+    status = CheckMemoryLimits(pageDirectory, this->size, this->size / PAGE_SIZE);
+    if (FAILED(status))
+        return status;
+
+    while (vAddr < this->limitAddress)
+    {
+        void * pAddr = gPmm.GetFreeLargePage();
+        if (pAddr == nullptr)
+        {
+            KLOG(LOG_ERROR, "Pmm::GetFreeLargePage() returned null");
+            status = STATUS_PHYSICAL_MEMORY_FULL;
+            goto clean;
+        }
+
+        // The physical pages may hold data of another process
+        status = ClearLargePage((u32)pAddr);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "ClearLargePage() failed with code %t", status);
+            gPmm.ReleaseLargePage(pAddr);
+            goto clean;
+        }
+
+        status = gVmm.MapLargePageInDirectory(*pageDirectory, (u32)vAddr, (u32)pAddr, PAGE_PRESENT | PAGE_WRITEABLE | PAGE_NON_PRIVILEGED_ACCESS);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "Vmm::MapLargePageInDirectory() failed with code %t", status);
+            gPmm.ReleaseLargePage(pAddr);
+            goto clean;
+        }
+
+        vAddr = (u8 *)((unsigned int)vAddr + (unsigned int)LARGE_PAGE_SIZE);
+    }
 
     this->free = false;
+    this->largePages = true;
+
+    if (pageDirectory->counters != nullptr)
+        pageDirectory->counters->committedBytes += this->size;
+
+    TreeRebalance(this->tree, this);
+
+    return STATUS_SUCCESS;
+
+clean:
+    // The large pages already mapped are given back, the vad stays free
+    _ReleaseLargePages(pageDirectory, vAddr);
+
+    return status;
+}
+
+void Vad::_ReleaseLargePages(const PageDirectory * pageDirectory, u8 * const limitAddress)
+{
+    for (u8 * vAddr = this->baseAddress; vAddr < limitAddress; vAddr = (u8 *)((unsigned int)vAddr + (unsigned int)LARGE_PAGE_SIZE))
+    {
+        PageDirectoryEntry pde = { 0 };
+
+        if (!FAILED(gVmm.GetPageDirectoryEntryInDirectory(*pageDirectory, (u32)vAddr, &pde)) && pde.present && pde.pageSize)
+        {
+            gPmm.ReleaseLargePage((void*)(pde.pageTableAddr << 12));
+
+            gVmm.SetPageDirectoryEntry(&pde, 0, PAGE_EMPTY);
+            gVmm.SetPageDirectoryEntryInDirectory(*pageDirectory, (u32)vAddr, pde);
+        }
+    }
+}
+
+KeStatus Vad::Release(const PageDirectory * pageDirectory)
+{
+    u8 * vAddr = this->baseAddress;
+    Vad * vad = this;
+
+    if (pageDirectory == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid pageDirectory parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (this->free)
+    {
+        KLOG(LOG_ERROR, "The vad [%x - %x] is already free", this->baseAddress, this->limitAddress);
+        return STATUS_UNEXPECTED;
+    }
+
+    // A large page has no page table, its directory entry is cleared
+    if (this->largePages)
+    {
+        _ReleaseLargePages(pageDirectory, this->limitAddress);
+        vAddr = this->limitAddress;
+    }
+
+    while (vAddr < this->limitAddress)
+    {
+        PageTableEntry pte = { 0 };
+
+        // Pages that have never been accessed don't have any physical page
+        if (!FAILED(gVmm.GetPageTableEntryInDirectory(*pageDirectory, (u32)vAddr, &pte)) && pte.present)
+        {
+            // The physical page is set free only if it isn't shared with another mapping
+            gPmm.ReleasePage((void*)(pte.pageAddr << 12));
+
+            gVmm.SetPageTableEntry(&pte, 0, PAGE_EMPTY);
+            gVmm.SetPageTableEntryInDirectory(*pageDirectory, (u32)vAddr, pte);
+        }
+
+        vAddr = (u8 *)((unsigned int)vAddr + (unsigned int)PAGE_SIZE);
+    }
+
+    if (pageDirectory->counters != nullptr)
+        pageDirectory->counters->committedBytes -= this->size;
+
+    vad->free = true;
+    vad->fileData = nullptr;
+    vad->fileSize = 0;
+    vad->writable = true;
+    vad->largePages = false;
+    vad->guardSize = 0;
+    vad->origin = VAD_ORIGIN_KERNEL;
+
+    // Merging with the next vad if free
+    if (vad->next != nullptr && vad->next->free)
+    {
+        Vad * next = vad->next;
+
+        TreeRemove(vad->tree, next);
+
+        vad->limitAddress = next->limitAddress;
+        vad->size += next->size;
+        vad->next = next->next;
+
+        if (vad->next != nullptr)
+            vad->next->previous = vad;
+
+        HeapFree(next);
+    }
+
+    // Merging with the previous vad if free
+    if (vad->previous != nullptr && vad->previous->free)
+    {
+        Vad * previous = vad->previous;
+
+        TreeRemove(vad->tree, vad);
+
+        previous->limitAddress = vad->limitAddress;
+        previous->size += vad->size;
+        previous->next = vad->next;
+
+        if (previous->next != nullptr)
+            previous->next->previous = previous;
+
+        HeapFree(vad);
+        vad = previous;
+    }
+
+    // The vad is now free and may have grown, the free sizes of its ancestors are updated
+    TreeRebalance(vad->tree, vad);
 
     return STATUS_SUCCESS;
 }
@@ -3,7 +3,31 @@
 #include <kernel/lib/Status.hpp>
 #include <kernel/arch/x86/Vmm.hpp>
 
-/// @brief Virtual address descriptor, used to describe the virtual address space of a process
+struct Vad;
+
+/// @brief Used to tell which path reserved a vad, and so which one may release it
+enum VadOrigin
+{
+    /// @brief The vad is managed by the kernel (image, stack, heap, ipc rings...)
+    VAD_ORIGIN_KERNEL = 0,
+    /// @brief The vad holds pages received by IpcHandler::ReceivePages()
+    VAD_ORIGIN_RECEIVE_PAGES,
+    /// @brief The vad was reserved by SysMapAnonymous
+    VAD_ORIGIN_MAP_ANONYMOUS,
+    /// @brief The vad was reserved by SysMapLargePages
+    VAD_ORIGIN_MAP_LARGE_PAGES
+};
+
+/// @brief Index of the vads of an address space, an AVL tree keyed by base address
+struct VadTree
+{
+    /// The tree root, nullptr if the tree is empty
+    Vad * root;
+};
+
+/// @brief Virtual address descriptor, used to describe the virtual address space of a process.
+///        The vads of an address space are chained in address order (previous/next), which is used to merge free neighbors,
+///        and indexed in a balanced tree so that address lookups and free range searches don't walk the whole chain.
 struct Vad
 {
     /// The memory block base address
@@ -17,10 +41,34 @@ struct Vad
     /// Boolean telling if this block is available
     bool free;
 
+    /// Data backing the first bytes of the block, nullptr if the block is anonymous memory.
+    /// It is part of a module image, identity mapped by the kernel, so it is also the data physical address.
+    u8 * fileData;
+    /// Number of bytes of the block backed by fileData, the following ones are zero-filled on fault
+    unsigned int fileSize;
+    /// Boolean telling if the block may be written, pages mapped from fileData are then copied on the first write
+    bool writable;
+    /// Boolean telling if the block is mapped by 4Mo pages, its base address and size are then 4Mo aligned
+    bool largePages;
+    /// Number of bytes at the base of the block that are never mapped, the guard of a stack growing down to it
+    unsigned int guardSize;
+    /// The path that reserved the block
+    VadOrigin origin;
+
     Vad * previous;
     Vad * next;
 
-    /// @brief Creates a simple vad
+    /// The tree shared by every vad of the address space
+    VadTree * tree;
+    Vad * parent;
+    Vad * left;
+    Vad * right;
+    /// Height of the subtree rooted at this vad, a leaf has a height of 1
+    int height;
+    /// Size of the largest free vad of the subtree rooted at this vad, 0 if there is none
+    unsigned int largestFree;
+
+    /// @brief Creates a simple vad, and the tree indexing the address space it describes
     /// @param[in]  baseAddress The memory block base address
     /// @param[in]  size The memory block size in bytes
     /// @param[in]  free Boolean telling if the block is free or not
@@ -45,19 +93,36 @@ struct Vad
     /// @return STATUS_SUCCESS on success, an error code otherwise
     KeStatus AllocateAtAddress(void * const address, const unsigned int size, const PageDirectory * pageDirectory, const bool reservePhysicalPages, Vad ** const outVad);
 
-    /// @brief Looks for a vad given an address
+    /// @brief Looks for an available vad holding a 4Mo aligned area of the required size, reserves it, and maps it with large pages.
+    ///        Large pages are committed immediately, they are never demand paged.
+    /// @param[in]  size The required size, a multiple of LARGE_PAGE_SIZE
+    /// @param[in]  pageDirectory The process page directory
+    /// @param[out] outVad Pointer that will hold the new vad
+    /// @return STATUS_SUCCESS on success, STATUS_NOT_SUPPORTED if large pages are not enabled, an error code otherwise
+    KeStatus AllocateLargePages(const unsigned int size, const PageDirectory * pageDirectory, Vad ** const outVad);
+
+    /// @brief Looks for a new vad at the asked address and maps it with large pages
+    /// @param[in]  address The asked address, 4Mo aligned
+    /// @param[in]  size The required size, a multiple of LARGE_PAGE_SIZE
+    /// @param[in]  pageDirectory The process page directory
+    /// @param[out] outVad Pointer that will hold the new vad
+    /// @return STATUS_SUCCESS on success, STATUS_NOT_SUPPORTED if large pages are not enabled, an error code otherwise
+    KeStatus AllocateLargePagesAtAddress(void * const address, const unsigned int size, const PageDirectory * pageDirectory, Vad ** const outVad);
+
+    /// @brief Looks for a vad given an address, in O(log n)
     /// @param[in]  address Address that must be containd in the vad we are looking for
     /// @param[out] outVad Pointer that will hold a pointer to the found VAD
     /// @return STATUS_SUCCESS on success, an error code otherwise
     KeStatus LookForVadFromAddress(void* const address, Vad** const outVad);
 
-    /// @brief Looks for an available vad with a minimum required size
+    /// @brief Looks for an available vad with a minimum required size, in O(log n).
+    ///        The lowest one in the address space is returned.
     /// @param[in]  size The required size
     /// @param[out] outVad Pointer that will hold the free vad if found
     /// @return STATUS_SUCCESS on success, STATUS_NOT_FOUND if no vad is found, an error code otherwise
     KeStatus LookForFreeVadOfMinimumSize(const unsigned int size, Vad ** const outVad);
 
-    /// @brief Looks for an available vad with a minimum required size
+    /// @brief Looks for the available vad containing the asked address, with at least size bytes from the address to its limit
     /// @param[in]  address The asked address
     /// @param[in]  size The required size
     /// @param[out] outVad Pointer that will hold the free vad if found
@@ -81,5 +146,39 @@ struct Vad
     /// @return STATUS_SUCCESS on success, an error code otherwise
     KeStatus ReservePages(const PageDirectory * pageDirectory, const bool reservePhysicalPages);
 
+    /// @brief Set the current vad as reserved, and maps it with large pages taken from the physical memory manager.
+    ///        The vad base address and size must be 4Mo aligned. On failure, the vad stays free and nothing is mapped.
+    /// @param[in]  pageDirectory The process page directory
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus ReserveLargePages(const PageDirectory * pageDirectory);
+
+    /// @brief Unmaps the current vad pages from the given address space, releases the physical pages and sets the vad as free.
+    ///        The vad is then merged with its free neighbors.
+    /// @warning The vad may be freed by the merge, it must not be used after this call
+    /// @param[in] pageDirectory The process page directory
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus Release(const PageDirectory * pageDirectory);
+
     void PrintVad();
+
+private:
+    /// @brief Creates a vad following this one in the address space, and inserts it in the chain and in the tree
+    /// @param[in]  baseAddress The memory block base address
+    /// @param[in]  size The memory block size in bytes
+    /// @param[out] outVad Pointer that will hold a pointer to the newly allocated vad
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus _CreateNext(void * const baseAddress, const unsigned int size, Vad ** const outVad);
+
+    /// @brief Looks for the free vad holding the asked area, and splits it so that the returned free vad is exactly this area
+    ///        (or a bit larger, if the remaining part is too small to be a vad)
+    /// @param[in]  address The asked address
+    /// @param[in]  size The required size
+    /// @param[out] outVad Pointer that will hold the free vad
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus _SplitFreeVadAtAddress(void * const address, const unsigned int size, Vad ** const outVad);
+
+    /// @brief Unmaps the large pages of the vad below a limit address and gives them back to the physical memory manager
+    /// @param[in] pageDirectory The process page directory
+    /// @param[in] limitAddress The first address that is not released
+    void _ReleaseLargePages(const PageDirectory * pageDirectory, u8 * const limitAddress);
 };
\ No newline at end of file
@@ -36,6 +36,9 @@ struct ElfProgramHeaderTable
     u32 align;
 } typedef ElfProgramHeaderTable;
 
+/// @brief Segment flag telling that the segment is writable
+#define ELF_SEGMENT_FLAG_WRITE 0x2
+
 struct ElfFile
 {
     ElfHeader * header;
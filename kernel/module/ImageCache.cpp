@@ -0,0 +1,84 @@
+#define __IMAGE_CACHE__
+#include "ImageCache.hpp"
+
+#include <kernel/arch/x86/Pmm.hpp>
+#include <kernel/arch/x86/MemCommon.hpp>
+
+#include <kernel/Logger.hpp>
+#define KLOG(LOG_LEVEL, format, ...) KLOGGER("MODULE", LOG_LEVEL, format, ##__VA_ARGS__)
+
+/// @brief Compares two buffers of the same size
+/// @return true if they have the same content
+static bool SameContent(const u8 * first, const u8 * second, u32 size)
+{
+    while (size-- > 0)
+    {
+        if (*first++ != *second++)
+            return false;
+    }
+
+    return true;
+}
+
+void ImageCache::Init()
+{
+    _nbImages = 0;
+}
+
+KeStatus ImageCache::GetImage(MultiBootModule * const module, u8 ** const image, unsigned int * const nbReleasedPages)
+{
+    u8 * data = nullptr;
+    u32 size = 0;
+
+    if (module == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid module parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (image == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid image parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (nbReleasedPages == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid nbReleasedPages parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    *nbReleasedPages = 0;
+
+    data = (u8*)module->mod_start;
+    size = (u32)module->mod_end - (u32)module->mod_start;
+
+    for (unsigned int index = 0; index < _nbImages; index++)
+    {
+        if (_images[index].size != size || !SameContent(_images[index].data, data, size))
+            continue;
+
+        // Only the whole pages are released, the last one may hold something else after the image
+        for (u32 page = (u32)data; page + PAGE_SIZE <= (u32)module->mod_end; page += PAGE_SIZE)
+        {
+            gPmm.ReleasePage((void*)page);
+            (*nbReleasedPages)++;
+        }
+
+        *image = _images[index].data;
+
+        return STATUS_SUCCESS;
+    }
+
+    // A module that can't be cached is loaded from its own image
+    if (_nbImages < IMAGE_CACHE_MAX_IMAGES)
+    {
+        _images[_nbImages].data = data;
+        _images[_nbImages].size = size;
+        _nbImages++;
+    }
+
+    *image = data;
+
+    return STATUS_SUCCESS;
+}
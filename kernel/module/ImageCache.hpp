@@ -0,0 +1,47 @@
+#pragma once
+
+/// @file
+
+#include <kernel/multiboot.hpp>
+#include <kernel/lib/Status.hpp>
+#include <kernel/lib/Types.hpp>
+
+/// @brief Maximum number of distinct module images in the cache
+#define IMAGE_CACHE_MAX_IMAGES 32
+
+/// @brief Cache of the module images loaded by the kernel, keyed by their content.
+///        When the boot loader gives the same module several times (several instances of a service), every instance is
+///        loaded from the first image : the read-only segments map the same physical pages in every process,
+///        and the pages of the duplicated images are given back to the physical memory manager.
+class ImageCache
+{
+public:
+    /// @brief Clears the cache
+    void Init();
+
+    /// @brief Looks for an image identical to the module one in the cache, the module image is added to the cache if there is none.
+    ///        The whole pages of a duplicated image are released, it mustn't be used afterwards.
+    /// @param[in]  module The module being loaded
+    /// @param[out] image Pointer that will hold the image the module must be loaded from
+    /// @param[out] nbReleasedPages Pointer that will hold the number of physical pages released, 0 if the image wasn't in the cache yet
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus GetImage(MultiBootModule * const module, u8 ** const image, unsigned int * const nbReleasedPages);
+
+private:
+    struct Image
+    {
+        /// The first module image with this content, identity mapped
+        u8 * data;
+        /// The image size in bytes
+        u32 size;
+    };
+
+    Image _images[IMAGE_CACHE_MAX_IMAGES];
+    unsigned int _nbImages;
+};
+
+#ifdef __IMAGE_CACHE__
+ImageCache gImageCache;
+#else
+extern ImageCache gImageCache;
+#endif
@@ -1,5 +1,6 @@
 #include "Module.hpp"
 #include "Elf.hpp"
+#include "ImageCache.hpp"
 
 #include <kernel/Kernel.hpp>
 #include <kernel/arch/x86/Pmm.hpp>
@@ -16,14 +17,25 @@ void Module::Load(MultiBootModule * module)
     KeStatus status = STATUS_FAILURE;
     Process * process = nullptr;
     ElfFile elf;
+    u8 * image = nullptr;
+    unsigned int nbReleasedPages = 0;
+    unsigned int nbSharedPages = 0;
 
-    if (!Elf::ElfCheckIdent((ElfHeader *)module->mod_start))
+    // Several instances of the same module are loaded from a single image
+    status = gImageCache.GetImage(module, &image, &nbReleasedPages);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "ImageCache::GetImage() failed with code %t", status);
+        gKernel.Panic();
+    }
+
+    if (!Elf::ElfCheckIdent((ElfHeader *)image))
     {
         KLOG(LOG_ERROR, "The module is not a elf file");
         gKernel.Panic();
     }
 
-    if (Elf::ElfInit(module->mod_start, &elf) != STATUS_SUCCESS)
+    if (Elf::ElfInit(image, &elf) != STATUS_SUCCESS)
     {
         KLOG(LOG_ERROR, "ElfInit() failed");
         gKernel.Panic();
@@ -36,13 +48,22 @@ void Module::Load(MultiBootModule * module)
         gKernel.Panic();
     }
 
-    status = _MapElfInProcess(elf, process);
+    status = _MapElfInProcess(elf, (u32)module->mod_end - (u32)module->mod_start, process, &nbSharedPages);
     if (FAILED(status))
     {
         KLOG(LOG_ERROR, "MapElfInProcess() failed with code %t", status);
         gKernel.Panic();
     }
 
+    if (nbReleasedPages > 0)
+    {
+        KLOG(LOG_INFO, "Module %s loaded from the image of a previous instance : %d KiB saved (%d KiB of image released, %d KiB of read-only pages shared)",
+             module->name,
+             (nbReleasedPages + nbSharedPages) * (PAGE_SIZE / 1024),
+             nbReleasedPages * (PAGE_SIZE / 1024),
+             nbSharedPages * (PAGE_SIZE / 1024));
+    }
+
     status = process->CreateDefaultHeapAndStack();
     if (FAILED(status))
     {
@@ -61,19 +82,65 @@ static unsigned int _local_mod(unsigned int a, unsigned int b)
     return (a > 0) ? 1 : 0;
 }
 
-KeStatus Module::_MapElfInProcess(ElfFile elf, Process * process)
+KeStatus Module::_MapElfInProcess(ElfFile elf, u32 imageSize, Process * process, unsigned int * nbSharedPages)
 {
     KeStatus status = STATUS_FAILURE;
+    // The image pages that can be mapped in place, the last one may hold something else after the image
+    u32 imageLimit = ((u32)elf.header + imageSize) & ~(PAGE_SIZE - 1);
+
+    *nbSharedPages = 0;
 
     for (int i = 0; i < elf.header->phnum; i++)
     {
         u8 * vUserSectionPtr = (u8 *)elf.prgHeaderTable[i].vaddr;
         u32 sectionSize = elf.prgHeaderTable[i].memSize;
         u8 * pSectionPtr = (u8 *)((u32)elf.header + elf.prgHeaderTable[i].offset);
+        u32 pageOffset = (u32)vUserSectionPtr & (PAGE_SIZE - 1);
 
         if (vUserSectionPtr == nullptr)
             break;
 
+        // Modules are page aligned by the boot loader and stay in the kernel reserved memory : if the segment data has the
+        //  same offset in its page than the segment address, the module pages are used as they are on demand.
+        //  A segment without data (.bss only) is simply zero-filled on demand.
+        if (elf.prgHeaderTable[i].fileSize == 0
+            || (((u32)pSectionPtr & (PAGE_SIZE - 1)) == pageOffset
+                && (u32)pSectionPtr + elf.prgHeaderTable[i].fileSize <= KERNEL_LIMIT_P_ADDR))
+        {
+            u32 fileSize = (elf.prgHeaderTable[i].fileSize > 0) ? elf.prgHeaderTable[i].fileSize + pageOffset : 0;
+            u32 vadSize = sectionSize + pageOffset;
+            bool writable = FlagOn(elf.prgHeaderTable[i].flags, ELF_SEGMENT_FLAG_WRITE);
+
+            // A read-only segment without .bss is mapped in place up to its last page, which then shows the next bytes of the file :
+            //  every instance of the module shares all its pages instead of getting a private copy of the last one
+            if (!writable && fileSize > 0 && elf.prgHeaderTable[i].fileSize == sectionSize)
+            {
+                u32 roundedSize = (fileSize + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+
+                if ((u32)pSectionPtr - pageOffset + roundedSize <= imageLimit)
+                {
+                    fileSize = roundedSize;
+                    vadSize = roundedSize;
+                }
+            }
+
+            status = process->AllocateFileMemoryAtAddress(vUserSectionPtr - pageOffset,
+                                                          vadSize,
+                                                          (fileSize > 0) ? pSectionPtr - pageOffset : nullptr,
+                                                          fileSize,
+                                                          writable);
+            if (FAILED(status))
+            {
+                KLOG(LOG_ERROR, "Process::AllocateFileMemoryAtAddress() failed with status %t", status);
+                goto clean;
+            }
+
+            if (!writable)
+                *nbSharedPages += fileSize / PAGE_SIZE;
+
+            continue;
+        }
+
         status = process->AllocateMemoryAtAddress(vUserSectionPtr, true, sectionSize);
         if (FAILED(status))
         {
@@ -81,7 +148,13 @@ KeStatus Module::_MapElfInProcess(ElfFile elf, Process * process)
             goto clean;
         }
 
-        process->MemorySetAndCopy(pSectionPtr, vUserSectionPtr, sectionSize, 0);
+        // Bytes beyond the file size (.bss) are not in the file and must be zeroed
+        status = process->MemorySetAndCopy(pSectionPtr, vUserSectionPtr, sectionSize, elf.prgHeaderTable[i].fileSize, 0);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "Process::MemorySetAndCopy() failed with status %t", status);
+            goto clean;
+        }
     }
 
     status = STATUS_SUCCESS;
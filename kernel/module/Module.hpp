@@ -12,5 +12,11 @@ public:
     static void Load(MultiBootModule * module);
 
 private:
-    static KeStatus _MapElfInProcess(ElfFile elf, Process * process);
+    /// @brief Maps the segments of an elf image in a process
+    /// @param[in]  elf The elf image
+    /// @param[in]  imageSize The image size in bytes
+    /// @param[in]  process The process
+    /// @param[out] nbSharedPages Pointer that will hold the number of pages of read-only segments mapped in place from the image
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    static KeStatus _MapElfInProcess(ElfFile elf, u32 imageSize, Process * process, unsigned int * nbSharedPages);
 };
\ No newline at end of file
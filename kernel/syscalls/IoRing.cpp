@@ -0,0 +1,179 @@
+#include "IoRing.hpp"
+#include "UserMemory.hpp"
+
+#include <kernel/task/ipc/Ipc.hpp>
+#include <kernel/lib/StdMem.hpp>
+
+#include <kernel/Logger.hpp>
+#define KLOG(LOG_LEVEL, format, ...) KLOGGER("IORING", LOG_LEVEL, format, ##__VA_ARGS__)
+
+/// @brief Keeps the compiler from moving the entries accesses across the counters updates
+#define COMPILER_BARRIER() asm volatile("" ::: "memory")
+
+KeStatus IoRingHandler::Setup(Process * const process, IoRingQueues ** const queues)
+{
+    KeStatus status = STATUS_FAILURE;
+    IoRingQueues * newQueues = nullptr;
+
+    if (process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid process parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (queues == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid queues parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (process->ioRing != nullptr)
+    {
+        KLOG(LOG_DEBUG, "Process %d already has an io ring", process->pid);
+        return STATUS_HANDLE_ALREADY_EXIST;
+    }
+
+    status = process->AllocateMemory(sizeof(IoRingQueues), true, (void**)&newQueues);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Process::AllocateMemory() failed with code %t", status);
+        goto clean;
+    }
+
+    // We are in the process address space, the ring can be initialized directly
+    MemSet(newQueues, 0, sizeof(IoRingQueues));
+
+    process->ioRing = newQueues;
+    *queues = newQueues;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
+KeStatus IoRingHandler::Enter(Process * const process, const unsigned int nbSubmissions, unsigned int * const nbExecuted)
+{
+    IoRingQueues * queues = nullptr;
+    unsigned int executed = 0;
+
+    if (process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid process parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (nbExecuted == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid nbExecuted parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    queues = process->ioRing;
+    if (queues == nullptr)
+    {
+        KLOG(LOG_DEBUG, "Process %d has no io ring", process->pid);
+        return STATUS_NOT_FOUND;
+    }
+
+    while (executed < nbSubmissions)
+    {
+        IoRingSubmission submission;
+        IoRingCompletion * completion = nullptr;
+        const u32 submissionHead = queues->submissionHead;
+        const u32 completionTail = queues->completionTail;
+        u32 result = 0;
+
+        // The counters are written by the process, they are checked before being used
+        if (queues->submissionTail - submissionHead > IO_RING_ENTRIES)
+        {
+            KLOG(LOG_DEBUG, "Invalid submission queue counters (Process %d)", process->pid);
+            return STATUS_UNEXPECTED;
+        }
+
+        if (queues->submissionTail == submissionHead)
+            break;
+
+        // No completion is ever dropped, the remaining submissions wait for the process to make room
+        if (completionTail - queues->completionHead >= IO_RING_ENTRIES)
+            break;
+
+        COMPILER_BARRIER();
+
+        // The submission is copied so that the process can't change it once it has been checked
+        MemCopy(&queues->submissions[submissionHead & (IO_RING_ENTRIES - 1)], &submission, sizeof(IoRingSubmission));
+
+        queues->submissionHead = submissionHead + 1;
+
+        completion = &queues->completions[completionTail & (IO_RING_ENTRIES - 1)];
+        completion->status = _Execute(process, &submission, &result);
+        completion->result = result;
+        completion->userData = submission.userData;
+
+        COMPILER_BARRIER();
+
+        queues->completionTail = completionTail + 1;
+
+        executed++;
+    }
+
+    *nbExecuted = executed;
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus IoRingHandler::_Execute(Process * const process, const IoRingSubmission * const submission, u32 * const result)
+{
+    KeStatus status = STATUS_FAILURE;
+    IpcIoVector vectors[IPC_MAX_IO_VECTORS];
+
+    switch (submission->opcode)
+    {
+    case IO_RING_OP_NOP:
+        status = STATUS_SUCCESS;
+        break;
+
+    case IO_RING_OP_IPC_SEND:
+        status = CommitUserMemory(process, submission->buffer, submission->size, false);
+        if (FAILED(status))
+            break;
+
+        status = gIpcHandler.Send(submission->handle, process, (const char*)submission->buffer, submission->size);
+        break;
+
+    case IO_RING_OP_IPC_SEND_V:
+        // Same as SysIpcSendV(), the vectors can't be changed once they have been checked
+        status = CopyIoVectorsFromUser(process, vectors, (const IpcIoVector*)submission->buffer, submission->size);
+        if (FAILED(status))
+            break;
+
+        status = gIpcHandler.SendV(submission->handle, process, vectors, submission->size);
+        break;
+
+    case IO_RING_OP_IPC_RECV:
+        status = ProbeUserMemory(process, submission->buffer, submission->size, true);
+        if (FAILED(status))
+            break;
+
+        status = gIpcHandler.Receive(submission->handle, process, (char*)submission->buffer, submission->size, (unsigned int*)result);
+        break;
+
+    case IO_RING_OP_IPC_CHANNEL_WAIT:
+        status = CommitUserMemory(process, submission->buffer, sizeof(u32), false);
+        if (FAILED(status))
+            break;
+
+        status = gIpcHandler.ChannelWait(submission->handle, process, (const u32*)submission->buffer, submission->value);
+        break;
+
+    case IO_RING_OP_IPC_CHANNEL_WAKE:
+        status = gIpcHandler.ChannelWake(submission->handle, process);
+        break;
+
+    default:
+        KLOG(LOG_DEBUG, "Unknown opcode %d (Process %d)", submission->opcode, process->pid);
+        status = STATUS_INVALID_PARAMETER;
+    }
+
+    return status;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <kernel/lib/Status.hpp>
+#include <kernel/arch/x86/Process.hpp>
+
+#include "UKSyscallsCommon.h"
+
+/// @file
+
+/// @addgroup Syscalls
+/// @{
+
+/// @brief Executes the operations a process batches in its io ring, so that a single syscall
+///        pays the trap cost of a whole batch of ipc operations
+class IoRingHandler
+{
+public:
+    /// @brief Allocates the io ring of a process in its address space
+    /// @param[in]  process The process asking for an io ring
+    /// @param[out] queues Pointer that will hold the io ring address in the process address space
+    /// @return STATUS_SUCCESS on success, STATUS_HANDLE_ALREADY_EXIST if the process already has an io ring, an error code otherwise
+    static KeStatus Setup(Process * const process, IoRingQueues ** const queues);
+
+    /// @brief Executes the pending submissions of the process io ring, in order, and posts their completions.
+    ///        Operations that can block (receive, channel wait, send on a full buffer) block the calling thread
+    ///        until they are done, the next submissions are executed afterwards.
+    /// @param[in]  process The process whose io ring is used, it must be the current process
+    /// @param[in]  nbSubmissions The maximum number of submissions to execute
+    /// @param[out] nbExecuted Pointer that will hold the number of submissions executed, it is lower than nbSubmissions
+    ///             if there were less pending submissions, or if the completion queue is full
+    /// @return STATUS_SUCCESS on success, an error code otherwise. The status of each operation is in its completion
+    static KeStatus Enter(Process * const process, const unsigned int nbSubmissions, unsigned int * const nbExecuted);
+
+private:
+    /// @brief Executes one submission, previously copied out of the io ring
+    /// @param[in]  process The process that submitted the operation
+    /// @param[in]  submission The operation to execute
+    /// @param[out] result Pointer that will hold the operation result, if it has one
+    /// @return The operation status
+    static KeStatus _Execute(Process * const process, const IoRingSubmission * const submission, u32 * const result);
+};
+
+/// @}
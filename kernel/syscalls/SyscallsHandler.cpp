@@ -1,22 +1,51 @@
 #include "SyscallsHandler.hpp"
 #include "UKSyscallsCommon.h"
+#include "UserMemory.hpp"
 
 #include <kernel/task/ProcessManager.hpp>
+#include <kernel/task/Scheduler.hpp>
 #include <kernel/task/ipc/Ipc.hpp>
+#include <kernel/syscalls/IoRing.hpp>
+#include <kernel/syscalls/SyscallsStats.hpp>
 #include <kernel/lib/CriticalSection.hpp>
+#include <kernel/lib/StdLib.hpp>
 
 #include <kernel/Logger.hpp>
 #define KLOG(LOG_LEVEL, format, ...) KLOGGER("SYSCALLS", LOG_LEVEL, format, ##__VA_ARGS__)
 
-#define SYSCALL(_, functionName) void functionName(InterruptFromUserlandContext *);
+/// @brief Size of the chunks a string is printed by, SysPrintStr() copies it from the process one chunk at a time
+#define PRINT_CHUNK_SIZE 128
+
+/// @brief I/O privilege level bits of eflags, set for the threads of the processes created with SA_IO
+#define EFLAGS_IOPL_MASK 0x3000
+
+/// @brief Syscalls handlers indexed by syscall id, built using the syscalls list defined in SyscallsList.hpp
+static const SyscallFunction SyscallsTable[] =
+{
+#define SYSCALL(_, functionName) functionName,
 #define SYSCALL_ID(x, y) SYSCALL(x, y)
     SYSCALLS_LIST
 #undef SYSCALL_ID
 #undef SYSCALL
+};
+
+static inline u64 ReadTsc()
+{
+    u32 low = 0;
+    u32 high = 0;
+
+    asm volatile("rdtsc" : "=a"(low), "=d"(high));
+
+    return ((u64)high << 32) | low;
+}
 
 void SyscallsHandler::ExecuteSyscall(const SyscallId sysId, InterruptFromUserlandContext * context)
 {
-    if (sysId >= SYS_INVALID)
+    Thread * thread = nullptr;
+    Process * process = nullptr;
+    u64 start = 0;
+
+    if ((u32)sysId >= SYS_INVALID)
     {
         KLOG(LOG_ERROR, "Unknown syscall %d", sysId);
         return;
@@ -28,49 +57,63 @@ void SyscallsHandler::ExecuteSyscall(const SyscallId sysId, InterruptFromUserlan
         return;
     }
 
-    switch (sysId) {
-#define SYSCALL(id, functionName) \
-        case id:                  \
-            functionName(context);\
-            break;  
-#define SYSCALL_ID(x, y) SYSCALL(x, y)
-        SYSCALLS_LIST
-#undef SYSCALL_ID
-#undef SYSCALL
-    default:
-        KLOG(LOG_ERROR, "Unknown syscall %d", sysId);
+    // The calling thread and its process are looked up once for all the handlers
+    thread = gThreadManager.GetCurrentThread();
+    if (thread == nullptr || thread->process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Syscall %d made without a current thread", sysId);
+        return;
     }
+
+    process = thread->process;
+
+    // The handlers may give values back in these registers, they are saved first for the trace
+    const u32 args[3] = { context->ebx, context->ecx, context->edx };
+
+    start = ReadTsc();
+
+    SyscallsTable[sysId](context, thread, process);
+
+    gSyscallsStats.Record(sysId, process, args, context->eax, (u32)(ReadTsc() - start));
 }
 
-    // Test to avoid mixing output on all processes 
+    // Test to avoid mixing output on all processes
     static CriticalSection s_CriticalSection;
 
-/*  
+/*
     SYSCALLS Begin
 */
-void SysPrintChar(InterruptFromUserlandContext * context)
+void SysPrintChar(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
 {
     kprint("%c", context->ebx);
 }
 
-void SysPrintStr(InterruptFromUserlandContext * context)
+void SysPrintStr(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
 {
-    kprint("%s", context->ebx);
+    const char * userStr = (const char *)context->ebx;
+    char chunk[PRINT_CHUNK_SIZE];
+    unsigned int length = 0;
+
+    do
+    {
+        if (FAILED(CopyStringFromUser(process, chunk, userStr, PRINT_CHUNK_SIZE, &length)))
+        {
+            KLOG(LOG_DEBUG, "Invalid string %x (Process %d)", userStr, process->pid);
+            return;
+        }
+
+        kprint("%s", chunk);
+
+        userStr += length;
+    } while (length == PRINT_CHUNK_SIZE - 1);
 }
 
-void SysSbrk(InterruptFromUserlandContext * context)
+void SysSbrk(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
 {
     KeStatus status = STATUS_FAILURE;
-    Process * currentProcess = gProcessManager.GetCurrentProcess();
     u32 res = 0;
 
-    if (currentProcess == nullptr)
-    {
-        KLOG(LOG_ERROR, "GetCurrentProcess() returned null");
-        goto clean;
-    }
-
-    status = currentProcess->IncreaseHeap(context->ebx, (u8**)&res);
+    status = process->IncreaseHeap(context->ebx, (u8**)&res);
     if (FAILED(status))
     {
         KLOG(LOG_ERROR, "Process::IncreaseHeap() failed with code %t", status);
@@ -81,17 +124,20 @@ clean:
     context->eax = res;
 }
 
-void SysIpcServerCreate(InterruptFromUserlandContext* context)
+void SysIpcServerCreate(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
 {
     KeStatus status = STATUS_FAILURE;
-    const char * serverIdStr = (const char *)context->ebx;
+    char serverIdStr[USER_STRING_MAX_SIZE];
+    unsigned int length = 0;
     IpcHandle handle = INVALID_HANDLE_VALUE;
-    Process* process = nullptr;
 
-    process = gProcessManager.GetCurrentProcess();
-    if (process == nullptr)
+    status = CopyStringFromUser(process, serverIdStr, (const char *)context->ebx, USER_STRING_MAX_SIZE, &length);
+    if (FAILED(status))
+        goto clean;
+
+    if (length == USER_STRING_MAX_SIZE - 1)
     {
-        KLOG(LOG_ERROR, "GetCurrentProcess() failed !");
+        status = STATUS_INVALID_PARAMETER;
         goto clean;
     }
 
@@ -109,17 +155,20 @@ clean:
     context->ebx = handle;
 }
 
-void SysIpcServerConnect(InterruptFromUserlandContext* context)
+void SysIpcServerConnect(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
 {
     KeStatus status = STATUS_FAILURE;
-    const char* serverIdStr = (const char*)context->ebx;
+    char serverIdStr[USER_STRING_MAX_SIZE];
+    unsigned int length = 0;
     IpcHandle handle = INVALID_HANDLE_VALUE;
-    Process* process = nullptr;
 
-    process = gProcessManager.GetCurrentProcess();
-    if (process == nullptr)
+    status = CopyStringFromUser(process, serverIdStr, (const char *)context->ebx, USER_STRING_MAX_SIZE, &length);
+    if (FAILED(status))
+        goto clean;
+
+    if (length == USER_STRING_MAX_SIZE - 1)
     {
-        KLOG(LOG_ERROR, "GetCurrentProcess() failed !");
+        status = STATUS_INVALID_PARAMETER;
         goto clean;
     }
 
@@ -137,29 +186,173 @@ clean:
     context->ebx = handle;
 }
 
-void SysIpcSend(InterruptFromUserlandContext* context)
+void SysIpcSend(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
 {
     KeStatus status = STATUS_FAILURE;
-    IpcHandle handle = INVALID_HANDLE_VALUE;
-    char* message = nullptr;
+    IpcHandle handle = (IpcHandle)context->ebx;
+    char * message = (char*)context->ecx;
+    unsigned int size = (unsigned int)context->edx;
+
+    status = CommitUserMemory(process, message, size, false);
+    if (FAILED(status))
+        goto clean;
+
+    status = gIpcHandler.Send(handle, process, message, size);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "IpcHandler::Send() failed with code %d (Process %d)", status, process->pid);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+}
+
+void SysIpcReceive(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    KeStatus receiveStatus = STATUS_FAILURE;
+    SysIpcReceiveParameter parameters;
+    unsigned int readBytes = 0;
+    IpcSenderInfo sender;
+
+    status = CopyFromUser(process, &parameters, (const void *)context->ebx, sizeof(SysIpcReceiveParameter));
+    if (FAILED(status))
+        goto clean;
+
+    if (FAILED(ProbeUserMemory(process, parameters.buffer, parameters.size, true))
+        || FAILED(ProbeUserMemory(process, parameters.readBytesPtr, sizeof(unsigned int), true))
+        || FAILED(ProbeUserMemory(process, parameters.senderPtr, (parameters.senderPtr != nullptr) ? sizeof(IpcSenderInfo) : 0, true)))
+    {
+        status = STATUS_INVALID_VIRTUAL_USER_ADDRESS;
+        goto clean;
+    }
+
+    receiveStatus = gIpcHandler.Receive(parameters.ipcHandle, process, parameters.buffer, parameters.size, &readBytes, (parameters.senderPtr != nullptr) ? &sender : nullptr);
+    if (FAILED(receiveStatus) && receiveStatus != IPC_STATUS_BUFFER_TOO_SMALL)
+    {
+        KLOG(LOG_DEBUG, "IpcHandler::Receive() failed with code %d (Process %d)", receiveStatus, process->pid);
+        status = receiveStatus;
+        goto clean;
+    }
+
+    // The thread may have waited for the message, the pointers checked before are written as if they had been released since
+    status = CopyToUser(process, parameters.readBytesPtr, &readBytes, sizeof(unsigned int));
+    if (FAILED(status))
+        goto clean;
+
+    if (parameters.senderPtr != nullptr)
+    {
+        status = CopyToUser(process, parameters.senderPtr, &sender, sizeof(IpcSenderInfo));
+        if (FAILED(status))
+            goto clean;
+    }
+
+    status = receiveStatus;
+
+clean:
+    context->eax = status;
+}
+
+// Test to avoid mixing output on all processes
+void SysEnterScreenCriticalSection(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    s_CriticalSection.Enter();
+}
+
+void SysLeaveScreenCriticalSection(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    s_CriticalSection.Leave();
+}
+
+void SysRaiseThreadPriority(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    thread->RaisePriorityLevel();
+}
+
+void SysLowerThreadPriority(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    thread->LowerPriorityLevel();
+}
+
+void SysIpcSendPages(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    SysIpcSendPagesParameter parameters;
+
+    status = CopyFromUser(process, &parameters, (const void *)context->ebx, sizeof(SysIpcSendPagesParameter));
+    if (FAILED(status))
+        goto clean;
+
+    status = gIpcHandler.SendPages(parameters.ipcHandle, process, parameters.buffer, parameters.size, FlagOn(parameters.flags, IPC_SEND_PAGES_KEEP_ACCESS));
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "IpcHandler::SendPages() failed with code %d (Process %d)", status, process->pid);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+}
+
+void SysIpcReceivePages(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    SysIpcReceivePagesParameter parameters;
+    char * message = nullptr;
     unsigned int size = 0;
-    Process* process = nullptr;
 
-    process = gProcessManager.GetCurrentProcess();
-    if (process == nullptr)
+    status = CopyFromUser(process, &parameters, (const void *)context->ebx, sizeof(SysIpcReceivePagesParameter));
+    if (FAILED(status))
+        goto clean;
+
+    if (FAILED(ProbeUserMemory(process, parameters.bufferPtr, sizeof(void*), true))
+        || FAILED(ProbeUserMemory(process, parameters.sizePtr, sizeof(unsigned int), true)))
     {
-        KLOG(LOG_ERROR, "GetCurrentProcess() failed !");
+        status = STATUS_INVALID_VIRTUAL_USER_ADDRESS;
         goto clean;
     }
 
-    handle = (IpcHandle)context->ebx;
-    message = (char*)context->ecx;
-    size = (unsigned int)context->edx;
+    status = gIpcHandler.ReceivePages(parameters.ipcHandle, process, &message, &size);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "IpcHandler::ReceivePages() failed with code %d (Process %d)", status, process->pid);
+        goto clean;
+    }
 
-    status = gIpcHandler.Send(handle, process, message, size);
+    // The thread may have waited for the message, the pointers checked before are written as if they had been released since
+    status = CopyToUser(process, parameters.bufferPtr, &message, sizeof(char*));
+    if (FAILED(status))
+        goto clean;
+
+    status = CopyToUser(process, parameters.sizePtr, &size, sizeof(unsigned int));
+    if (FAILED(status))
+        goto clean;
+
+    message = nullptr;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    // The message can't be given back, it is released with its pages
+    if (message != nullptr)
+        gIpcHandler.ReleaseMemory(process, message);
+
+    context->eax = status;
+}
+
+void SysIpcReleaseMemory(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+
+    status = gIpcHandler.ReleaseMemory(process, (void*)context->ebx);
     if (FAILED(status))
     {
-        KLOG(LOG_DEBUG, "IpcHandler::Send() failed with code %d (Process %d)", status, process->pid);
+        KLOG(LOG_DEBUG, "IpcHandler::ReleaseMemory() failed with code %d (Process %d)", status, process->pid);
         goto clean;
     }
 
@@ -169,70 +362,617 @@ clean:
     context->eax = status;
 }
 
-void SysIpcReceive(InterruptFromUserlandContext* context)
+/// @brief The message words are passed in ecx, edx, esi and edi
+static void GetRegisterMessage(const InterruptFromUserlandContext * const context, IpcRegisterMessage * const message)
+{
+    message->words[0] = context->ecx;
+    message->words[1] = context->edx;
+    message->words[2] = context->esi;
+    message->words[3] = context->edi;
+}
+
+static void SetRegisterMessage(InterruptFromUserlandContext * const context, const IpcRegisterMessage * const message)
+{
+    context->ecx = message->words[0];
+    context->edx = message->words[1];
+    context->esi = message->words[2];
+    context->edi = message->words[3];
+}
+
+void SysIpcCall(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
 {
     KeStatus status = STATUS_FAILURE;
-    SysIpcReceiveParameter * parameters = nullptr;
-    Process * serveurProcess = nullptr;
+    IpcRegisterMessage message;
 
-    serveurProcess = gProcessManager.GetCurrentProcess();
-    if (serveurProcess == nullptr)
+    GetRegisterMessage(context, &message);
+
+    status = gIpcHandler.Call((IpcHandle)context->ebx, thread, &message);
+    if (FAILED(status))
     {
-        KLOG(LOG_ERROR, "GetCurrentProcess() failed !");
+        KLOG(LOG_DEBUG, "IpcHandler::Call() failed with code %d (Thread %d)", status, thread->tid);
         goto clean;
     }
 
-    parameters = (SysIpcReceiveParameter*)context->ebx;
+    SetRegisterMessage(context, &message);
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+}
+
+void SysIpcReplyWait(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    IpcRegisterMessage message;
+
+    GetRegisterMessage(context, &message);
 
-    status = gIpcHandler.Receive(parameters->ipcHandle, serveurProcess, parameters->buffer, parameters->size, parameters->readBytesPtr);
+    status = gIpcHandler.ReplyWait((IpcHandle)context->ebx, thread, &message);
     if (FAILED(status))
     {
-        KLOG(LOG_DEBUG, "IpcHandler::Receive() failed with code %d (Process %d)", status, serveurProcess->pid);
+        KLOG(LOG_DEBUG, "IpcHandler::ReplyWait() failed with code %d (Thread %d)", status, thread->tid);
         goto clean;
     }
 
+    SetRegisterMessage(context, &message);
+
     status = STATUS_SUCCESS;
 
 clean:
     context->eax = status;
 }
 
-// Test to avoid mixing output on all processes 
-void SysEnterScreenCriticalSection(InterruptFromUserlandContext * context)
+void SysIpcSendV(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
 {
-    s_CriticalSection.Enter();
+    KeStatus status = STATUS_FAILURE;
+    SysIpcSendVParameter parameters;
+    IpcIoVector vectors[IPC_MAX_IO_VECTORS];
+
+    status = CopyFromUser(process, &parameters, (const void *)context->ebx, sizeof(SysIpcSendVParameter));
+    if (FAILED(status))
+        goto clean;
+
+    // The vectors are copied so that the user process can't change their sizes once they have been checked
+    status = CopyIoVectorsFromUser(process, vectors, parameters.vectors, parameters.nbVectors);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "Invalid vectors (Process %d)", process->pid);
+        goto clean;
+    }
+
+    status = gIpcHandler.SendV(parameters.ipcHandle, process, vectors, parameters.nbVectors);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "IpcHandler::SendV() failed with code %d (Process %d)", status, process->pid);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
 }
 
-void SysLeaveScreenCriticalSection(InterruptFromUserlandContext * context)
+void SysIpcChannelCreate(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
 {
-    s_CriticalSection.Leave();
+    KeStatus status = STATUS_FAILURE;
+    SysIpcChannelCreateParameter parameters;
+
+    status = CopyFromUser(process, &parameters, (const void *)context->ebx, sizeof(SysIpcChannelCreateParameter));
+    if (FAILED(status))
+        goto clean;
+
+    if (FAILED(ProbeUserMemory(process, parameters.channelHandlePtr, sizeof(IpcHandle), true))
+        || FAILED(ProbeUserMemory(process, parameters.ringPtr, sizeof(IpcChannelRing*), true)))
+    {
+        status = STATUS_INVALID_VIRTUAL_USER_ADDRESS;
+        goto clean;
+    }
+
+    status = gIpcHandler.CreateChannel(parameters.ipcHandle, process, parameters.size, parameters.channelHandlePtr, parameters.ringPtr);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "IpcHandler::CreateChannel() failed with code %d (Process %d)", status, process->pid);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
 }
 
-void SysRaiseThreadPriority(InterruptFromUserlandContext* context)
+void SysIpcChannelAccept(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
 {
-    Thread* currentThread = gThreadManager.GetCurrentThread();
-    if (currentThread == nullptr)
+    KeStatus status = STATUS_FAILURE;
+    SysIpcChannelAcceptParameter parameters;
+
+    status = CopyFromUser(process, &parameters, (const void *)context->ebx, sizeof(SysIpcChannelAcceptParameter));
+    if (FAILED(status))
+        goto clean;
+
+    if (FAILED(ProbeUserMemory(process, parameters.channelHandlePtr, sizeof(IpcHandle), true))
+        || FAILED(ProbeUserMemory(process, parameters.ringPtr, sizeof(IpcChannelRing*), true)))
     {
-        KLOG(LOG_ERROR, "ThreadManager::GetCurrentThread() returned nullptr");
-        return;
+        status = STATUS_INVALID_VIRTUAL_USER_ADDRESS;
+        goto clean;
+    }
+
+    status = gIpcHandler.AcceptChannel(parameters.ipcHandle, process, parameters.channelHandlePtr, parameters.ringPtr);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "IpcHandler::AcceptChannel() failed with code %d (Process %d)", status, process->pid);
+        goto clean;
     }
 
-    currentThread->RaisePriorityLevel();
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
 }
 
-void SysLowerThreadPriority(InterruptFromUserlandContext* context)
+void SysIpcChannelWait(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
 {
-    Thread* currentThread = gThreadManager.GetCurrentThread();
-    if (currentThread == nullptr)
+    KeStatus status = STATUS_FAILURE;
+    const u32 * word = (const u32*)context->ecx;
+
+    status = CommitUserMemory(process, word, sizeof(u32), false);
+    if (FAILED(status))
+        goto clean;
+
+    status = gIpcHandler.ChannelWait((IpcHandle)context->ebx, process, word, (u32)context->edx);
+    if (FAILED(status))
     {
-        KLOG(LOG_ERROR, "ThreadManager::GetCurrentThread() returned nullptr");
-        return;
+        KLOG(LOG_DEBUG, "IpcHandler::ChannelWait() failed with code %d (Process %d)", status, process->pid);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+}
+
+void SysIpcChannelWake(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+
+    status = gIpcHandler.ChannelWake((IpcHandle)context->ebx, process);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "IpcHandler::ChannelWake() failed with code %d (Process %d)", status, process->pid);
+        goto clean;
     }
 
-    currentThread->LowerPriorityLevel();
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+}
+
+void SysIpcChannelClose(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+
+    status = gIpcHandler.CloseChannel((IpcHandle)context->ebx, process);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "IpcHandler::CloseChannel() failed with code %d (Process %d)", status, process->pid);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+}
+
+void SysIpcServerDisconnect(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+
+    status = gIpcHandler.Disconnect((IpcHandle)context->ebx, process);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "IpcHandler::Disconnect() failed with code %d (Process %d)", status, process->pid);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+}
+
+void SysIoRingSetup(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    IoRingQueues ** queues = (IoRingQueues**)context->ebx;
+
+    status = ProbeUserMemory(process, queues, sizeof(IoRingQueues*), true);
+    if (FAILED(status))
+        goto clean;
+
+    status = IoRingHandler::Setup(process, queues);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "IoRingHandler::Setup() failed with code %d (Process %d)", status, process->pid);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+}
+
+void SysIoRingEnter(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    unsigned int nbExecuted = 0;
+
+    status = IoRingHandler::Enter(process, (unsigned int)context->ebx, &nbExecuted);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "IoRingHandler::Enter() failed with code %d (Process %d)", status, process->pid);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+    context->ebx = nbExecuted;
+}
+
+void SysIpcWaitMultiple(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    SysIpcWaitMultipleParameter parameters;
+    IpcWaitEntry entries[IPC_WAIT_MAX_ENTRIES];
+    unsigned int nbReady = 0;
+
+    status = CopyFromUser(process, &parameters, (const void *)context->ebx, sizeof(SysIpcWaitMultipleParameter));
+    if (FAILED(status))
+        goto clean;
+
+    if (parameters.nbEntries == 0 || parameters.nbEntries > IPC_WAIT_MAX_ENTRIES)
+    {
+        KLOG(LOG_DEBUG, "Invalid wait entries (Process %d)", process->pid);
+        status = STATUS_INVALID_PARAMETER;
+        goto clean;
+    }
+
+    // The entries are copied so that the user process can't change them while the thread waits
+    status = CopyFromUser(process, entries, parameters.entries, parameters.nbEntries * sizeof(IpcWaitEntry));
+    if (FAILED(status))
+        goto clean;
+
+    status = gIpcHandler.WaitMultiple(process, entries, parameters.nbEntries, &nbReady);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "IpcHandler::WaitMultiple() failed with code %d (Process %d)", status, process->pid);
+        goto clean;
+    }
+
+    // The process may have released its buffers while the thread was waiting, they are checked again
+    status = CopyToUser(process, parameters.entries, entries, parameters.nbEntries * sizeof(IpcWaitEntry));
+    if (FAILED(status))
+        goto clean;
+
+    status = CopyToUser(process, parameters.nbReadyPtr, &nbReady, sizeof(unsigned int));
+    if (FAILED(status))
+        goto clean;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+}
+
+void SysSyscallStats(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    SysSyscallStatsParameter parameters;
+    unsigned int count = 0;
+
+    status = CopyFromUser(process, &parameters, (const void *)context->ebx, sizeof(SysSyscallStatsParameter));
+    if (FAILED(status))
+        goto clean;
+
+    // No more entries or records than there are can be copied, the buffer size is checked against that
+    if (parameters.operation == SYSCALL_STATS_GET && parameters.size > SYS_INVALID)
+        parameters.size = SYS_INVALID;
+    else if (parameters.operation == SYSCALL_TRACE_READ && parameters.size > SYSCALL_TRACE_ENTRIES)
+        parameters.size = SYSCALL_TRACE_ENTRIES;
+
+    switch (parameters.operation)
+    {
+    case SYSCALL_STATS_GET:
+        status = CommitUserMemory(process, parameters.buffer, parameters.size * sizeof(SyscallStatsEntry), true);
+        if (!FAILED(status))
+            status = gSyscallsStats.GetStats((SyscallStatsEntry*)parameters.buffer, parameters.size, &count);
+        break;
+    case SYSCALL_STATS_RESET:
+        gSyscallsStats.Reset();
+        status = STATUS_SUCCESS;
+        break;
+    case SYSCALL_TRACE_START:
+        status = gSyscallsStats.StartTrace(process);
+        break;
+    case SYSCALL_TRACE_STOP:
+        gSyscallsStats.StopTrace(process);
+        status = STATUS_SUCCESS;
+        break;
+    case SYSCALL_TRACE_READ:
+        status = CommitUserMemory(process, parameters.buffer, parameters.size * sizeof(SyscallTraceRecord), true);
+        if (!FAILED(status))
+            status = gSyscallsStats.ReadTrace(process, (SyscallTraceRecord*)parameters.buffer, parameters.size, &count);
+        break;
+    default:
+        KLOG(LOG_DEBUG, "Invalid syscall stats operation %d (Process %d)", parameters.operation, process->pid);
+        status = STATUS_INVALID_PARAMETER;
+    }
+
+    if (FAILED(status))
+        goto clean;
+
+    if (parameters.countPtr != nullptr)
+    {
+        status = CopyToUser(process, parameters.countPtr, &count, sizeof(unsigned int));
+        if (FAILED(status))
+            goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+}
+
+void SysSpawn(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    u32 entryAddr = (u32)context->ebx;
+    u32 argument = (u32)context->ecx;
+    int * pidPtr = (int*)context->edx;
+    Process * newProcess = nullptr;
+
+    // The entry is run in the clone of the caller memory, it must be in a reserved vad
+    status = ProbeUserMemory(process, (void*)entryAddr, 1, false);
+    if (FAILED(status))
+        goto clean;
+
+    if (pidPtr != nullptr)
+    {
+        status = ProbeUserMemory(process, pidPtr, sizeof(int), true);
+        if (FAILED(status))
+            goto clean;
+    }
+
+    // The new process has the same privileges than its template
+    status = gProcessManager.SpawnProcess(process, entryAddr, argument, FlagOn(thread->regs.eflags, EFLAGS_IOPL_MASK) ? SA_IO : SA_NONE, &newProcess);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "ProcessManager::SpawnProcess() failed with code %t (Process %d)", status, process->pid);
+        goto clean;
+    }
+
+    gScheduler.AddThread(newProcess->mainThread);
+
+    if (pidPtr != nullptr)
+    {
+        status = CopyToUser(process, pidPtr, &newProcess->pid, sizeof(int));
+        if (FAILED(status))
+            goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+}
+
+void SysMapLargePages(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    unsigned int size = (unsigned int)context->ebx;
+    void ** addressPtr = (void**)context->ecx;
+    void * address = nullptr;
+
+    status = ProbeUserMemory(process, addressPtr, sizeof(void*), true);
+    if (FAILED(status))
+        goto clean;
+
+    status = process->AllocateLargePages(size, &address);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "Process::AllocateLargePages() failed with code %t (Process %d)", status, process->pid);
+        goto clean;
+    }
+
+    // The process may unmap it
+    status = process->SetMemoryOrigin(address, VAD_ORIGIN_MAP_LARGE_PAGES);
+    if (FAILED(status))
+    {
+        process->ReleaseMemory(address);
+        goto clean;
+    }
+
+    status = CopyToUser(process, addressPtr, &address, sizeof(void*));
+    if (FAILED(status))
+    {
+        process->ReleaseMemory(address);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+}
+
+/// @brief The mapping is only reserved, its pages are committed on the first access by the page fault handler
+void SysMapAnonymous(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    unsigned int size = (unsigned int)context->ebx;
+    unsigned int protection = (unsigned int)context->ecx;
+    void ** addressPtr = (void**)context->edx;
+    void * address = nullptr;
+
+    if (protection != MEMORY_PROTECTION_READ_ONLY && protection != MEMORY_PROTECTION_READ_WRITE)
+    {
+        status = STATUS_INVALID_PARAMETER;
+        goto clean;
+    }
+
+    status = ProbeUserMemory(process, addressPtr, sizeof(void*), true);
+    if (FAILED(status))
+        goto clean;
+
+    status = process->AllocateMemory((size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1), false, &address);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "Process::AllocateMemory() failed with code %t (Process %d)", status, process->pid);
+        goto clean;
+    }
+
+    // The process may unmap it and change its protection
+    status = process->SetMemoryOrigin(address, VAD_ORIGIN_MAP_ANONYMOUS);
+    if (FAILED(status))
+    {
+        process->ReleaseMemory(address);
+        goto clean;
+    }
+
+    if (protection == MEMORY_PROTECTION_READ_ONLY)
+    {
+        status = process->ProtectMemory(address, false);
+        if (FAILED(status))
+        {
+            process->ReleaseMemory(address);
+            goto clean;
+        }
+    }
+
+    status = CopyToUser(process, addressPtr, &address, sizeof(void*));
+    if (FAILED(status))
+    {
+        process->ReleaseMemory(address);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+}
+
+void SysUnmap(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    VadOrigin origin = VAD_ORIGIN_KERNEL;
+
+    status = process->GetMemoryOrigin((void*)context->ebx, &origin);
+    if (FAILED(status))
+        goto clean;
+
+    // The image, the stacks, the heap and the ipc rings are managed by the kernel
+    if (origin == VAD_ORIGIN_KERNEL)
+    {
+        KLOG(LOG_DEBUG, "%x wasn't mapped by the process (Process %d)", context->ebx, process->pid);
+        status = STATUS_ACCESS_DENIED;
+        goto clean;
+    }
+
+    status = process->ReleaseMemory((void*)context->ebx);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "Process::ReleaseMemory() failed with code %t (Process %d)", status, process->pid);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+}
+
+void SysProtect(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    unsigned int protection = (unsigned int)context->ecx;
+
+    if (protection != MEMORY_PROTECTION_READ_ONLY && protection != MEMORY_PROTECTION_READ_WRITE)
+    {
+        status = STATUS_INVALID_PARAMETER;
+        goto clean;
+    }
+
+    status = process->ProtectMemory((void*)context->ebx, protection == MEMORY_PROTECTION_READ_WRITE);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "Process::ProtectMemory() failed with code %t (Process %d)", status, process->pid);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
+}
+
+void SysMemoryStats(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    SysMemoryStatsParameter parameters;
+    ProcessMemoryStats stats;
+
+    status = CopyFromUser(process, &parameters, (const void *)context->ebx, sizeof(SysMemoryStatsParameter));
+    if (FAILED(status))
+        goto clean;
+
+    switch (parameters.operation)
+    {
+    case MEMORY_STATS_GET:
+        if (parameters.pid == MEMORY_STATS_CURRENT_PROCESS)
+        {
+            process->GetMemoryStats(&stats);
+            status = STATUS_SUCCESS;
+        }
+        else
+        {
+            status = gProcessManager.GetProcessMemoryStats((int)parameters.pid, &stats);
+        }
+
+        if (!FAILED(status))
+            status = CopyToUser(process, parameters.statsPtr, &stats, sizeof(ProcessMemoryStats));
+        break;
+    case MEMORY_STATS_SET_LIMITS:
+        status = CopyFromUser(process, &stats, parameters.statsPtr, sizeof(ProcessMemoryStats));
+        if (!FAILED(status))
+        {
+            process->memoryCounters.residentPagesLimit = stats.residentPagesLimit;
+            process->memoryCounters.committedBytesLimit = stats.committedBytesLimit;
+        }
+        break;
+    default:
+        KLOG(LOG_DEBUG, "Invalid memory stats operation %d (Process %d)", parameters.operation, process->pid);
+        status = STATUS_INVALID_PARAMETER;
+    }
+
+    if (FAILED(status))
+        goto clean;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    context->eax = status;
 }
 
-void SysInvalid(InterruptFromUserlandContext * context)
+void SysInvalid(InterruptFromUserlandContext * context, Thread * const thread, Process * const process)
 {
     KLOG(LOG_ERROR, "Invalid syscall called");
 }
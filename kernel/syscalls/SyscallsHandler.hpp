@@ -1,6 +1,8 @@
 #pragma once
 
 #include <kernel/arch/x86/InterruptContext.hpp>
+#include <kernel/arch/x86/Thread.hpp>
+#include <kernel/arch/x86/Process.hpp>
 #include <kernel/lib/StdIo.hpp>
 
 #include "SyscallsList.hpp"
@@ -20,12 +22,15 @@ enum SyscallId
 #undef SYSCALL_ID
 };
 
+/// @brief Syscall handler, the calling thread and its process are looked up once by the dispatcher
+typedef void (*SyscallFunction)(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+
 /// @brief Class used to execute syscalls
 class SyscallsHandler
 {
 public:
     /// @brief Executes a syscall
-    ///        Its body is build using the syscalls list defined in SyscallsList.hpp
+    ///        The handler is found in a table built using the syscalls list defined in SyscallsList.hpp
     /// @param[in] sysId The syscall id we want to execute
     /// @param[in] context A pointer to the syscall trap context
     static void ExecuteSyscall(const SyscallId sysId, InterruptFromUserlandContext * context);
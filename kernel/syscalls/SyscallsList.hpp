@@ -6,7 +6,9 @@
 /// @{
 
 /// @brief This file contains the syscalls list
-///        To add a syscall, add it to the SYSCALLS_LIST list define, and the function signature with the others
+///        To add a syscall, add it to the SYSCALLS_LIST list define, and the function signature with the others.
+///        A handler receives the calling thread and its process, and must check the user pointers it is given
+///        with the functions of UserMemory.hpp before using them
 
 #define SYSCALLS_LIST                                                          \
     SYSCALL (SYS_PRINT_CHAR,                    SysPrintChar)                  \
@@ -20,27 +22,71 @@
     SYSCALL (SYS_LEAVE_SCREEN_CRITICAL_SECTION, SysLeaveScreenCriticalSection) \
     SYSCALL (SYS_RAISE_THREAD_PRIORITY,         SysRaiseThreadPriority)        \
     SYSCALL (SYS_LOWER_THREAD_PRIORITY,         SysLowerThreadPriority)        \
+    SYSCALL (SYS_IPC_SEND_PAGES,                SysIpcSendPages)               \
+    SYSCALL (SYS_IPC_RECV_PAGES,                SysIpcReceivePages)            \
+    SYSCALL (SYS_IPC_RELEASE_MEMORY,            SysIpcReleaseMemory)           \
+    SYSCALL (SYS_IPC_CALL,                      SysIpcCall)                    \
+    SYSCALL (SYS_IPC_REPLY_WAIT,                SysIpcReplyWait)               \
+    SYSCALL (SYS_IPC_SEND_V,                    SysIpcSendV)                   \
+    SYSCALL (SYS_IPC_CHANNEL_CREATE,            SysIpcChannelCreate)           \
+    SYSCALL (SYS_IPC_CHANNEL_ACCEPT,            SysIpcChannelAccept)           \
+    SYSCALL (SYS_IPC_CHANNEL_WAIT,              SysIpcChannelWait)             \
+    SYSCALL (SYS_IPC_CHANNEL_WAKE,              SysIpcChannelWake)             \
+    SYSCALL (SYS_IO_RING_SETUP,                 SysIoRingSetup)                \
+    SYSCALL (SYS_IO_RING_ENTER,                 SysIoRingEnter)                \
+    SYSCALL (SYS_IPC_WAIT_MULTIPLE,             SysIpcWaitMultiple)            \
+    SYSCALL (SYS_SYSCALL_STATS,                 SysSyscallStats)               \
+    SYSCALL (SYS_SPAWN,                         SysSpawn)                      \
+    SYSCALL (SYS_MAP_LARGE_PAGES,               SysMapLargePages)              \
+    SYSCALL (SYS_MAP_ANONYMOUS,                 SysMapAnonymous)               \
+    SYSCALL (SYS_UNMAP,                         SysUnmap)                      \
+    SYSCALL (SYS_PROTECT,                       SysProtect)                    \
+    SYSCALL (SYS_MEMORY_STATS,                  SysMemoryStats)                \
+    SYSCALL (SYS_IPC_CHANNEL_CLOSE,             SysIpcChannelClose)            \
+    SYSCALL (SYS_IPC_SERVER_DISCONNECT,         SysIpcServerDisconnect)        \
     SYSCALL (SYS_INVALID,            SysInvalid)
 
 
 /*
     SYSCALLS Begin
 */
-void SysPrintChar(InterruptFromUserlandContext * context);
-void SysPrintStr(InterruptFromUserlandContext * context);
+void SysPrintChar(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysPrintStr(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
 
-void SysSbrk(InterruptFromUserlandContext * context);
+void SysSbrk(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
 
-void SysIpcServerCreate(InterruptFromUserlandContext* context);
-void SysIpcServerConnect(InterruptFromUserlandContext* context);
-void SysIpcSend(InterruptFromUserlandContext* context);
-void SysIpcReceive(InterruptFromUserlandContext* context);
-void SysEnterScreenCriticalSection(InterruptFromUserlandContext* context);
-void SysLeaveScreenCriticalSection(InterruptFromUserlandContext* context);
-void SysRaiseThreadPriority(InterruptFromUserlandContext* context);
-void SysLowerThreadPriority(InterruptFromUserlandContext* context);
+void SysIpcServerCreate(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcServerConnect(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcSend(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcReceive(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysEnterScreenCriticalSection(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysLeaveScreenCriticalSection(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysRaiseThreadPriority(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysLowerThreadPriority(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcSendPages(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcReceivePages(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcReleaseMemory(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcCall(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcReplyWait(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcSendV(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcChannelCreate(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcChannelAccept(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcChannelWait(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcChannelWake(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIoRingSetup(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIoRingEnter(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcWaitMultiple(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysSyscallStats(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysSpawn(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysMapLargePages(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysMapAnonymous(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysUnmap(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysProtect(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysMemoryStats(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcChannelClose(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
+void SysIpcServerDisconnect(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
 
-void SysInvalid(InterruptFromUserlandContext * context);
+void SysInvalid(InterruptFromUserlandContext * context, Thread * const thread, Process * const process);
 /*
     SYSCALLS End
 */
@@ -0,0 +1,232 @@
+#define __SYSCALLS_STATS__
+#include "SyscallsStats.hpp"
+
+#include <kernel/lib/StdLib.hpp>
+#include <kernel/lib/StdMem.hpp>
+
+#include <kernel/Logger.hpp>
+#define KLOG(LOG_LEVEL, format, ...) KLOGGER("SYSCALLS", LOG_LEVEL, format, ##__VA_ARGS__)
+
+/// @brief Returns the histogram bucket of a duration, the index of its highest bit shifted by SYSCALL_STATS_HISTOGRAM_SHIFT
+static u32 GetHistogramBucket(const u32 cycles)
+{
+    u32 highestBit = 0;
+
+    if (cycles == 0)
+        return 0;
+
+    asm("bsr %1, %0" : "=r"(highestBit) : "r"(cycles));
+
+    if (highestBit <= SYSCALL_STATS_HISTOGRAM_SHIFT)
+        return 0;
+
+    highestBit -= SYSCALL_STATS_HISTOGRAM_SHIFT;
+
+    return (highestBit < SYSCALL_STATS_HISTOGRAM_BUCKETS) ? highestBit : SYSCALL_STATS_HISTOGRAM_BUCKETS - 1;
+}
+
+void SyscallsStats::Init()
+{
+    _criticalSection = CriticalSection();
+
+    MemSet(_entries, 0, sizeof(_entries));
+}
+
+void SyscallsStats::Record(const SyscallId sysId, Process * const process, const u32 * const args, const u32 result, const u32 cycles)
+{
+    SyscallStatsEntry * entry = nullptr;
+    SyscallTrace * trace = nullptr;
+
+    if (sysId >= SYS_INVALID)
+        return;
+
+    _criticalSection.Enter();
+
+    entry = &_entries[sysId];
+    entry->count++;
+    entry->totalCycles += cycles;
+    entry->histogram[GetHistogramBucket(cycles)]++;
+
+    if (cycles > entry->maxCycles)
+        entry->maxCycles = cycles;
+
+    trace = (process != nullptr) ? process->syscallTrace : nullptr;
+    if (trace != nullptr)
+    {
+        SyscallTraceRecord * record = &trace->records[(trace->first + trace->nbRecords) % SYSCALL_TRACE_ENTRIES];
+
+        // The trace is full, the oldest record is overwritten
+        if (trace->nbRecords == SYSCALL_TRACE_ENTRIES)
+            trace->first = (trace->first + 1) % SYSCALL_TRACE_ENTRIES;
+        else
+            trace->nbRecords++;
+
+        record->id = sysId;
+        record->args[0] = args[0];
+        record->args[1] = args[1];
+        record->args[2] = args[2];
+        record->result = result;
+        record->cycles = cycles;
+    }
+
+    _criticalSection.Leave();
+}
+
+KeStatus SyscallsStats::GetStats(SyscallStatsEntry * const entries, const unsigned int nbEntries, unsigned int * const nbCopied)
+{
+    const unsigned int nbToCopy = (nbEntries < SYS_INVALID) ? nbEntries : SYS_INVALID;
+
+    if (entries == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid entries parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (nbCopied == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid nbCopied parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    _criticalSection.Enter();
+
+    MemCopy(_entries, entries, nbToCopy * sizeof(SyscallStatsEntry));
+
+    _criticalSection.Leave();
+
+    *nbCopied = nbToCopy;
+
+    return STATUS_SUCCESS;
+}
+
+void SyscallsStats::Reset()
+{
+    _criticalSection.Enter();
+
+    MemSet(_entries, 0, sizeof(_entries));
+
+    _criticalSection.Leave();
+}
+
+KeStatus SyscallsStats::StartTrace(Process * const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    SyscallTrace * trace = nullptr;
+
+    if (process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid process parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (process->syscallTrace != nullptr)
+        return STATUS_HANDLE_ALREADY_EXIST;
+
+    trace = (SyscallTrace*)HeapAlloc(sizeof(SyscallTrace));
+    if (trace == nullptr)
+    {
+        KLOG(LOG_ERROR, "Couldn't allocate %d bytes", sizeof(SyscallTrace));
+        return STATUS_ALLOC_FAILED;
+    }
+
+    trace->first = 0;
+    trace->nbRecords = 0;
+
+    _criticalSection.Enter();
+
+    // Another thread of the process may have started the trace meanwhile
+    if (process->syscallTrace == nullptr)
+    {
+        process->syscallTrace = trace;
+        trace = nullptr;
+        status = STATUS_SUCCESS;
+    }
+    else
+    {
+        status = STATUS_HANDLE_ALREADY_EXIST;
+    }
+
+    _criticalSection.Leave();
+
+    if (trace != nullptr)
+        HeapFree(trace);
+
+    return status;
+}
+
+void SyscallsStats::StopTrace(Process * const process)
+{
+    SyscallTrace * trace = nullptr;
+
+    if (process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid process parameter");
+        return;
+    }
+
+    _criticalSection.Enter();
+
+    trace = process->syscallTrace;
+    process->syscallTrace = nullptr;
+
+    _criticalSection.Leave();
+
+    if (trace != nullptr)
+        HeapFree(trace);
+}
+
+const SyscallStatsEntry * SyscallsStats::GetEntriesUnsafe() const
+{
+    return _entries;
+}
+
+KeStatus SyscallsStats::ReadTrace(Process * const process, SyscallTraceRecord * const records, const unsigned int nbRecords, unsigned int * const nbRead)
+{
+    KeStatus status = STATUS_FAILURE;
+    SyscallTrace * trace = nullptr;
+    unsigned int index = 0;
+
+    if (process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid process parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (records == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid records parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (nbRead == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid nbRead parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    _criticalSection.Enter();
+
+    trace = process->syscallTrace;
+    if (trace == nullptr)
+    {
+        status = STATUS_NOT_FOUND;
+        goto clean;
+    }
+
+    while (index < nbRecords && trace->nbRecords > 0)
+    {
+        records[index++] = trace->records[trace->first];
+
+        trace->first = (trace->first + 1) % SYSCALL_TRACE_ENTRIES;
+        trace->nbRecords--;
+    }
+
+    *nbRead = index;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    _criticalSection.Leave();
+
+    return status;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <kernel/lib/Status.hpp>
+#include <kernel/lib/Types.hpp>
+#include <kernel/lib/CriticalSection.hpp>
+#include <kernel/arch/x86/Process.hpp>
+
+#include "SyscallsHandler.hpp"
+#include "UKSyscallsCommon.h"
+
+/// @file
+
+/// @addgroup Syscalls
+/// @{
+
+/// @brief Records kept for a traced process, see SyscallsStats::StartTrace()
+struct SyscallTrace
+{
+    SyscallTraceRecord records[SYSCALL_TRACE_ENTRIES];
+    /// @brief Index of the oldest record
+    u32 first;
+    u32 nbRecords;
+};
+
+/// @brief Counts the syscalls and their duration, so that we can see where the services spend their time.
+///        The processes that asked for it also get a trace of their last syscalls.
+class SyscallsStats
+{
+public:
+    void Init();
+
+    /// @brief Accounts a syscall, called by SyscallsHandler::ExecuteSyscall() once the syscall returned
+    /// @param[in] sysId The syscall id
+    /// @param[in] process The process that made the syscall, its trace is updated if it has one
+    /// @param[in] args ebx, ecx and edx when the syscall was made
+    /// @param[in] result eax when the syscall returned
+    /// @param[in] cycles The syscall duration
+    void Record(const SyscallId sysId, Process * const process, const u32 * const args, const u32 result, const u32 cycles);
+
+    /// @brief Copies the syscalls counters
+    /// @param[out] entries Array that will hold the counters, indexed by syscall id
+    /// @param[in]  nbEntries Number of entries of the array
+    /// @param[out] nbCopied Pointer that will hold the number of entries copied
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus GetStats(SyscallStatsEntry * const entries, const unsigned int nbEntries, unsigned int * const nbCopied);
+
+    /// @brief Clears every counter
+    void Reset();
+
+    /// @brief Starts recording the syscalls of a process
+    /// @return STATUS_SUCCESS on success, STATUS_HANDLE_ALREADY_EXIST if the process is already traced, an error code otherwise
+    KeStatus StartTrace(Process * const process);
+
+    /// @brief Stops recording the syscalls of a process and drops its records
+    void StopTrace(Process * const process);
+
+    /// @brief Moves the oldest records of a process trace
+    /// @param[in]  process The traced process
+    /// @param[out] records Array that will hold the records, oldest first
+    /// @param[in]  nbRecords Number of records of the array
+    /// @param[out] nbRead Pointer that will hold the number of records moved
+    /// @return STATUS_SUCCESS on success, STATUS_NOT_FOUND if the process is not traced, an error code otherwise
+    KeStatus ReadTrace(Process * const process, SyscallTraceRecord * const records, const unsigned int nbRecords, unsigned int * const nbRead);
+
+    /// @brief Gives the counters without taking the lock, for the debugger : the kernel is stopped and the
+    ///        interrupted code may hold it. An entry may be read in the middle of its update.
+    /// @return An array of SYS_INVALID entries, indexed by syscall id
+    const SyscallStatsEntry * GetEntriesUnsafe() const;
+
+private:
+    SyscallStatsEntry _entries[SYS_INVALID];
+    CriticalSection _criticalSection;
+};
+
+#ifdef __SYSCALLS_STATS__
+SyscallsStats gSyscallsStats;
+#else
+extern SyscallsStats gSyscallsStats;
+#endif
+
+/// @}
@@ -7,12 +7,330 @@
 
 /// @brief This file may be include by user AND kernel code
 
+/// @brief The low bits of a client handle are an index lower than IPC_CLIENT_INDEX_COUNT, unique among the clients
+///        connected at the same time, so that a server can use it to index its clients state
+#define IPC_CLIENT_INDEX_COUNT 0x1000
+#define IPC_CLIENT_INDEX(clientHandle) ((clientHandle) & (IPC_CLIENT_INDEX_COUNT - 1))
+
+/// @brief Identity of the client that sent a message, stamped by the kernel
+struct IpcSenderInfo
+{
+    /// @brief Id of the sender process
+    unsigned int pid;
+    /// @brief Handle identifying the sender among the clients of the server, the same for all its messages
+    unsigned int clientHandle;
+};
+
 struct SysIpcReceiveParameter
 {
     unsigned int ipcHandle;
     char * buffer;
     unsigned int size;
     unsigned int * readBytesPtr;
+    /// @brief Optional, nullptr if the server doesn't need the sender identity
+    IpcSenderInfo * senderPtr;
+};
+
+/// @brief Maximum size in bytes of a message sent through the copy ipc, headers excluded
+#define IPC_MAX_MESSAGE_SIZE 0x8000
+
+/// @brief Maximum number of buffers gathered in a single message by the vectored send syscall
+#define IPC_MAX_IO_VECTORS 8
+
+/// @brief One of the buffers gathered in a message, in the sender address space
+struct IpcIoVector
+{
+    const char * buffer;
+    unsigned int size;
+};
+
+struct SysIpcSendVParameter
+{
+    unsigned int ipcHandle;
+    const IpcIoVector * vectors;
+    unsigned int nbVectors;
+};
+
+/// @brief Size of the pages exchanged by the ipc pages syscalls, a pages message must be aligned on it
+#define IPC_PAGE_SIZE 0x1000
+
+/// @brief The message pages are moved to the server, the client loses their content
+#define IPC_SEND_PAGES_MOVE        0
+/// @brief The message pages are shared with the server (copy-on-write), the client keeps their content
+#define IPC_SEND_PAGES_KEEP_ACCESS 1
+
+struct SysIpcSendPagesParameter
+{
+    unsigned int ipcHandle;
+    char * buffer;
+    unsigned int size;
+    unsigned int flags;
+};
+
+struct SysIpcReceivePagesParameter
+{
+    unsigned int ipcHandle;
+    char ** bufferPtr;
+    unsigned int * sizePtr;
+};
+
+/// @brief Number of 32 bits words of a message passed in registers (ecx, edx, esi, edi) by the ipc call and reply syscalls
+#define IPC_REGISTER_MESSAGE_WORDS 4
+
+struct IpcRegisterMessage
+{
+    unsigned int words[IPC_REGISTER_MESSAGE_WORDS];
+};
+
+/// @brief Maximum size in bytes of the data ring of a channel
+#define IPC_CHANNEL_MAX_SIZE 0x100000
+
+/// @brief First page of the memory shared by the producer and the consumer of a channel, the data ring starts on the next page.
+///        head and tail count the bytes written and read since the channel creation, they are kept on different cache lines.
+struct IpcChannelRing
+{
+    /// @brief Only written by the producer
+    volatile unsigned int head;
+    unsigned int headPadding[15];
+    /// @brief Only written by the consumer
+    volatile unsigned int tail;
+    unsigned int tailPadding[15];
+    /// @brief Set by a side before waiting in the kernel, so that the other one knows it must wake it up
+    volatile unsigned int producerWaiting;
+    volatile unsigned int consumerWaiting;
+    /// @brief Size in bytes of the data ring, a power of two
+    unsigned int size;
+    /// @brief Set by the kernel when a side closes the channel, the other side then stops waiting for it
+    volatile unsigned int closed;
+};
+
+struct SysIpcChannelCreateParameter
+{
+    unsigned int ipcHandle;
+    unsigned int size;
+    unsigned int * channelHandlePtr;
+    IpcChannelRing ** ringPtr;
+};
+
+struct SysIpcChannelAcceptParameter
+{
+    unsigned int ipcHandle;
+    unsigned int * channelHandlePtr;
+    IpcChannelRing ** ringPtr;
+};
+
+/// @brief Maximum number of handles waited on at once by the wait multiple syscall
+#define IPC_WAIT_MAX_ENTRIES 16
+
+/// @brief Readiness events of an ipc server handle, only its server process can wait on them
+#define IPC_WAIT_MESSAGE          0x1 ///< A message can be received with the copy ipc
+#define IPC_WAIT_PAGES_MESSAGE    0x2 ///< A pages message can be received
+#define IPC_WAIT_CHANNEL_PENDING  0x4 ///< A channel can be accepted
+/// @brief Readiness events of a channel handle, for the consumer and the producer respectively
+#define IPC_WAIT_CHANNEL_READABLE 0x8  ///< The ring holds bytes to read
+#define IPC_WAIT_CHANNEL_WRITABLE 0x10 ///< The ring has room to write
+
+struct IpcWaitEntry
+{
+    unsigned int handle;
+    /// @brief The IPC_WAIT_* events the caller waits for
+    unsigned int events;
+    /// @brief Set by the kernel, the events that are ready among the waited ones
+    unsigned int readyEvents;
+};
+
+struct SysIpcWaitMultipleParameter
+{
+    IpcWaitEntry * entries;
+    unsigned int nbEntries;
+    unsigned int * nbReadyPtr;
+};
+
+/// @brief Number of entries of the submission queue and of the completion queue of an io ring, a power of two
+#define IO_RING_ENTRIES 64
+
+/// @brief Operations that can be submitted to an io ring, each one behaves as the syscall of the same name
+enum IoRingOpcode
+{
+    /// @brief Does nothing, only posts a completion
+    IO_RING_OP_NOP,
+    /// @brief buffer and size describe the message sent to the ipc server handle
+    IO_RING_OP_IPC_SEND,
+    /// @brief buffer points to an IpcIoVector array, size is the number of vectors
+    IO_RING_OP_IPC_SEND_V,
+    /// @brief buffer and size describe the receive buffer, the message size is the completion result
+    IO_RING_OP_IPC_RECV,
+    /// @brief handle is a channel handle, buffer points to the ring word to watch and value is its expected value
+    IO_RING_OP_IPC_CHANNEL_WAIT,
+    /// @brief handle is a channel handle
+    IO_RING_OP_IPC_CHANNEL_WAKE,
+    IO_RING_OP_MAX
+};
+
+struct IoRingSubmission
+{
+    unsigned int opcode;
+    unsigned int handle;
+    void * buffer;
+    unsigned int size;
+    unsigned int value;
+    /// @brief Copied as is in the completion, so that the process can match it with its submission
+    unsigned int userData;
+};
+
+struct IoRingCompletion
+{
+    unsigned int userData;
+    /// @brief The operation status
+    unsigned int status;
+    /// @brief The operation result, if it has one
+    unsigned int result;
+};
+
+/// @brief Submission and completion queues shared by a process and the kernel.
+///        The process writes submissions and moves submissionTail, the kernel consumes them and moves submissionHead.
+///        The kernel writes completions and moves completionTail, the process consumes them and moves completionHead.
+///        The counters are never wrapped, an entry index is its counter modulo IO_RING_ENTRIES.
+struct IoRingQueues
+{
+    volatile unsigned int submissionHead;
+    volatile unsigned int submissionTail;
+    volatile unsigned int completionHead;
+    volatile unsigned int completionTail;
+    IoRingSubmission submissions[IO_RING_ENTRIES];
+    IoRingCompletion completions[IO_RING_ENTRIES];
+};
+
+/// @brief User address of the kernel shared data page, mapped read-only in every process.
+///        It is the last page below the page tables window at the top of the address space.
+#define USER_SHARED_DATA_ADDR 0xFFBFF000
+
+/// @brief Data the kernel publishes in every process address space, so that reading it doesn't need a syscall.
+///        The kernel is the only writer : sequence is odd while an update is in progress, readers must read
+///        the same even sequence before and after the fields they use, or try again.
+struct KernelSharedData
+{
+    volatile unsigned int sequence;
+
+    /// @brief Clock ticks since boot
+    volatile unsigned int ticks;
+    /// @brief Monotonic time since boot
+    volatile unsigned int seconds;
+    volatile unsigned int milliseconds;
+
+    /// @brief Running process and thread, updated each time a thread is resumed.
+    ///        There is a single processor, so they always describe the thread that reads them.
+    volatile unsigned int currentPid;
+    volatile unsigned int currentTid;
+
+    /// @brief Scheduler hints : number of threads the scheduler knows about, priority of the running thread,
+    ///        value of ticks when it was resumed and number of ticks it may run before being preempted
+    volatile unsigned int nbThreads;
+    volatile unsigned int threadPriority;
+    volatile unsigned int sliceStartTicks;
+    volatile unsigned int sliceTicks;
+
+    /// @brief 1 if the kernel set the sysenter entry up, 0 if syscalls must go through the interrupt gate.
+    ///        It is written once at boot. syscalls.asm reads it at offset SHARED_DATA_FAST_ENTRY_OFFSET.
+    volatile unsigned int fastSyscallEntry;
+};
+
+/// @brief Protections of the memory mapped by the map anonymous and protect syscalls, a mapped page can always be read
+#define MEMORY_PROTECTION_READ_ONLY  0
+#define MEMORY_PROTECTION_READ_WRITE 1
+
+/// @brief Memory used by a process. Its resident pages include the pages it shares with other processes
+///        (module image, copy-on-write pages of a spawned process), they are counted by each of them.
+struct ProcessMemoryStats
+{
+    unsigned int pid;
+    /// @brief Number of user pages backed by physical memory, and the highest number seen
+    unsigned int residentPages;
+    unsigned int peakResidentPages;
+    /// @brief Bytes of the reserved memory areas, and the part of them not backed by physical memory yet
+    unsigned int committedBytes;
+    unsigned int untouchedBytes;
+    /// @brief Number of page tables allocated for the process user space
+    unsigned int pageTablePages;
+    /// @brief Kernel heap bytes of the structures describing the process (process, threads, memory areas, syscall trace)
+    unsigned int kernelHeapBytes;
+    /// @brief Limits of the process, 0 if unlimited
+    unsigned int residentPagesLimit;
+    unsigned int committedBytesLimit;
+};
+
+/// @brief Process id designating the calling process in the memory stats syscall
+#define MEMORY_STATS_CURRENT_PROCESS 0xFFFFFFFF
+
+enum MemoryStatsOperation
+{
+    /// @brief Copies the memory stats of the process pid in statsPtr
+    MEMORY_STATS_GET,
+    /// @brief Sets the limits of the calling process to residentPagesLimit and committedBytesLimit of statsPtr, pid is ignored.
+    ///        An allocation or a page fault that would exceed them fails with STATUS_PROCESS_MEMORY_LIMIT_REACHED,
+    ///        the processes spawned afterwards inherit them.
+    MEMORY_STATS_SET_LIMITS
+};
+
+struct SysMemoryStatsParameter
+{
+    unsigned int operation;
+    unsigned int pid;
+    ProcessMemoryStats * statsPtr;
+};
+
+/// @brief Number of buckets of a syscall duration histogram
+#define SYSCALL_STATS_HISTOGRAM_BUCKETS 16
+/// @brief Bucket i counts the calls that lasted between 2^(i + SHIFT) and 2^(i + SHIFT + 1) cycles,
+///        the first bucket also counts the shorter calls and the last one the longer calls
+#define SYSCALL_STATS_HISTOGRAM_SHIFT   7
+
+/// @brief Counters of a syscall, since boot or since the last SYSCALL_STATS_RESET.
+///        The duration of a blocking syscall includes the time its thread waited.
+struct SyscallStatsEntry
+{
+    unsigned int count;
+    unsigned int maxCycles;
+    unsigned long long totalCycles;
+    unsigned int histogram[SYSCALL_STATS_HISTOGRAM_BUCKETS];
+};
+
+/// @brief Number of records kept by a process syscall trace, the oldest ones are overwritten
+#define SYSCALL_TRACE_ENTRIES 64
+
+/// @brief A syscall executed by a traced process
+struct SyscallTraceRecord
+{
+    unsigned int id;
+    /// @brief ebx, ecx and edx when the syscall was made
+    unsigned int args[3];
+    /// @brief eax when the syscall returned, its status for most syscalls
+    unsigned int result;
+    unsigned int cycles;
+};
+
+enum SyscallStatsOperation
+{
+    /// @brief Copies the counters of the first size syscalls in buffer (a SyscallStatsEntry array, indexed by syscall id),
+    ///        the number of entries copied is written in countPtr
+    SYSCALL_STATS_GET,
+    /// @brief Clears every counter
+    SYSCALL_STATS_RESET,
+    /// @brief Starts recording the syscalls of the calling process
+    SYSCALL_TRACE_START,
+    /// @brief Stops recording the syscalls of the calling process and drops its records
+    SYSCALL_TRACE_STOP,
+    /// @brief Moves the oldest records (at most size) of the calling process trace in buffer (a SyscallTraceRecord array),
+    ///        the number of records moved is written in countPtr
+    SYSCALL_TRACE_READ
+};
+
+struct SysSyscallStatsParameter
+{
+    unsigned int operation;
+    void * buffer;
+    unsigned int size;
+    unsigned int * countPtr;
 };
 
 /// @}
\ No newline at end of file
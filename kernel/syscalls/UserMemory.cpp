@@ -0,0 +1,158 @@
+#include "UserMemory.hpp"
+
+#include <kernel/arch/x86/MemCommon.hpp>
+#include <kernel/lib/StdMem.hpp>
+
+#include <kernel/Logger.hpp>
+#define KLOG(LOG_LEVEL, format, ...) KLOGGER("USERMEM", LOG_LEVEL, format, ##__VA_ARGS__)
+
+KeStatus ProbeUserMemory(Process * const process, const void * const address, const unsigned int size, const bool write)
+{
+    const u32 start = (u32)address;
+    u32 last = 0;
+    u32 current = 0;
+
+    if (process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid process parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (size == 0)
+        return STATUS_SUCCESS;
+
+    if (start < V_USER_BASE_ADDR || size - 1 > 0xFFFFFFFF - start)
+        return STATUS_INVALID_VIRTUAL_USER_ADDRESS;
+
+    last = start + size - 1;
+
+    if (write && start < USER_SHARED_DATA_ADDR + PAGE_SIZE && last >= USER_SHARED_DATA_ADDR)
+        return STATUS_INVALID_VIRTUAL_USER_ADDRESS;
+
+    // The buffer may span several adjacent vads, each of them must be reserved
+    current = start;
+    while (true)
+    {
+        Vad * vad = nullptr;
+
+        if (FAILED(process->baseVad->LookForVadFromAddress((void*)current, &vad)) || vad->free)
+            return STATUS_INVALID_VIRTUAL_USER_ADDRESS;
+
+        // Read-only segments of a module may be mapped in place, the kernel mustn't write in them
+        if (write && !vad->writable)
+            return STATUS_INVALID_VIRTUAL_USER_ADDRESS;
+
+        // The guard of a stack is never mapped
+        if (current < (u32)vad->baseAddress + vad->guardSize)
+            return STATUS_INVALID_VIRTUAL_USER_ADDRESS;
+
+        if ((u32)vad->limitAddress - 1 >= last)
+            return STATUS_SUCCESS;
+
+        current = (u32)vad->limitAddress;
+    }
+}
+
+KeStatus CommitUserMemory(Process * const process, const void * const address, const unsigned int size, const bool write)
+{
+    KeStatus status = ProbeUserMemory(process, address, size, write);
+
+    if (FAILED(status))
+        return status;
+
+    return process->CommitMemory(address, size, write);
+}
+
+KeStatus CopyFromUser(Process * const process, void * const dst, const void * const userSrc, const unsigned int size)
+{
+    KeStatus status = CommitUserMemory(process, userSrc, size, false);
+
+    if (FAILED(status))
+        return status;
+
+    MemCopy(userSrc, dst, size);
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus CopyToUser(Process * const process, void * const userDst, const void * const src, const unsigned int size)
+{
+    KeStatus status = CommitUserMemory(process, userDst, size, true);
+
+    if (FAILED(status))
+        return status;
+
+    MemCopy(src, userDst, size);
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus CopyStringFromUser(Process * const process, char * const dst, const char * const userSrc, const unsigned int dstSize, unsigned int * const length)
+{
+    u32 current = (u32)userSrc;
+    unsigned int copied = 0;
+
+    if (dst == nullptr || length == nullptr || dstSize == 0)
+    {
+        KLOG(LOG_ERROR, "Invalid parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    // The string length is unknown, it is checked one page at a time
+    while (copied < dstSize - 1)
+    {
+        const unsigned int pageLeft = PAGE_SIZE - (current & (PAGE_SIZE - 1));
+        const unsigned int maxChars = dstSize - 1 - copied;
+        const unsigned int chunkSize = (pageLeft < maxChars) ? pageLeft : maxChars;
+        KeStatus status = CommitUserMemory(process, (const void*)current, chunkSize, false);
+
+        if (FAILED(status))
+        {
+            dst[copied] = '\0';
+            return status;
+        }
+
+        for (unsigned int index = 0; index < chunkSize; index++)
+        {
+            const char c = ((const char*)current)[index];
+
+            if (c == '\0')
+            {
+                dst[copied] = '\0';
+                *length = copied;
+                return STATUS_SUCCESS;
+            }
+
+            dst[copied++] = c;
+        }
+
+        current += chunkSize;
+    }
+
+    dst[copied] = '\0';
+    *length = copied;
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus CopyIoVectorsFromUser(Process * const process, IpcIoVector * const vectors, const IpcIoVector * const userVectors, const unsigned int nbVectors)
+{
+    KeStatus status = STATUS_FAILURE;
+
+    if (nbVectors == 0 || nbVectors > IPC_MAX_IO_VECTORS)
+        return STATUS_INVALID_PARAMETER;
+
+    // The vectors are copied first, so that the process can't change them once they have been checked
+    status = CopyFromUser(process, vectors, userVectors, nbVectors * sizeof(IpcIoVector));
+    if (FAILED(status))
+        return status;
+
+    for (unsigned int index = 0; index < nbVectors; index++)
+    {
+        status = CommitUserMemory(process, vectors[index].buffer, vectors[index].size, false);
+        if (FAILED(status))
+            return status;
+    }
+
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <kernel/lib/Status.hpp>
+#include <kernel/arch/x86/Process.hpp>
+
+#include "UKSyscallsCommon.h"
+
+/// @file
+
+/// @addgroup Syscalls
+/// @{
+
+/// @brief Maximum size in bytes of a string copied from a process, terminating null char included
+#define USER_STRING_MAX_SIZE 256
+
+/// @brief Checks that a buffer given by a process is in the user part of its address space and only covers reserved vads,
+///        so that the kernel can access it : pages not mapped yet are resolved by the page fault handler.
+///        The shared data page and the read-only vads are refused if the buffer is going to be written.
+/// @param[in] process The process that gave the buffer, it must be the current process
+/// @param[in] address The buffer address in the process address space
+/// @param[in] size The buffer size in bytes, 0 is always valid
+/// @param[in] write True if the kernel is going to write in the buffer
+/// @return STATUS_SUCCESS if the buffer can be used, STATUS_INVALID_VIRTUAL_USER_ADDRESS otherwise
+KeStatus ProbeUserMemory(Process * const process, const void * const address, const unsigned int size, const bool write);
+
+/// @brief Checks a process buffer with ProbeUserMemory() and commits its pages, so that the kernel can then access it directly.
+///        A page fault taken by the kernel can't fail the syscall, the memory limits of the process are checked here instead.
+/// @param[in] process The process that gave the buffer, it must be the current process
+/// @param[in] address The buffer address in the process address space
+/// @param[in] size The buffer size in bytes, 0 is always valid
+/// @param[in] write True if the kernel is going to write in the buffer
+/// @return STATUS_SUCCESS if the buffer can be used, STATUS_INVALID_VIRTUAL_USER_ADDRESS if it is not valid,
+///         STATUS_PROCESS_MEMORY_LIMIT_REACHED or another error code if its pages can't be committed
+KeStatus CommitUserMemory(Process * const process, const void * const address, const unsigned int size, const bool write);
+
+/// @brief Checks a process buffer with CommitUserMemory() and copies it in a kernel buffer
+/// @param[in]  process The process that gave the buffer, it must be the current process
+/// @param[out] dst The kernel buffer
+/// @param[in]  userSrc The buffer in the process address space
+/// @param[in]  size The number of bytes to copy
+/// @return STATUS_SUCCESS on success, STATUS_INVALID_VIRTUAL_USER_ADDRESS if the buffer can't be read, an error code otherwise
+KeStatus CopyFromUser(Process * const process, void * const dst, const void * const userSrc, const unsigned int size);
+
+/// @brief Checks a process buffer with CommitUserMemory() and copies a kernel buffer in it
+/// @param[in]  process The process that gave the buffer, it must be the current process
+/// @param[out] userDst The buffer in the process address space
+/// @param[in]  src The kernel buffer
+/// @param[in]  size The number of bytes to copy
+/// @return STATUS_SUCCESS on success, STATUS_INVALID_VIRTUAL_USER_ADDRESS if the buffer can't be written, an error code otherwise
+KeStatus CopyToUser(Process * const process, void * const userDst, const void * const src, const unsigned int size);
+
+/// @brief Copies a null terminated string from a process, at most dstSize - 1 chars. dst is always null terminated.
+/// @param[in]  process The process that gave the string, it must be the current process
+/// @param[out] dst The kernel buffer
+/// @param[in]  userSrc The string in the process address space
+/// @param[in]  dstSize The kernel buffer size in bytes
+/// @param[out] length Pointer that will hold the number of chars copied, if it is dstSize - 1 the string may be longer
+/// @return STATUS_SUCCESS on success, STATUS_INVALID_VIRTUAL_USER_ADDRESS if the string can't be read
+KeStatus CopyStringFromUser(Process * const process, char * const dst, const char * const userSrc, const unsigned int dstSize, unsigned int * const length);
+
+/// @brief Copies the vectors of a vectored send and checks that each of their buffers can be read
+/// @param[in]  process The process that gave the vectors, it must be the current process
+/// @param[out] vectors The kernel array, it can hold IPC_MAX_IO_VECTORS vectors
+/// @param[in]  userVectors The vectors array in the process address space
+/// @param[in]  nbVectors The number of vectors, between 1 and IPC_MAX_IO_VECTORS
+/// @return STATUS_SUCCESS on success, STATUS_INVALID_PARAMETER if nbVectors is invalid,
+///         STATUS_INVALID_VIRTUAL_USER_ADDRESS if the vectors or one of their buffers can't be read
+KeStatus CopyIoVectorsFromUser(Process * const process, IpcIoVector * const vectors, const IpcIoVector * const userVectors, const unsigned int nbVectors);
+
+/// @}
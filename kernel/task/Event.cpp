@@ -12,12 +12,30 @@
 #define DKLOG(LOG_LEVEL, format, ...)
 #endif
 
+static void _EventWait(Event * evt, Thread * handOffThread);
+
 Event EventCreate()
 {
     return Event();
 }
 
 void EventWait(Event * evt)
+{
+    _EventWait(evt, nullptr);
+}
+
+void EventWaitAndHandOff(Event * evt, Thread * thread)
+{
+    if (thread == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid thread parameter");
+        return;
+    }
+
+    _EventWait(evt, thread);
+}
+
+void EventSignal(Event * evt)
 {
     if (evt == nullptr)
     {
@@ -26,21 +44,26 @@ void EventWait(Event * evt)
     }
 
     evt->criticalSection.Enter();
+    evt->signaled = true;
 
-    if (evt->signaled == false)
+    // Every waiting thread is woken up
+    while (evt->thread != nullptr)
     {
-        evt->thread = gThreadManager.GetCurrentThread();
-        evt->thread->state = THREAD_STATE_WAITING;
-        evt->criticalSection.Leave();
+        Thread * thread = evt->thread;
 
-        gScheduler.ContextSwitchInterrupt();
+        evt->thread = thread->nextEventWaiter;
+        thread->nextEventWaiter = nullptr;
+        thread->state = THREAD_STATE_RUNNING;
     }
 
-    evt->signaled = false;
+    // A watcher target is never the watched event, and its own critical section is taken after this one
+    for (EventWatcher * watcher = evt->watchers; watcher != nullptr; watcher = watcher->next)
+        EventSignal(watcher->target);
+
     evt->criticalSection.Leave();
 }
 
-void EventSignal(Event * evt)
+void EventAddWatcher(Event * evt, EventWatcher * watcher)
 {
     if (evt == nullptr)
     {
@@ -48,13 +71,78 @@ void EventSignal(Event * evt)
         return;
     }
 
+    if (watcher == nullptr || watcher->target == nullptr || watcher->target == evt)
+    {
+        KLOG(LOG_ERROR, "Invalid watcher parameter");
+        return;
+    }
+
     evt->criticalSection.Enter();
-    evt->signaled = true;
 
-    if (evt->thread != nullptr)
+    watcher->next = evt->watchers;
+    evt->watchers = watcher;
+
+    evt->criticalSection.Leave();
+}
+
+void EventRemoveWatcher(Event * evt, EventWatcher * watcher)
+{
+    EventWatcher ** link = nullptr;
+
+    if (evt == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid evt parameter");
+        return;
+    }
+
+    if (watcher == nullptr)
     {
-        evt->thread->state = THREAD_STATE_RUNNING;
+        KLOG(LOG_ERROR, "Invalid watcher parameter");
+        return;
     }
 
+    evt->criticalSection.Enter();
+
+    link = &evt->watchers;
+    while (*link != nullptr && *link != watcher)
+        link = &(*link)->next;
+
+    if (*link != nullptr)
+        *link = watcher->next;
+
+    watcher->next = nullptr;
+
+    evt->criticalSection.Leave();
+}
+
+static void _EventWait(Event * evt, Thread * handOffThread)
+{
+    if (evt == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid evt parameter");
+        return;
+    }
+
+    evt->criticalSection.Enter();
+
+    if (evt->signaled == false)
+    {
+        Thread * currentThread = gThreadManager.GetCurrentThread();
+
+        currentThread->nextEventWaiter = evt->thread;
+        currentThread->state = THREAD_STATE_WAITING;
+        evt->thread = currentThread;
+        evt->criticalSection.Leave();
+
+        if (handOffThread != nullptr)
+            gScheduler.HandOff(handOffThread);
+        else
+            gScheduler.ContextSwitchInterrupt();
+
+        // The critical section has been left before waiting, EventSignal() removed us from the waiters
+        evt->criticalSection.Enter();
+    }
+
+    evt->signaled = false;
     evt->criticalSection.Leave();
 }
\ No newline at end of file
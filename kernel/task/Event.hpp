@@ -3,15 +3,47 @@
 #include <kernel/arch/x86/Thread.hpp>
 #include <kernel/lib/CriticalSection.hpp>
 
+struct Event;
+
+/// @brief Forwards the signals of an event to another one, so that a thread can wait for several events at once
+struct EventWatcher
+{
+    /// @brief Event signaled each time the watched event is
+    Event * target;
+    EventWatcher * next;
+};
+
+/// @brief Several threads may wait for the same event, they are all woken up when it is signaled.
+///        The first one resumed consumes the signal, so waiters must check their condition again.
 struct Event
 {
-    Event() : signaled(false), thread(nullptr) {}
+    Event() : signaled(false), thread(nullptr), watchers(nullptr) {}
 
     bool signaled;
+    /// @brief Last thread that started waiting, the others are chained with Thread::nextEventWaiter
     Thread * thread;
+    /// @brief Watchers whose target is signaled with this event
+    EventWatcher * watchers;
     CriticalSection criticalSection;
 };
 
 Event EventCreate();
 void EventWait(Event * evt);
-void EventSignal(Event * evt);
\ No newline at end of file
+
+/// @brief Waits for the event like EventWait(), but the processor is directly given to the given thread
+///        instead of the next one in the scheduler list. Used when the current thread waits for the given one.
+/// @param[in] evt A pointer to the event
+/// @param[in] thread A pointer to the thread to switch to
+void EventWaitAndHandOff(Event * evt, Thread * thread);
+
+void EventSignal(Event * evt);
+/// @brief Adds a watcher to an event, its target is signaled each time the event is, until it is removed.
+///        The watched event signaled state is left untouched.
+/// @param[in] evt A pointer to the watched event
+/// @param[in] watcher A pointer to the watcher, its target must be set. It must stay valid until it is removed
+void EventAddWatcher(Event * evt, EventWatcher * watcher);
+
+/// @brief Removes a watcher added with EventAddWatcher()
+/// @param[in] evt A pointer to the watched event
+/// @param[in] watcher A pointer to the watcher
+void EventRemoveWatcher(Event * evt, EventWatcher * watcher);
\ No newline at end of file
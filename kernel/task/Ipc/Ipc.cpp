@@ -10,6 +10,9 @@
 #include <kernel/task/Event.hpp>
 #include <kernel/drivers/Clock.hpp>
 #include <kernel/handle/HandleManager.h>
+#include <kernel/arch/x86/Pmm.hpp>
+#include <kernel/arch/x86/KMap.hpp>
+#include <kernel/syscalls/UserMemory.hpp>
 
 #include "IpcBuffer.hpp"
 
@@ -20,6 +23,9 @@
 #define DKLOG(LOG_LEVEL, format, ...)
 #endif
 
+struct IpcCall;
+struct IpcClientQueue;
+
 struct IpcObject
 {
     /// String identifying the server process
@@ -28,30 +34,135 @@ struct IpcObject
     IpcHandle handle;
     /// Pointer to the server process
     Process * serverProcess;
-    /// IpcBuffer to handle messages
-    IpcBuffer buffer;
+    /// Queues of the clients that connected or sent a message, one IpcBuffer each
+    IpcClientQueue * clientQueues;
+    /// Client queue Receive() looks at first, so that the clients are served round-robin. nullptr stands for the first one
+    IpcClientQueue * nextClientQueue;
+    /// Number of messages waiting in the client queues
+    unsigned int nbPendingMessages;
+    /// Event signaled when a message is added to one of the client queues
+    Event messagesEvent;
     /// Critical section used to protect the ipcObject
     CriticalSection criticalSection;
+    /// Server thread handling the requests, the last one that called Receive()
+    Thread * serverThread;
+    /// Highest priority level among the clients whose messages are not read yet
+    ThreadPriorityLevel pendingClientPriority;
+    /// Number of priority levels the server thread inherited from its clients
+    unsigned int inheritedPriorityLevels;
+    /// List of IpcPagesMessage waiting to be received
+    List * pagesMessages;
+    /// Event signaled when a pages message is added
+    Event pagesMessagesEvent;
+    /// List of IpcCall waiting for the server to call ReplyWait()
+    List * pendingCalls;
+    /// Event signaled when a call is added
+    Event pendingCallsEvent;
+    /// Call received by the server and not replied yet
+    IpcCall * currentCall;
+    /// Server thread blocked in ReplyWait(), waiting for a call
+    Thread * waitingServerThread;
+    /// List of IpcChannel waiting to be accepted by the server
+    List * pendingChannels;
+    /// Event signaled when a channel is added
+    Event pendingChannelsEvent;
+    /// Next ipc object chained from IpcHandler::_servers, ipc objects are never removed
+    IpcObject * next;
+
+    static KeStatus Create(const char * serverIdStr, Process * const serverProcess, IpcObject** const ipcObject);
+    static void Destroy(IpcObject * const ipcObject);
+};
+
+struct IpcClientQueue
+{
+    /// Handle identifying the client to the server, it is given with each message
+    IpcHandle handle;
+    /// Client process sending through this queue
+    Process * clientProcess;
+    /// Messages sent by this client and not received yet, a full buffer only makes this client wait
+    IpcBuffer buffer;
+    /// Number of messages in the buffer, they are no longer pending for the ipc object once the client disconnects
+    unsigned int nbMessages;
+    /// Number of client threads in SendV() using the queue, the last one frees it once the client disconnected
+    unsigned int nbSenders;
+    /// Boolean telling if the queue has been removed from the ipc object by Disconnect()
+    bool disconnected;
+    /// Next client queue of the same ipc object
+    IpcClientQueue * next;
+};
 
-    static KeStatus Create(const char * serverIdStr, Process * const serverProcess, const IpcHandle handle, IpcObject** const ipcObject);
+struct IpcPagesMessage
+{
+    /// Physical addresses of the pages holding the message
+    u32 * pAddrs;
+    /// Number of pages holding the message
+    unsigned int nbPages;
+    /// Message size in bytes
+    unsigned int size;
+    /// Boolean telling if the pages are still mapped by the client (copy-on-write)
+    bool copyOnWrite;
+};
+
+struct IpcChannel
+{
+    /// Handle identifying the channel
+    IpcHandle handle;
+    /// Physical addresses of the ring pages, the ring header first. The channel holds a reference on each of them.
+    u32 * pAddrs;
+    /// Number of pages of the ring, header included
+    unsigned int nbPages;
+    /// Process writing in the channel, the one that created it
+    Process * producerProcess;
+    /// Ring address in the producer address space
+    IpcChannelRing * producerRing;
+    /// Process reading from the channel, the server that accepted it
+    Process * consumerProcess;
+    /// Ring address in the consumer address space, nullptr until the channel is accepted
+    IpcChannelRing * consumerRing;
+    /// Event signaled by ChannelWake() and CloseChannel()
+    Event doorbell;
+    /// One reference per side not closed yet (the server pending channels list holds the consumer one until the channel
+    /// is accepted) and one per thread using the channel in a syscall. The channel is freed with the last one.
+    unsigned int references;
+    /// Channels chained from IpcHandler::_channels, so that those of a dying process can be found
+    IpcChannel * previous;
+    IpcChannel * next;
 };
 
-struct FIND_IPC_OBJECTS_CONTEXT
+struct IpcCall
 {
-    char * serverId;
-    IpcObject* ipcObject;
-    IpcHandle ipcHandle;
-    bool found;
+    /// Client thread waiting for the reply
+    Thread * clientThread;
+    /// Message sent by the client, replaced by the server reply
+    IpcRegisterMessage message;
+    /// Boolean telling if the server replied, protected by the ipc object critical section
+    bool replied;
+    /// Event signaled when the server replies
+    Event replyEvent;
 };
 
-static KeStatus FindIpcObjectByHandleCallback(void* ipcObjectPtr, void* context);
-static KeStatus FindIpcObjectByServerIdCallback(void * ipcObjectPtr, void * context);
+static bool IsIpcObjectDrained(IpcObject * const ipcObject);
+static IpcClientQueue * FindClientQueue(IpcObject * const ipcObject, Process * const clientProcess);
+static IpcClientQueue * GetNextClientQueue(IpcObject * const ipcObject);
+static unsigned int GetIpcObjectReadyEvents(IpcObject * const ipcObject, const unsigned int events);
+static unsigned int GetChannelReadyEvents(const IpcChannelRing * const ring, const unsigned int events);
+static IpcChannelRing * GetChannelRing(IpcChannel * const channel, Process * const process);
 
-static IpcHandle s_IpcObjectHandleCount = INVALID_HANDLE_VALUE;
+/// @brief Events an ipc server handle can be waited on for
+#define IPC_WAIT_SERVER_EVENTS (IPC_WAIT_MESSAGE | IPC_WAIT_PAGES_MESSAGE | IPC_WAIT_CHANNEL_PENDING)
+/// @brief Maximum number of events watched for a single wait entry
+#define IPC_WAIT_MAX_WATCHERS_PER_ENTRY 3
 
 void IpcHandler::Init()
 {
-    _ipcObjects = ListCreate();
+    _servers = nullptr;
+    _serversCriticalSection = CriticalSection();
+    _channels = nullptr;
+    _channelsCriticalSection = CriticalSection();
+
+    KeStatus status = _registry.Init();
+    if (FAILED(status))
+        KLOG(LOG_ERROR, "IpcRegistry::Init() failed with code %t", status);
 }
 
 KeStatus IpcHandler::AddNewServer(const char * serverIdStr, Process* const serverProcess, IpcHandle* const handle)
@@ -78,35 +189,55 @@ KeStatus IpcHandler::AddNewServer(const char * serverIdStr, Process* const serve
         return STATUS_NULL_PARAMETER;
     }
 
-    if (_IsServerIdStrAlreadyUsed(serverIdStr))
+    // Avoids creating the object in the common case, the registry checks it again when adding the object
+    if (_registry.FindByServerId(serverIdStr, &ipcObjectHandle) == STATUS_SUCCESS)
     {
         KLOG(LOG_DEBUG, "The id string '%s' is already used", serverIdStr);
         return IPC_STATUS_ID_STRING_ALREADY_USED;
     }
 
-    ipcObjectHandle = ++s_IpcObjectHandleCount;
-
-    status = IpcObject::Create(serverIdStr, serverProcess, ipcObjectHandle, &ipcObject);
+    status = IpcObject::Create(serverIdStr, serverProcess, &ipcObject);
     if (FAILED(status))
     {
         KLOG(LOG_ERROR, "IpcObject::Create() failed with code %t", status);
         goto clean;
     }
 
-    ListPush(_ipcObjects, ipcObject);
+    status = _registry.Add(ipcObject->id, ipcObject, &ipcObjectHandle);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "IpcRegistry::Add() failed with code %t ('%s')", status, serverIdStr);
+        goto clean;
+    }
+
+    ipcObject->handle = ipcObjectHandle;
+
+    _serversCriticalSection.Enter();
+    ipcObject->next = _servers;
+    _servers = ipcObject;
+    _serversCriticalSection.Leave();
 
     *handle = ipcObjectHandle;
+    ipcObject = nullptr;
 
     status = STATUS_SUCCESS;
 
 clean:
+    if (ipcObject != nullptr)
+    {
+        IpcObject::Destroy(ipcObject);
+        ipcObject = nullptr;
+    }
+
     return status;
 }
 
 KeStatus IpcHandler::ConnectToServer(const char* serverIdStr, Process * const clientProcess, IpcHandle* const ipcHandle)
 {
     KeStatus status = STATUS_FAILURE;
-    IpcObject* ipcObject = nullptr;
+    IpcHandle handle = INVALID_HANDLE_VALUE;
+    IpcObject * ipcObject = nullptr;
+    IpcClientQueue * clientQueue = nullptr;
 
     // TODO : check if the clientProcess is authorized to connect to this server
 
@@ -128,15 +259,34 @@ KeStatus IpcHandler::ConnectToServer(const char* serverIdStr, Process * const cl
         return STATUS_NULL_PARAMETER;
     }
 
-    ipcObject = _FindIpcObjectByServerId(serverIdStr);
-    if (ipcObject == nullptr)
+    status = _registry.FindByServerId(serverIdStr, &handle);
+    if (FAILED(status))
     {
         KLOG(LOG_DEBUG, "Server '%s' not found", serverIdStr);
         status = IPC_STATUS_SERVER_NOT_FOUND;
         goto clean;
     }
 
-    *ipcHandle = ipcObject->handle;
+    ipcObject = _registry.FindByHandle(handle);
+    if (ipcObject == nullptr)
+    {
+        status = IPC_STATUS_SERVER_NOT_FOUND;
+        goto clean;
+    }
+
+    // The client queue is created now so that an allocation failure is reported here rather than on the first send.
+    // A server may connect to itself, it never sends through its own queue.
+    if (clientProcess != ipcObject->serverProcess)
+    {
+        status = _GetClientQueue(ipcObject, clientProcess, &clientQueue);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "_GetClientQueue() failed with code %t", status);
+            goto clean;
+        }
+    }
+
+    *ipcHandle = handle;
 
     status = STATUS_SUCCESS;
 
@@ -145,13 +295,29 @@ clean:
 }
 
 KeStatus IpcHandler::Send(const IpcHandle handle, Process* const clientProcess, const char* message, const unsigned int size)
+{
+    IpcIoVector vector;
+
+    if (message == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid message parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    vector.buffer = message;
+    vector.size = size;
+
+    return SendV(handle, clientProcess, &vector, 1);
+}
+
+KeStatus IpcHandler::SendV(const IpcHandle handle, Process* const clientProcess, const IpcIoVector * const vectors, const unsigned int nbVectors)
 {
     KeStatus status = STATUS_FAILURE;
     IpcObject * ipcObject = nullptr;
-    Process * serverProcess = nullptr;
-    u8 * serverBuffer = nullptr;
-    u8 * kernelBuffer = nullptr;
-    Handle clientProcessHandle = INVALID_HANDLE_VALUE;
+    IpcClientQueue * clientQueue = nullptr;
+    Thread * clientThread = nullptr;
+    unsigned int size = 0;
+    bool freeClientQueue = false;
 
     if (handle == 0)
     {
@@ -165,64 +331,135 @@ KeStatus IpcHandler::Send(const IpcHandle handle, Process* const clientProcess,
         return STATUS_NULL_PARAMETER;
     }
 
-    if (message == nullptr)
+    if (vectors == nullptr)
     {
-        KLOG(LOG_ERROR, "Invalid message parameter");
+        KLOG(LOG_ERROR, "Invalid vectors parameter");
         return STATUS_NULL_PARAMETER;
     }
 
+    if (nbVectors == 0 || nbVectors > IPC_MAX_IO_VECTORS)
+    {
+        KLOG(LOG_ERROR, "Invalid nbVectors parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    for (unsigned int index = 0; index < nbVectors; index++)
+    {
+        if (vectors[index].buffer == nullptr && vectors[index].size != 0)
+        {
+            KLOG(LOG_ERROR, "Invalid buffer for vector %d", index);
+            return STATUS_NULL_PARAMETER;
+        }
+
+        // Checked on each vector so that the sum can't wrap around
+        if (vectors[index].size > IPC_MAX_MESSAGE_SIZE - size)
+        {
+            KLOG(LOG_DEBUG, "Message bigger than %d bytes", IPC_MAX_MESSAGE_SIZE);
+            return IPC_STATUS_MESSAGE_TOO_BIG;
+        }
+
+        size += vectors[index].size;
+    }
+
     if (size == 0)
     {
         KLOG(LOG_ERROR, "Invalid size parameter");
         return STATUS_INVALID_PARAMETER;
     }
 
-    DKLOG(LOG_DEBUG, "Handling message from %s, msg addr : %x, size : %d", clientProcess->name, message, size);
-
-    ipcObject->criticalSection.Enter();
+    DKLOG(LOG_DEBUG, "Handling message from %s, %d vectors, size : %d", clientProcess->name, nbVectors, size);
 
-    ipcObject = _FindIpcObjectByHandle(handle);
+    ipcObject = _registry.FindByHandle(handle);
     if (ipcObject == nullptr)
     {
         KLOG(LOG_DEBUG, "Didn't found ipc object for handle %d", handle);
-        status = IPC_STATUS_SERVER_NOT_FOUND;
-        goto clean;
+        return IPC_STATUS_SERVER_NOT_FOUND;
     }
 
     // A ipc server can't send a message, but only receive one
     if (clientProcess == ipcObject->serverProcess)
     {
         KLOG(LOG_DEBUG, "A ipc server tried to send a message");
+        return IPC_STATUS_ACCESS_DENIED;
+    }
+
+    // Clients that didn't connect to the server get their queue on their first message
+    status = _GetClientQueue(ipcObject, clientProcess, &clientQueue);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "_GetClientQueue() failed with code %t", status);
+        return status;
+    }
+
+    clientThread = gThreadManager.GetCurrentThread();
+
+    ipcObject->criticalSection.Enter();
+
+    // Another thread of the client may have disconnected it since the queue was retrieved
+    clientQueue = FindClientQueue(ipcObject, clientProcess);
+    if (clientQueue == nullptr)
+    {
+        KLOG(LOG_DEBUG, "The client disconnected while sending");
+        status = IPC_STATUS_ACCESS_DENIED;
+        goto clean;
+    }
+
+    clientQueue->nbSenders++;
+
+    // The server now works on behalf of this client : it must not be preempted by threads
+    // having a lower priority than the client one (priority inversion)
+    _InheritClientPriority(ipcObject, clientThread);
+
+    // Only this client waits if its own queue is full, the others keep sending
+    while (clientQueue->buffer.GetFreeBytes() < sizeof(IpcMessageHeader) + size && !clientQueue->disconnected)
+    {
+        ipcObject->criticalSection.Leave();
+        EventWait(&clientQueue->buffer.ReadyToWriteEvent);
+        ipcObject->criticalSection.Enter();
+    }
+
+    if (clientQueue->disconnected)
+    {
+        KLOG(LOG_DEBUG, "The client disconnected while sending");
         status = IPC_STATUS_ACCESS_DENIED;
         goto clean;
     }
 
-    status = ipcObject->buffer.AddBytes(message, size);
+    status = clientQueue->buffer.AddMessage(vectors, nbVectors, size);
     if (FAILED(status))
     {
-        KLOG(LOG_ERROR, "IpcBuffer::AddBytes() failed with code %t", status);
+        KLOG(LOG_ERROR, "IpcBuffer::AddMessage() failed with code %t", status);
         goto clean;
     }
 
+    clientQueue->nbMessages++;
+    ipcObject->nbPendingMessages++;
+    EventSignal(&ipcObject->messagesEvent);
+
     status = STATUS_SUCCESS;
 
 clean:
-    ipcObject->criticalSection.Leave();
-
-    if (kernelBuffer != nullptr)
+    if (clientQueue != nullptr)
     {
-        HeapFree(kernelBuffer);
-        kernelBuffer = nullptr;
+        clientQueue->nbSenders--;
+        freeClientQueue = clientQueue->disconnected && clientQueue->nbSenders == 0;
     }
 
+    ipcObject->criticalSection.Leave();
+
+    if (freeClientQueue)
+        _FreeClientQueue(clientQueue);
+
     return status;
 }
 
-KeStatus IpcHandler::Receive(const IpcHandle handle, Process* const serverProcess, char * const buffer, const unsigned int size, unsigned int * const bytesRead)
+KeStatus IpcHandler::Receive(const IpcHandle handle, Process* const serverProcess, char * const buffer, const unsigned int size, unsigned int * const bytesRead, IpcSenderInfo * const sender)
 {
     KeStatus status = STATUS_FAILURE;
     IpcObject * ipcObject = nullptr;
+    IpcClientQueue * clientQueue = nullptr;
     unsigned int localBytesRead = 0;
+    unsigned int messageSize = 0;
 
     if (handle == 0)
     {
@@ -254,7 +491,7 @@ KeStatus IpcHandler::Receive(const IpcHandle handle, Process* const serverProces
         return STATUS_NULL_PARAMETER;
     }
 
-    ipcObject = _FindIpcObjectByHandle(handle);
+    ipcObject = _registry.FindByHandle(handle);
     if (ipcObject == nullptr)
     {
         KLOG(LOG_DEBUG, "Didn't found ipc object for handle %d", handle);
@@ -265,207 +502,1646 @@ KeStatus IpcHandler::Receive(const IpcHandle handle, Process* const serverProces
     if (serverProcess != ipcObject->serverProcess)
     {
         KLOG(LOG_DEBUG, "An ipc client tried to receive a message");
-        status = IPC_STATUS_ACCESS_DENIED;
+        return IPC_STATUS_ACCESS_DENIED;
     }
 
-    EventWait(&ipcObject->buffer.ReadyToReadEvent);
-
     ipcObject->criticalSection.Enter();
-        
-    status = ipcObject->buffer.ReadBytes(buffer, size, &localBytesRead);
+
+    // Coming back to Receive() means the previous request has been handled (and replied),
+    // the priority inherited for it is given back. If messages are still pending, the
+    // server keeps working on behalf of their senders and inherits their priority again.
+    _RestoreServerPriority(ipcObject);
+    ipcObject->serverThread = gThreadManager.GetCurrentThread();
+    _InheritClientPriority(ipcObject, nullptr);
+
+    // The event is signaled once for several messages sent before the server reads them,
+    // we only wait if there is nothing left to read
+    while (ipcObject->nbPendingMessages == 0)
+    {
+        ipcObject->criticalSection.Leave();
+        EventWait(&ipcObject->messagesEvent);
+        ipcObject->criticalSection.Enter();
+    }
+
+    clientQueue = GetNextClientQueue(ipcObject);
+    messageSize = clientQueue->buffer.GetNextMessageSize();
+
+    // The buffer was checked before waiting, another thread of the server may have released it since.
+    // The pages receiving the message are committed here, the memory limits of the server can't be checked on a kernel fault.
+    status = CommitUserMemory(serverProcess, buffer, (messageSize < size) ? messageSize : size, true);
     if (FAILED(status))
     {
-        KLOG(LOG_ERROR, "IpcBuffer::ReadBytes() failed with code %t", status);
+        KLOG(LOG_DEBUG, "CommitUserMemory() failed with code %t for the receive buffer", status);
         goto clean;
     }
 
-    ipcObject->criticalSection.Leave();
+    if (sender != nullptr)
+    {
+        sender->pid = clientQueue->clientProcess->pid;
+        sender->clientHandle = clientQueue->handle;
+    }
+
+    status = clientQueue->buffer.ReadMessage(buffer, size, &localBytesRead);
+    if (status == IPC_STATUS_BUFFER_TOO_SMALL)
+    {
+        // The message is kept, the server is given the size it needs to read it, and the same client is served again
+        ipcObject->nextClientQueue = clientQueue;
+        *bytesRead = localBytesRead;
+        goto clean;
+    }
+    else if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "IpcBuffer::ReadMessage() failed with code %t", status);
+        goto clean;
+    }
+
+    clientQueue->nbMessages--;
+    ipcObject->nbPendingMessages--;
+    ipcObject->nextClientQueue = clientQueue->next;
+
+    // No more waiting clients, the inherited priority is kept until the server
+    // comes back to Receive(), i.e. until the current request is handled
+    if (IsIpcObjectDrained(ipcObject))
+        ipcObject->pendingClientPriority = THREAD_PRIORITY_NORMAL;
 
     *bytesRead = localBytesRead;
 
     status = STATUS_SUCCESS;
 
 clean:
-    return status;
-}
-
-KeStatus IpcHandler::ReleaseMemory(Process* const process, void* ptr) {
-    return STATUS_SUCCESS;
-}
+    ipcObject->criticalSection.Leave();
 
-KeStatus IpcHandler::_AllocateMemory(Process* const process, unsigned int size, char** const buffer)
-{
-    return STATUS_SUCCESS;
+    return status;
 }
 
-IpcObject* IpcHandler::_FindIpcObjectByHandle(const IpcHandle handle) const
+KeStatus IpcHandler::SendPages(const IpcHandle handle, Process* const clientProcess, const char* message, const unsigned int size, const bool keepAccess)
 {
-    FIND_IPC_OBJECTS_CONTEXT context;
+    KeStatus status = STATUS_FAILURE;
+    IpcObject * ipcObject = nullptr;
+    IpcPagesMessage * pagesMessage = nullptr;
+    Thread * clientThread = nullptr;
 
-    if (handle == INVALID_HANDLE_VALUE)
+    if (handle == 0)
     {
-        KLOG(LOG_ERROR, "Invalid handle");
-        return nullptr;
+        KLOG(LOG_ERROR, "Invalid handle parameter");
+        return STATUS_INVALID_PARAMETER;
     }
 
-    context.serverId = nullptr;
-    context.ipcObject = nullptr;
-    context.ipcHandle = handle;
-    context.found = false;
-
-    ListEnumerate(_ipcObjects, FindIpcObjectByHandleCallback, &context);
+    if (clientProcess == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid clientProcess parameter");
+        return STATUS_NULL_PARAMETER;
+    }
 
-    return context.ipcObject;
-}
+    if (message == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid message parameter");
+        return STATUS_NULL_PARAMETER;
+    }
 
-IpcObject* IpcHandler::_FindIpcObjectByServerId(const char * serverId) const
-{
-    FIND_IPC_OBJECTS_CONTEXT context;
+    if (((u32)message & (PAGE_SIZE - 1)) != 0)
+    {
+        KLOG(LOG_ERROR, "The message %x is not page aligned", message);
+        return STATUS_INVALID_PARAMETER;
+    }
 
-    if (serverId == nullptr)
+    if (size == 0)
     {
-        KLOG(LOG_ERROR, "serverId handle");
-        return nullptr;
+        KLOG(LOG_ERROR, "Invalid size parameter");
+        return STATUS_INVALID_PARAMETER;
     }
 
-    context.serverId = (char*)serverId;
-    context.ipcObject = nullptr;
-    context.ipcHandle = INVALID_HANDLE_VALUE;
-    context.found = false;
+    ipcObject = _registry.FindByHandle(handle);
+    if (ipcObject == nullptr)
+    {
+        KLOG(LOG_DEBUG, "Didn't found ipc object for handle %d", handle);
+        return IPC_STATUS_SERVER_NOT_FOUND;
+    }
 
-    ListEnumerate(_ipcObjects, FindIpcObjectByServerIdCallback, &context);
+    // A ipc server can't send a message, but only receive one
+    if (clientProcess == ipcObject->serverProcess)
+    {
+        KLOG(LOG_DEBUG, "A ipc server tried to send a message");
+        return IPC_STATUS_ACCESS_DENIED;
+    }
 
-    return context.ipcObject;
-}
+    pagesMessage = (IpcPagesMessage*)HeapAlloc(sizeof(IpcPagesMessage));
+    if (pagesMessage == nullptr)
+    {
+        KLOG(LOG_ERROR, "Couldn't allocate %d bytes", sizeof(IpcPagesMessage));
+        status = STATUS_ALLOC_FAILED;
+        goto clean;
+    }
 
-bool IpcHandler::_IsServerIdStrAlreadyUsed(const char * serverIdStr) const
-{
-    FIND_IPC_OBJECTS_CONTEXT context;
+    pagesMessage->size = size;
+    pagesMessage->nbPages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+    pagesMessage->copyOnWrite = keepAccess;
+    pagesMessage->pAddrs = (u32*)HeapAlloc(pagesMessage->nbPages * sizeof(u32));
+    if (pagesMessage->pAddrs == nullptr)
+    {
+        KLOG(LOG_ERROR, "Couldn't allocate %d bytes", pagesMessage->nbPages * sizeof(u32));
+        status = STATUS_ALLOC_FAILED;
+        goto clean;
+    }
 
-    if (serverIdStr == nullptr)
+    // The message is not copied, we only retrieve the physical pages holding it
+    status = clientProcess->DetachPhysicalPages((void*)message, pagesMessage->nbPages, keepAccess, pagesMessage->pAddrs);
+    if (FAILED(status))
     {
-        KLOG(LOG_ERROR, "Invalid serverIdStr");
-        return true;
+        KLOG(LOG_ERROR, "Process::DetachPhysicalPages() failed with code %t", status);
+        goto clean;
     }
 
-    context.serverId = (char*)serverIdStr;
-    context.found = false;
+    clientThread = gThreadManager.GetCurrentThread();
 
-    ListEnumerate(_ipcObjects, FindIpcObjectByServerIdCallback, &context);
+    ipcObject->criticalSection.Enter();
 
-    return context.found;
-}
+    ListPush(ipcObject->pagesMessages, pagesMessage);
+    pagesMessage = nullptr;
 
-static KeStatus FindIpcObjectByHandleCallback(void* ipcObjectPtr, void* context)
-{
-    IpcObject* ipcObject = (IpcObject*)ipcObjectPtr;
-    FIND_IPC_OBJECTS_CONTEXT* ipcContext = (FIND_IPC_OBJECTS_CONTEXT*)context;
+    _InheritClientPriority(ipcObject, clientThread);
 
-    if (ipcObjectPtr == nullptr)
-    {
-        KLOG(LOG_ERROR, "invalid ipcObjectPtr parameter");
-        return STATUS_NULL_PARAMETER;
-    }
+    ipcObject->criticalSection.Leave();
 
-    if (context == nullptr)
-    {
-        KLOG(LOG_ERROR, "invalid context parameter");
-        return STATUS_NULL_PARAMETER;
-    }
+    EventSignal(&ipcObject->pagesMessagesEvent);
 
-    //KLOG(LOG_DEBUG, "[%d - %d]", ipcObject->handle, ipcContext->ipcHandle);
+    status = STATUS_SUCCESS;
 
-    if (ipcObject->handle == ipcContext->ipcHandle)
+clean:
+    if (pagesMessage != nullptr)
     {
-        ipcContext->found = true;
-        ipcContext->ipcObject = ipcObject;
+        if (pagesMessage->pAddrs != nullptr)
+            HeapFree(pagesMessage->pAddrs);
 
-        return STATUS_LIST_STOP_ITERATING;
+        HeapFree(pagesMessage);
+        pagesMessage = nullptr;
     }
 
-    return STATUS_SUCCESS;
+    return status;
 }
 
-static KeStatus FindIpcObjectByServerIdCallback(void * ipcObjectPtr, void * context)
+KeStatus IpcHandler::ReceivePages(const IpcHandle handle, Process* const serverProcess, char ** const message, unsigned int * const size)
 {
-    IpcObject * ipcObject = (IpcObject*)ipcObjectPtr;
-    FIND_IPC_OBJECTS_CONTEXT * ipcContext = (FIND_IPC_OBJECTS_CONTEXT*)context;
+    KeStatus status = STATUS_FAILURE;
+    IpcObject * ipcObject = nullptr;
+    IpcPagesMessage * pagesMessage = nullptr;
+    char * serverBuffer = nullptr;
+
+    if (handle == 0)
+    {
+        KLOG(LOG_ERROR, "Invalid handle parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
 
-    if (ipcObjectPtr == nullptr)
+    if (serverProcess == nullptr)
     {
-        KLOG(LOG_ERROR, "invalid ipcObjectPtr parameter");
+        KLOG(LOG_ERROR, "Invalid serverProcess parameter");
         return STATUS_NULL_PARAMETER;
     }
 
-    if (context == nullptr)
+    if (message == nullptr)
     {
-        KLOG(LOG_ERROR, "invalid context parameter");
+        KLOG(LOG_ERROR, "Invalid message parameter");
         return STATUS_NULL_PARAMETER;
     }
 
-    if (StrCmp(ipcObject->id, ipcContext->serverId) == 0)
+    if (size == nullptr)
     {
-        //KLOG(LOG_DEBUG, "found %x - %x", ipcObject->id, ipcContext->serverId);
+        KLOG(LOG_ERROR, "Invalid size parameter");
+        return STATUS_NULL_PARAMETER;
+    }
 
-        ipcContext->found = true;
-        ipcContext->ipcObject = ipcObject;
+    ipcObject = _registry.FindByHandle(handle);
+    if (ipcObject == nullptr)
+    {
+        KLOG(LOG_DEBUG, "Didn't found ipc object for handle %d", handle);
+        return IPC_STATUS_SERVER_NOT_FOUND;
+    }
 
-        return STATUS_LIST_STOP_ITERATING;
+    // An ipc client can't receive a message, but only send one
+    if (serverProcess != ipcObject->serverProcess)
+    {
+        KLOG(LOG_DEBUG, "An ipc client tried to receive a message");
+        return IPC_STATUS_ACCESS_DENIED;
     }
 
-    return STATUS_SUCCESS;
-}
+    ipcObject->criticalSection.Enter();
 
-KeStatus IpcObject::Create(const char * serverIdStr, Process * const serverProcess, const IpcHandle handle, IpcObject** const ipcObject)
-{
-    KeStatus status = STATUS_FAILURE;
-    IpcObject * object = nullptr;
-    char * serverIdStrCopy = nullptr;
+    _RestoreServerPriority(ipcObject);
+    ipcObject->serverThread = gThreadManager.GetCurrentThread();
+    _InheritClientPriority(ipcObject, nullptr);
 
-    if (serverIdStr == nullptr)
+    // The event may have been signaled for a message already popped, so we check the list again after waiting
+    while (ListIsEmpty(ipcObject->pagesMessages))
     {
-        KLOG(LOG_ERROR, "Invalid serverIdStr parameter");
-        return STATUS_NULL_PARAMETER;
+        ipcObject->criticalSection.Leave();
+        EventWait(&ipcObject->pagesMessagesEvent);
+        ipcObject->criticalSection.Enter();
     }
 
-    if (serverProcess == nullptr)
-    {
-        KLOG(LOG_ERROR, "Invalid serverProcess parameter");
-        return STATUS_NULL_PARAMETER;
-    }
+    pagesMessage = (IpcPagesMessage*)ListPop(&ipcObject->pagesMessages);
 
-    if (ipcObject == nullptr)
+    if (IsIpcObjectDrained(ipcObject))
+        ipcObject->pendingClientPriority = THREAD_PRIORITY_NORMAL;
+
+    ipcObject->criticalSection.Leave();
+
+    status = _AllocateMemory(serverProcess, pagesMessage->nbPages * PAGE_SIZE, &serverBuffer);
+    if (FAILED(status))
     {
-        KLOG(LOG_ERROR, "Invalid ipcObject parameter");
-        return STATUS_NULL_PARAMETER;
+        KLOG(LOG_ERROR, "_AllocateMemory() failed with code %t", status);
+        goto clean;
     }
 
-    object = (IpcObject*)HeapAlloc(sizeof(IpcObject));
-    if (object == nullptr)
+    // Only this vad may be released by SysIpcReleaseMemory
+    status = serverProcess->SetMemoryOrigin(serverBuffer, VAD_ORIGIN_RECEIVE_PAGES);
+    if (FAILED(status))
     {
-        status = STATUS_ALLOC_FAILED;
+        KLOG(LOG_ERROR, "Process::SetMemoryOrigin() failed with code %t", status);
         goto clean;
     }
 
-    serverIdStrCopy = (char*)HeapAlloc(StrLen(serverIdStr) + 1);
-    if (object == nullptr)
+    status = serverProcess->AttachPhysicalPages(serverBuffer, pagesMessage->pAddrs, pagesMessage->nbPages, pagesMessage->copyOnWrite);
+    if (FAILED(status))
     {
-        status = STATUS_ALLOC_FAILED;
+        KLOG(LOG_ERROR, "Process::AttachPhysicalPages() failed with code %t", status);
         goto clean;
     }
 
-    StrCpy(serverIdStr, serverIdStrCopy);
-
-    object->handle = handle;
-    object->id = serverIdStrCopy;
-    object->serverProcess = (Process *)serverProcess;
-    object->buffer.Init();
+    *message = serverBuffer;
+    *size = pagesMessage->size;
 
-    *ipcObject = object;
-    object = nullptr;
+    serverBuffer = nullptr;
 
     status = STATUS_SUCCESS;
 
 clean:
+    if (serverBuffer != nullptr)
+    {
+        serverProcess->ReleaseMemory(serverBuffer);
+        serverBuffer = nullptr;
+    }
+
+    if (pagesMessage != nullptr)
+    {
+        // The message couldn't be delivered, the references on its pages are dropped
+        if (FAILED(status))
+        {
+            for (unsigned int i = 0; i < pagesMessage->nbPages; i++)
+                gPmm.ReleasePage((void*)pagesMessage->pAddrs[i]);
+        }
+
+        HeapFree(pagesMessage->pAddrs);
+        HeapFree(pagesMessage);
+        pagesMessage = nullptr;
+    }
+
     return status;
+}
+
+KeStatus IpcHandler::Disconnect(const IpcHandle handle, Process* const clientProcess)
+{
+    KeStatus status = STATUS_FAILURE;
+    IpcObject * ipcObject = nullptr;
+
+    if (handle == 0)
+    {
+        KLOG(LOG_ERROR, "Invalid handle parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (clientProcess == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid clientProcess parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    ipcObject = _registry.FindByHandle(handle);
+    if (ipcObject == nullptr)
+    {
+        KLOG(LOG_DEBUG, "Didn't found ipc object for handle %d", handle);
+        return IPC_STATUS_SERVER_NOT_FOUND;
+    }
+
+    status = _DisconnectClient(ipcObject, clientProcess);
+    if (FAILED(status))
+    {
+        KLOG(LOG_DEBUG, "_DisconnectClient() failed with code %t", status);
+        return status;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus IpcHandler::Call(const IpcHandle handle, Thread* const clientThread, IpcRegisterMessage* const message)
+{
+    KeStatus status = STATUS_FAILURE;
+    IpcObject * ipcObject = nullptr;
+    Thread * serverThread = nullptr;
+    IpcCall call;
+
+    if (handle == 0)
+    {
+        KLOG(LOG_ERROR, "Invalid handle parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (clientThread == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid clientThread parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (message == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid message parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    ipcObject = _registry.FindByHandle(handle);
+    if (ipcObject == nullptr)
+    {
+        KLOG(LOG_DEBUG, "Didn't found ipc object for handle %d", handle);
+        return IPC_STATUS_SERVER_NOT_FOUND;
+    }
+
+    // A ipc server can't call itself, it would wait for its own reply
+    if (clientThread->process == ipcObject->serverProcess)
+    {
+        KLOG(LOG_DEBUG, "A ipc server tried to call itself");
+        return IPC_STATUS_ACCESS_DENIED;
+    }
+
+    // The call lives on the client kernel stack : the client doesn't leave this function before
+    // the server replied, and the server doesn't touch it anymore once it replied
+    call.clientThread = clientThread;
+    call.message = *message;
+    call.replied = false;
+    call.replyEvent = EventCreate();
+
+    ipcObject->criticalSection.Enter();
+
+    ListPush(ipcObject->pendingCalls, &call);
+
+    _InheritClientPriority(ipcObject, clientThread);
+
+    // If the server is already waiting, we switch directly to it instead of waiting to be scheduled
+    serverThread = ipcObject->waitingServerThread;
+    EventSignal(&ipcObject->pendingCallsEvent);
+
+    while (call.replied == false)
+    {
+        ipcObject->criticalSection.Leave();
+
+        if (serverThread != nullptr)
+            EventWaitAndHandOff(&call.replyEvent, serverThread);
+        else
+            EventWait(&call.replyEvent);
+
+        serverThread = nullptr;
+        ipcObject->criticalSection.Enter();
+    }
+
+    *message = call.message;
+
+    ipcObject->criticalSection.Leave();
+
+    status = STATUS_SUCCESS;
+
+    return status;
+}
+
+KeStatus IpcHandler::ReplyWait(const IpcHandle handle, Thread* const serverThread, IpcRegisterMessage* const message)
+{
+    KeStatus status = STATUS_FAILURE;
+    IpcObject * ipcObject = nullptr;
+    IpcCall * call = nullptr;
+    Thread * clientThread = nullptr;
+
+    if (handle == 0)
+    {
+        KLOG(LOG_ERROR, "Invalid handle parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (serverThread == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid serverThread parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (message == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid message parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    ipcObject = _registry.FindByHandle(handle);
+    if (ipcObject == nullptr)
+    {
+        KLOG(LOG_DEBUG, "Didn't found ipc object for handle %d", handle);
+        return IPC_STATUS_SERVER_NOT_FOUND;
+    }
+
+    // An ipc client can't wait for calls, but only make one
+    if (serverThread->process != ipcObject->serverProcess)
+    {
+        KLOG(LOG_DEBUG, "An ipc client tried to wait for calls");
+        return IPC_STATUS_ACCESS_DENIED;
+    }
+
+    ipcObject->criticalSection.Enter();
+
+    // Replying to the previous call, the client leaves Call() once it gets the critical section back
+    if (ipcObject->currentCall != nullptr)
+    {
+        call = ipcObject->currentCall;
+        ipcObject->currentCall = nullptr;
+
+        clientThread = call->clientThread;
+        call->message = *message;
+        call->replied = true;
+        EventSignal(&call->replyEvent);
+        call = nullptr;
+    }
+
+    // Same as Receive(), the previous call has been handled
+    _RestoreServerPriority(ipcObject);
+    ipcObject->serverThread = serverThread;
+    _InheritClientPriority(ipcObject, nullptr);
+
+    // If there is no pending call, the processor is directly given back to the client we replied to
+    while (ListIsEmpty(ipcObject->pendingCalls))
+    {
+        ipcObject->waitingServerThread = serverThread;
+        ipcObject->criticalSection.Leave();
+
+        if (clientThread != nullptr)
+            EventWaitAndHandOff(&ipcObject->pendingCallsEvent, clientThread);
+        else
+            EventWait(&ipcObject->pendingCallsEvent);
+
+        clientThread = nullptr;
+        ipcObject->criticalSection.Enter();
+    }
+
+    ipcObject->waitingServerThread = nullptr;
+
+    call = (IpcCall*)ListPop(&ipcObject->pendingCalls);
+    ipcObject->currentCall = call;
+    *message = call->message;
+
+    if (IsIpcObjectDrained(ipcObject))
+        ipcObject->pendingClientPriority = THREAD_PRIORITY_NORMAL;
+
+    ipcObject->criticalSection.Leave();
+
+    status = STATUS_SUCCESS;
+
+    return status;
+}
+
+KeStatus IpcHandler::CreateChannel(const IpcHandle handle, Process* const producerProcess, const unsigned int size, IpcHandle* const channelHandle, IpcChannelRing** const ring)
+{
+    KeStatus status = STATUS_FAILURE;
+    IpcObject * ipcObject = nullptr;
+    IpcChannel * channel = nullptr;
+    char * producerRing = nullptr;
+    IpcHandle localChannelHandle = INVALID_HANDLE_VALUE;
+    unsigned int nbPages = 0;
+    unsigned int nbReservedPages = 0;
+
+    if (handle == 0)
+    {
+        KLOG(LOG_ERROR, "Invalid handle parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (producerProcess == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid producerProcess parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (size < PAGE_SIZE || size > IPC_CHANNEL_MAX_SIZE || (size & (size - 1)) != 0)
+    {
+        KLOG(LOG_ERROR, "Invalid size parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (channelHandle == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid channelHandle parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (ring == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid ring parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    ipcObject = _registry.FindByHandle(handle);
+    if (ipcObject == nullptr)
+    {
+        KLOG(LOG_DEBUG, "Didn't found ipc object for handle %d", handle);
+        return IPC_STATUS_SERVER_NOT_FOUND;
+    }
+
+    if (producerProcess == ipcObject->serverProcess)
+    {
+        KLOG(LOG_DEBUG, "A ipc server tried to create a channel to itself");
+        return IPC_STATUS_ACCESS_DENIED;
+    }
+
+    // The ring header has its own page, so that the data ring is page aligned
+    nbPages = (size / PAGE_SIZE) + 1;
+
+    channel = (IpcChannel*)HeapAlloc(sizeof(IpcChannel));
+    if (channel == nullptr)
+    {
+        KLOG(LOG_ERROR, "Couldn't allocate %d bytes", sizeof(IpcChannel));
+        status = STATUS_ALLOC_FAILED;
+        goto clean;
+    }
+
+    channel->pAddrs = (u32*)HeapAlloc(nbPages * sizeof(u32));
+    if (channel->pAddrs == nullptr)
+    {
+        KLOG(LOG_ERROR, "Couldn't allocate %d bytes", nbPages * sizeof(u32));
+        status = STATUS_ALLOC_FAILED;
+        goto clean;
+    }
+
+    for (nbReservedPages = 0; nbReservedPages < nbPages; nbReservedPages++)
+    {
+        void * pAddr = gPmm.GetFreePage();
+        if (pAddr == nullptr)
+        {
+            KLOG(LOG_ERROR, "Pmm::GetFreePage() failed to find an available physical page");
+            status = STATUS_PHYSICAL_MEMORY_FULL;
+            goto clean;
+        }
+
+        channel->pAddrs[nbReservedPages] = (u32)pAddr;
+    }
+
+    channel->nbPages = nbPages;
+    channel->producerProcess = producerProcess;
+    channel->consumerProcess = nullptr;
+    channel->consumerRing = nullptr;
+    channel->doorbell = EventCreate();
+    // The producer one, and the consumer one held by the pending channels list
+    channel->references = 2;
+    channel->previous = nullptr;
+    channel->next = nullptr;
+
+    status = _AllocateMemory(producerProcess, nbPages * PAGE_SIZE, &producerRing);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "_AllocateMemory() failed with code %t", status);
+        goto clean;
+    }
+
+    // Both processes write in the ring, it is shared and never copy-on-write
+    status = producerProcess->AttachPhysicalPages(producerRing, channel->pAddrs, nbPages, false);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Process::AttachPhysicalPages() failed with code %t", status);
+        goto clean;
+    }
+
+    // The mapping holds its own references, released with the producer memory
+    for (unsigned int i = 0; i < nbPages; i++)
+        gPmm.AddPageReference((void*)channel->pAddrs[i]);
+
+    // The producer address space is the current one, the pages may hold the data of a previous owner
+    MemSet(producerRing, 0, nbPages * PAGE_SIZE);
+    ((IpcChannelRing*)producerRing)->size = size;
+
+    channel->producerRing = (IpcChannelRing*)producerRing;
+
+    status = _registry.AddChannel(channel, &localChannelHandle);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "IpcRegistry::AddChannel() failed with code %t", status);
+        goto clean;
+    }
+
+    channel->handle = localChannelHandle;
+
+    _channelsCriticalSection.Enter();
+
+    channel->next = _channels;
+    if (_channels != nullptr)
+        _channels->previous = channel;
+    _channels = channel;
+
+    _channelsCriticalSection.Leave();
+
+    ipcObject->criticalSection.Enter();
+    ListPush(ipcObject->pendingChannels, channel);
+    ipcObject->criticalSection.Leave();
+
+    EventSignal(&ipcObject->pendingChannelsEvent);
+
+    *channelHandle = localChannelHandle;
+    *ring = (IpcChannelRing*)producerRing;
+
+    channel = nullptr;
+    producerRing = nullptr;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    if (producerRing != nullptr)
+    {
+        producerProcess->ReleaseMemory(producerRing);
+        producerRing = nullptr;
+    }
+
+    if (channel != nullptr)
+    {
+        if (channel->pAddrs != nullptr)
+        {
+            for (unsigned int i = 0; i < nbReservedPages; i++)
+                gPmm.ReleasePage((void*)channel->pAddrs[i]);
+
+            HeapFree(channel->pAddrs);
+        }
+
+        HeapFree(channel);
+        channel = nullptr;
+    }
+
+    return status;
+}
+
+KeStatus IpcHandler::AcceptChannel(const IpcHandle handle, Process* const consumerProcess, IpcHandle* const channelHandle, IpcChannelRing** const ring)
+{
+    KeStatus status = STATUS_FAILURE;
+    IpcObject * ipcObject = nullptr;
+    IpcChannel * channel = nullptr;
+    char * consumerRing = nullptr;
+
+    if (handle == 0)
+    {
+        KLOG(LOG_ERROR, "Invalid handle parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (consumerProcess == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid consumerProcess parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (channelHandle == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid channelHandle parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (ring == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid ring parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    ipcObject = _registry.FindByHandle(handle);
+    if (ipcObject == nullptr)
+    {
+        KLOG(LOG_DEBUG, "Didn't found ipc object for handle %d", handle);
+        return IPC_STATUS_SERVER_NOT_FOUND;
+    }
+
+    if (consumerProcess != ipcObject->serverProcess)
+    {
+        KLOG(LOG_DEBUG, "An ipc client tried to accept a channel");
+        return IPC_STATUS_ACCESS_DENIED;
+    }
+
+    ipcObject->criticalSection.Enter();
+
+    while (channel == nullptr)
+    {
+        while (ListIsEmpty(ipcObject->pendingChannels))
+        {
+            ipcObject->criticalSection.Leave();
+            EventWait(&ipcObject->pendingChannelsEvent);
+            ipcObject->criticalSection.Enter();
+        }
+
+        channel = (IpcChannel*)ListPop(&ipcObject->pendingChannels);
+
+        // The producer closed the channel before it was accepted, the reference of the list is the last one
+        if (channel->producerProcess == nullptr)
+        {
+            _ReleaseChannel(channel);
+            channel = nullptr;
+        }
+    }
+
+    ipcObject->criticalSection.Leave();
+
+    status = _AllocateMemory(consumerProcess, channel->nbPages * PAGE_SIZE, &consumerRing);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "_AllocateMemory() failed with code %t", status);
+        goto clean;
+    }
+
+    status = consumerProcess->AttachPhysicalPages(consumerRing, channel->pAddrs, channel->nbPages, false);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Process::AttachPhysicalPages() failed with code %t", status);
+        goto clean;
+    }
+
+    for (unsigned int i = 0; i < channel->nbPages; i++)
+        gPmm.AddPageReference((void*)channel->pAddrs[i]);
+
+    channel->consumerProcess = consumerProcess;
+    channel->consumerRing = (IpcChannelRing*)consumerRing;
+
+    *channelHandle = channel->handle;
+    *ring = (IpcChannelRing*)consumerRing;
+
+    channel = nullptr;
+    consumerRing = nullptr;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    if (consumerRing != nullptr)
+    {
+        consumerProcess->ReleaseMemory(consumerRing);
+        consumerRing = nullptr;
+    }
+
+    // The channel couldn't be accepted, it is given back to the server
+    if (channel != nullptr)
+    {
+        ipcObject->criticalSection.Enter();
+        ListPush(ipcObject->pendingChannels, channel);
+        ipcObject->criticalSection.Leave();
+    }
+
+    return status;
+}
+
+KeStatus IpcHandler::ChannelWait(const IpcHandle channelHandle, Process* const process, const u32 * const word, const u32 expectedValue)
+{
+    KeStatus status = STATUS_FAILURE;
+    IpcChannel * channel = nullptr;
+    IpcChannelRing * ring = nullptr;
+
+    if (process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid process parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    // The reference keeps the doorbell valid while the thread waits on it
+    channel = _AcquireChannel(channelHandle);
+    if (channel == nullptr)
+    {
+        KLOG(LOG_DEBUG, "Didn't found channel for handle %d", channelHandle);
+        return IPC_STATUS_SERVER_NOT_FOUND;
+    }
+
+    ring = GetChannelRing(channel, process);
+    if (ring == nullptr)
+    {
+        status = IPC_STATUS_ACCESS_DENIED;
+        goto clean;
+    }
+
+    // Only the ring header words can be waited on, the address is checked before being read
+    if ((u32)word < (u32)ring || (u32)word >= (u32)ring + PAGE_SIZE || ((u32)word & (sizeof(u32) - 1)) != 0)
+    {
+        KLOG(LOG_DEBUG, "Invalid word parameter %x", word);
+        status = STATUS_INVALID_PARAMETER;
+        goto clean;
+    }
+
+    // The event stays signaled if the other side rang the doorbell after this check, so no wake up is lost.
+    // The other side never rings it again once it closed the channel.
+    if (*(volatile const u32*)word == expectedValue && !ring->closed)
+        EventWait(&channel->doorbell);
+
+    status = STATUS_SUCCESS;
+
+clean:
+    _ReleaseChannel(channel);
+
+    return status;
+}
+
+KeStatus IpcHandler::ChannelWake(const IpcHandle channelHandle, Process* const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    IpcChannel * channel = nullptr;
+
+    if (process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid process parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    channel = _AcquireChannel(channelHandle);
+    if (channel == nullptr)
+    {
+        KLOG(LOG_DEBUG, "Didn't found channel for handle %d", channelHandle);
+        return IPC_STATUS_SERVER_NOT_FOUND;
+    }
+
+    if (GetChannelRing(channel, process) == nullptr)
+    {
+        status = IPC_STATUS_ACCESS_DENIED;
+        goto clean;
+    }
+
+    EventSignal(&channel->doorbell);
+
+    status = STATUS_SUCCESS;
+
+clean:
+    _ReleaseChannel(channel);
+
+    return status;
+}
+
+KeStatus IpcHandler::CloseChannel(const IpcHandle channelHandle, Process* const process)
+{
+    KeStatus status = STATUS_FAILURE;
+    IpcChannel * channel = nullptr;
+    IpcChannelRing * ring = nullptr;
+    IpcChannelRing * header = nullptr;
+
+    if (process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid process parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    channel = _AcquireChannel(channelHandle);
+    if (channel == nullptr)
+    {
+        KLOG(LOG_DEBUG, "Didn't found channel for handle %d", channelHandle);
+        return IPC_STATUS_SERVER_NOT_FOUND;
+    }
+
+    // The side is detached first, so that a second close of the same side fails
+    _channelsCriticalSection.Enter();
+
+    if (process == channel->producerProcess)
+    {
+        ring = channel->producerRing;
+        channel->producerProcess = nullptr;
+        channel->producerRing = nullptr;
+    }
+    else if (process == channel->consumerProcess)
+    {
+        ring = channel->consumerRing;
+        channel->consumerProcess = nullptr;
+        channel->consumerRing = nullptr;
+    }
+
+    _channelsCriticalSection.Leave();
+
+    if (ring == nullptr)
+    {
+        status = IPC_STATUS_ACCESS_DENIED;
+        goto clean;
+    }
+
+    // The flag is written through the kernel map window, the other side ring may not be mapped yet
+    header = (IpcChannelRing*)gKMap.Map(channel->pAddrs[0]);
+    if (header != nullptr)
+    {
+        header->closed = 1;
+        gKMap.Unmap(header);
+    }
+    else
+    {
+        KLOG(LOG_ERROR, "KMapWindow::Map() failed, the other side isn't told the channel is closed");
+    }
+
+    // The mapping references on the ring pages are released with the vad, the channel keeps its own ones
+    status = process->ReleaseMemory(ring);
+    if (FAILED(status))
+        KLOG(LOG_ERROR, "Process::ReleaseMemory() failed with code %t", status);
+
+    EventSignal(&channel->doorbell);
+
+    // The reference of the closed side
+    _ReleaseChannel(channel);
+
+    status = STATUS_SUCCESS;
+
+clean:
+    _ReleaseChannel(channel);
+
+    return status;
+}
+
+void IpcHandler::ReleaseProcess(Process* const process)
+{
+    if (process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid process parameter");
+        return;
+    }
+
+    // A channel is closed outside of the critical section, the chain is walked again from its head after each one
+    while (1)
+    {
+        IpcHandle channelHandle = INVALID_HANDLE_VALUE;
+
+        _channelsCriticalSection.Enter();
+
+        for (IpcChannel * channel = _channels; channel != nullptr; channel = channel->next)
+        {
+            if (channel->producerProcess == process || channel->consumerProcess == process)
+            {
+                channelHandle = channel->handle;
+                break;
+            }
+        }
+
+        _channelsCriticalSection.Leave();
+
+        if (channelHandle == INVALID_HANDLE_VALUE)
+            break;
+
+        CloseChannel(channelHandle, process);
+    }
+
+    // Ipc objects are never removed, the chain can be walked from a snapshot of its head
+    _serversCriticalSection.Enter();
+    IpcObject * ipcObject = _servers;
+    _serversCriticalSection.Leave();
+
+    for (; ipcObject != nullptr; ipcObject = ipcObject->next)
+    {
+        if (ipcObject->serverProcess != process)
+            _DisconnectClient(ipcObject, process);
+    }
+}
+
+KeStatus IpcHandler::WaitMultiple(Process* const process, IpcWaitEntry* const entries, const unsigned int nbEntries, unsigned int* const nbReady)
+{
+    KeStatus status = STATUS_FAILURE;
+    IpcObject * ipcObjects[IPC_WAIT_MAX_ENTRIES];
+    IpcChannel * channels[IPC_WAIT_MAX_ENTRIES];
+    IpcChannelRing * rings[IPC_WAIT_MAX_ENTRIES];
+    EventWatcher watchers[IPC_WAIT_MAX_ENTRIES * IPC_WAIT_MAX_WATCHERS_PER_ENTRY];
+    Event * watchedEvents[IPC_WAIT_MAX_ENTRIES * IPC_WAIT_MAX_WATCHERS_PER_ENTRY];
+    unsigned int nbWatchers = 0;
+    unsigned int nbReadyEntries = 0;
+    Event readyEvent = EventCreate();
+
+    if (process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid process parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (entries == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid entries parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (nbEntries == 0 || nbEntries > IPC_WAIT_MAX_ENTRIES)
+    {
+        KLOG(LOG_ERROR, "Invalid nbEntries parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (nbReady == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid nbReady parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    for (unsigned int index = 0; index < nbEntries; index++)
+        channels[index] = nullptr;
+
+    // Every handle is checked before anything is watched, so that there is only the channel references to drop on failure
+    for (unsigned int index = 0; index < nbEntries; index++)
+    {
+        unsigned int allowedEvents = 0;
+
+        entries[index].readyEvents = 0;
+        ipcObjects[index] = _registry.FindByHandle(entries[index].handle);
+        rings[index] = nullptr;
+
+        if (ipcObjects[index] != nullptr)
+        {
+            if (process != ipcObjects[index]->serverProcess)
+            {
+                status = IPC_STATUS_ACCESS_DENIED;
+                goto clean;
+            }
+
+            allowedEvents = IPC_WAIT_SERVER_EVENTS;
+        }
+        else
+        {
+            // The reference keeps the doorbell watched valid until the end of the wait
+            channels[index] = _AcquireChannel(entries[index].handle);
+            if (channels[index] == nullptr)
+            {
+                KLOG(LOG_DEBUG, "Didn't found ipc object or channel for handle %d", entries[index].handle);
+                status = IPC_STATUS_SERVER_NOT_FOUND;
+                goto clean;
+            }
+
+            if (process == channels[index]->consumerProcess)
+            {
+                rings[index] = channels[index]->consumerRing;
+                allowedEvents = IPC_WAIT_CHANNEL_READABLE;
+            }
+            else if (process == channels[index]->producerProcess)
+            {
+                rings[index] = channels[index]->producerRing;
+                allowedEvents = IPC_WAIT_CHANNEL_WRITABLE;
+            }
+            else
+            {
+                status = IPC_STATUS_ACCESS_DENIED;
+                goto clean;
+            }
+
+            watchedEvents[nbWatchers++] = &channels[index]->doorbell;
+        }
+
+        if (entries[index].events == 0 || (entries[index].events & ~allowedEvents) != 0)
+        {
+            KLOG(LOG_DEBUG, "Invalid events %x for handle %d", entries[index].events, entries[index].handle);
+            status = STATUS_INVALID_PARAMETER;
+            goto clean;
+        }
+
+        if (ipcObjects[index] != nullptr)
+        {
+            if (entries[index].events & IPC_WAIT_MESSAGE)
+                watchedEvents[nbWatchers++] = &ipcObjects[index]->messagesEvent;
+            if (entries[index].events & IPC_WAIT_PAGES_MESSAGE)
+                watchedEvents[nbWatchers++] = &ipcObjects[index]->pagesMessagesEvent;
+            if (entries[index].events & IPC_WAIT_CHANNEL_PENDING)
+                watchedEvents[nbWatchers++] = &ipcObjects[index]->pendingChannelsEvent;
+        }
+    }
+
+    // The events are watched before the first check, a signal coming in between is kept by the ready event
+    for (unsigned int index = 0; index < nbWatchers; index++)
+    {
+        watchers[index].target = &readyEvent;
+        watchers[index].next = nullptr;
+        EventAddWatcher(watchedEvents[index], &watchers[index]);
+    }
+
+    // The other side of a channel only rings the doorbell if it sees this side waiting
+    for (unsigned int index = 0; index < nbEntries; index++)
+    {
+        if (channels[index] == nullptr || GetChannelRing(channels[index], process) != rings[index])
+            continue;
+
+        if (entries[index].events & IPC_WAIT_CHANNEL_READABLE)
+            rings[index]->consumerWaiting = 1;
+        else if (entries[index].events & IPC_WAIT_CHANNEL_WRITABLE)
+            rings[index]->producerWaiting = 1;
+    }
+
+    __sync_synchronize();
+
+    while (1)
+    {
+        nbReadyEntries = 0;
+
+        for (unsigned int index = 0; index < nbEntries; index++)
+        {
+            if (ipcObjects[index] != nullptr)
+                entries[index].readyEvents = GetIpcObjectReadyEvents(ipcObjects[index], entries[index].events);
+            // Another thread of the process closed the channel and unmapped its ring, the next ring access fails in user mode
+            else if (GetChannelRing(channels[index], process) != rings[index])
+                entries[index].readyEvents = entries[index].events;
+            else
+                entries[index].readyEvents = GetChannelReadyEvents(rings[index], entries[index].events);
+
+            if (entries[index].readyEvents != 0)
+                nbReadyEntries++;
+        }
+
+        if (nbReadyEntries > 0)
+            break;
+
+        EventWait(&readyEvent);
+    }
+
+    for (unsigned int index = 0; index < nbEntries; index++)
+    {
+        if (channels[index] == nullptr || GetChannelRing(channels[index], process) != rings[index])
+            continue;
+
+        if (entries[index].events & IPC_WAIT_CHANNEL_READABLE)
+            rings[index]->consumerWaiting = 0;
+        else if (entries[index].events & IPC_WAIT_CHANNEL_WRITABLE)
+            rings[index]->producerWaiting = 0;
+    }
+
+    for (unsigned int index = 0; index < nbWatchers; index++)
+        EventRemoveWatcher(watchedEvents[index], &watchers[index]);
+
+    *nbReady = nbReadyEntries;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    for (unsigned int index = 0; index < nbEntries; index++)
+    {
+        if (channels[index] != nullptr)
+            _ReleaseChannel(channels[index]);
+    }
+
+    return status;
+}
+
+KeStatus IpcHandler::ReleaseMemory(Process* const process, void* ptr)
+{
+    KeStatus status = STATUS_FAILURE;
+    VadOrigin origin = VAD_ORIGIN_KERNEL;
+
+    if (process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid process parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (ptr == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid ptr parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = process->GetMemoryOrigin(ptr, &origin);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Process::GetMemoryOrigin() failed with code %t", status);
+        goto clean;
+    }
+
+    // The other vads (rings, stacks, images...) are still used by the kernel
+    if (origin != VAD_ORIGIN_RECEIVE_PAGES)
+    {
+        KLOG(LOG_ERROR, "%x wasn't mapped by IpcHandler::ReceivePages()", ptr);
+        status = IPC_STATUS_ACCESS_DENIED;
+        goto clean;
+    }
+
+    status = process->ReleaseMemory(ptr);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Process::ReleaseMemory() failed with code %t", status);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
+KeStatus IpcHandler::_GetClientQueue(IpcObject* const ipcObject, Process* const clientProcess, IpcClientQueue** const clientQueue)
+{
+    KeStatus status = STATUS_FAILURE;
+    IpcClientQueue * existingQueue = nullptr;
+    IpcClientQueue * newQueue = nullptr;
+    bool bufferInitialized = false;
+
+    ipcObject->criticalSection.Enter();
+    existingQueue = FindClientQueue(ipcObject, clientProcess);
+    ipcObject->criticalSection.Leave();
+
+    if (existingQueue != nullptr)
+    {
+        *clientQueue = existingQueue;
+        return STATUS_SUCCESS;
+    }
+
+    // The queue is allocated out of the critical section, another thread of the client may add one in the meantime
+    newQueue = (IpcClientQueue*)HeapAlloc(sizeof(IpcClientQueue));
+    if (newQueue == nullptr)
+    {
+        KLOG(LOG_ERROR, "Couldn't allocate %d bytes", sizeof(IpcClientQueue));
+        status = STATUS_ALLOC_FAILED;
+        goto clean;
+    }
+
+    newQueue->buffer = IpcBuffer();
+    newQueue->clientProcess = clientProcess;
+    newQueue->nbMessages = 0;
+    newQueue->nbSenders = 0;
+    newQueue->disconnected = false;
+    newQueue->next = nullptr;
+
+    status = newQueue->buffer.Init();
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "IpcBuffer::Init() failed with code %t", status);
+        goto clean;
+    }
+
+    bufferInitialized = true;
+
+    status = _registry.AddClient(newQueue, &newQueue->handle);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "IpcRegistry::AddClient() failed with code %t", status);
+        goto clean;
+    }
+
+    ipcObject->criticalSection.Enter();
+
+    existingQueue = FindClientQueue(ipcObject, clientProcess);
+    if (existingQueue == nullptr)
+    {
+        newQueue->next = ipcObject->clientQueues;
+        ipcObject->clientQueues = newQueue;
+        existingQueue = newQueue;
+        newQueue = nullptr;
+    }
+
+    ipcObject->criticalSection.Leave();
+
+    if (newQueue != nullptr)
+        _registry.Remove(newQueue->handle);
+
+    *clientQueue = existingQueue;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    if (newQueue != nullptr)
+    {
+        if (bufferInitialized)
+            newQueue->buffer.Release();
+
+        HeapFree(newQueue);
+        newQueue = nullptr;
+    }
+
+    return status;
+}
+
+KeStatus IpcHandler::_DisconnectClient(IpcObject* const ipcObject, Process* const clientProcess)
+{
+    IpcClientQueue * clientQueue = nullptr;
+    IpcClientQueue ** link = nullptr;
+    bool freeClientQueue = false;
+
+    ipcObject->criticalSection.Enter();
+
+    for (link = &ipcObject->clientQueues; *link != nullptr; link = &(*link)->next)
+    {
+        if ((*link)->clientProcess == clientProcess)
+        {
+            clientQueue = *link;
+            *link = clientQueue->next;
+            break;
+        }
+    }
+
+    if (clientQueue == nullptr)
+    {
+        ipcObject->criticalSection.Leave();
+        return STATUS_NOT_FOUND;
+    }
+
+    // The messages the server didn't read are dropped with the queue
+    if (ipcObject->nextClientQueue == clientQueue)
+        ipcObject->nextClientQueue = clientQueue->next;
+
+    ipcObject->nbPendingMessages -= clientQueue->nbMessages;
+    if (IsIpcObjectDrained(ipcObject))
+        ipcObject->pendingClientPriority = THREAD_PRIORITY_NORMAL;
+
+    // Client threads waiting for room in the queue give up, the last one frees it
+    clientQueue->disconnected = true;
+    freeClientQueue = clientQueue->nbSenders == 0;
+    if (!freeClientQueue)
+        EventSignal(&clientQueue->buffer.ReadyToWriteEvent);
+
+    ipcObject->criticalSection.Leave();
+
+    if (freeClientQueue)
+        _FreeClientQueue(clientQueue);
+
+    return STATUS_SUCCESS;
+}
+
+void IpcHandler::_FreeClientQueue(IpcClientQueue* const clientQueue)
+{
+    _registry.Remove(clientQueue->handle);
+    clientQueue->buffer.Release();
+    HeapFree(clientQueue);
+}
+
+KeStatus IpcHandler::_AllocateMemory(Process* const process, unsigned int size, char** const buffer)
+{
+    KeStatus status = STATUS_FAILURE;
+
+    if (process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid process parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (size == 0)
+    {
+        KLOG(LOG_ERROR, "Invalid size parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (buffer == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid buffer parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    // No physical page is reserved, the pages of the message are mapped in the vad afterwards
+    status = process->AllocateMemory(size, false, (void**)buffer);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Process::AllocateMemory() failed with code %t", status);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
+IpcChannel * IpcHandler::_AcquireChannel(const IpcHandle channelHandle)
+{
+    IpcChannel * channel = nullptr;
+
+    _channelsCriticalSection.Enter();
+
+    channel = _registry.FindChannelByHandle(channelHandle);
+    if (channel != nullptr)
+        channel->references++;
+
+    _channelsCriticalSection.Leave();
+
+    return channel;
+}
+
+void IpcHandler::_ReleaseChannel(IpcChannel* const channel)
+{
+    bool lastReference = false;
+
+    _channelsCriticalSection.Enter();
+
+    channel->references--;
+
+    // The handle is removed under the critical section, so that _AcquireChannel() never finds a channel being freed
+    if (channel->references == 0)
+    {
+        lastReference = true;
+
+        _registry.Remove(channel->handle);
+
+        if (channel->previous != nullptr)
+            channel->previous->next = channel->next;
+        else
+            _channels = channel->next;
+
+        if (channel->next != nullptr)
+            channel->next->previous = channel->previous;
+    }
+
+    _channelsCriticalSection.Leave();
+
+    if (!lastReference)
+        return;
+
+    for (unsigned int i = 0; i < channel->nbPages; i++)
+        gPmm.ReleasePage((void*)channel->pAddrs[i]);
+
+    HeapFree(channel->pAddrs);
+    HeapFree(channel);
+}
+
+void IpcHandler::_InheritClientPriority(IpcObject* const ipcObject, Thread* const clientThread)
+{
+    Thread * serverThread = ipcObject->serverThread;
+
+    if (clientThread != nullptr && clientThread->threadPriority > ipcObject->pendingClientPriority)
+        ipcObject->pendingClientPriority = clientThread->threadPriority;
+
+    // The server didn't call Receive() yet, it will inherit the pending priority when it does
+    if (serverThread == nullptr)
+        return;
+
+    while (serverThread->threadPriority < ipcObject->pendingClientPriority)
+    {
+        serverThread->RaisePriorityLevel();
+        ipcObject->inheritedPriorityLevels++;
+    }
+}
+
+void IpcHandler::_RestoreServerPriority(IpcObject* const ipcObject)
+{
+    Thread * serverThread = ipcObject->serverThread;
+
+    if (serverThread == nullptr)
+        return;
+
+    while (ipcObject->inheritedPriorityLevels > 0)
+    {
+        serverThread->LowerPriorityLevel();
+        ipcObject->inheritedPriorityLevels--;
+    }
+}
+
+KeStatus IpcObject::Create(const char * serverIdStr, Process * const serverProcess, IpcObject** const ipcObject)
+{
+    KeStatus status = STATUS_FAILURE;
+    IpcObject * object = nullptr;
+    char * serverIdStrCopy = nullptr;
+
+    if (serverIdStr == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid serverIdStr parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (serverProcess == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid serverProcess parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (ipcObject == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid ipcObject parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    object = (IpcObject*)HeapAlloc(sizeof(IpcObject));
+    if (object == nullptr)
+    {
+        status = STATUS_ALLOC_FAILED;
+        goto clean;
+    }
+
+    serverIdStrCopy = (char*)HeapAlloc(StrLen(serverIdStr) + 1);
+    if (serverIdStrCopy == nullptr)
+    {
+        status = STATUS_ALLOC_FAILED;
+        goto clean;
+    }
+
+    StrCpy(serverIdStr, serverIdStrCopy);
+
+    object->handle = INVALID_HANDLE_VALUE;
+    object->id = serverIdStrCopy;
+    object->serverProcess = (Process *)serverProcess;
+    object->clientQueues = nullptr;
+    object->nextClientQueue = nullptr;
+    object->nbPendingMessages = 0;
+    object->messagesEvent = EventCreate();
+    object->criticalSection = CriticalSection();
+    object->serverThread = nullptr;
+    object->pendingClientPriority = THREAD_PRIORITY_NORMAL;
+    object->inheritedPriorityLevels = 0;
+    object->pagesMessages = ListCreate();
+    object->pagesMessagesEvent = EventCreate();
+    object->pendingCalls = ListCreate();
+    object->pendingCallsEvent = EventCreate();
+    object->currentCall = nullptr;
+    object->waitingServerThread = nullptr;
+    object->pendingChannels = ListCreate();
+    object->pendingChannelsEvent = EventCreate();
+    object->next = nullptr;
+
+    *ipcObject = object;
+    object = nullptr;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    if (object != nullptr)
+    {
+        if (serverIdStrCopy != nullptr)
+            HeapFree(serverIdStrCopy);
+
+        HeapFree(object);
+        object = nullptr;
+    }
+
+    return status;
+}
+
+void IpcObject::Destroy(IpcObject * const ipcObject)
+{
+    if (ipcObject == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid ipcObject parameter");
+        return;
+    }
+
+    // Only used before the object is registered, no client can have a queue yet
+    ListDestroy(ipcObject->pagesMessages);
+    ListDestroy(ipcObject->pendingCalls);
+    ListDestroy(ipcObject->pendingChannels);
+
+    HeapFree(ipcObject->id);
+    HeapFree(ipcObject);
+}
+
+/// @brief Checks if every message sent to the ipc object has been received
+/// @warning The ipc object critical section must be held by the caller
+static bool IsIpcObjectDrained(IpcObject * const ipcObject)
+{
+    return ipcObject->nbPendingMessages == 0 && ListIsEmpty(ipcObject->pagesMessages) && ListIsEmpty(ipcObject->pendingCalls);
+}
+
+/// @brief Looks for the queue of a client process
+/// @warning The ipc object critical section must be held by the caller
+static IpcClientQueue * FindClientQueue(IpcObject * const ipcObject, Process * const clientProcess)
+{
+    for (IpcClientQueue * clientQueue = ipcObject->clientQueues; clientQueue != nullptr; clientQueue = clientQueue->next)
+    {
+        if (clientQueue->clientProcess == clientProcess)
+            return clientQueue;
+    }
+
+    return nullptr;
+}
+
+/// @brief Retrieves the first client queue holding a message, starting from the one served after the last message received
+/// @warning The ipc object critical section must be held by the caller, and at least one message must be pending
+static IpcClientQueue * GetNextClientQueue(IpcObject * const ipcObject)
+{
+    IpcClientQueue * clientQueue = (ipcObject->nextClientQueue != nullptr) ? ipcObject->nextClientQueue : ipcObject->clientQueues;
+
+    while (clientQueue->buffer.IsEmpty())
+        clientQueue = (clientQueue->next != nullptr) ? clientQueue->next : ipcObject->clientQueues;
+
+    return clientQueue;
+}
+
+/// @brief Retrieves which of the waited events of an ipc object are ready
+static unsigned int GetIpcObjectReadyEvents(IpcObject * const ipcObject, const unsigned int events)
+{
+    unsigned int readyEvents = 0;
+
+    ipcObject->criticalSection.Enter();
+
+    if ((events & IPC_WAIT_MESSAGE) && ipcObject->nbPendingMessages != 0)
+        readyEvents |= IPC_WAIT_MESSAGE;
+    if ((events & IPC_WAIT_PAGES_MESSAGE) && !ListIsEmpty(ipcObject->pagesMessages))
+        readyEvents |= IPC_WAIT_PAGES_MESSAGE;
+    if ((events & IPC_WAIT_CHANNEL_PENDING) && !ListIsEmpty(ipcObject->pendingChannels))
+        readyEvents |= IPC_WAIT_CHANNEL_PENDING;
+
+    ipcObject->criticalSection.Leave();
+
+    return readyEvents;
+}
+
+/// @brief Retrieves which of the waited events of a channel are ready, the ring must be mapped in the current address space
+static unsigned int GetChannelReadyEvents(const IpcChannelRing * const ring, const unsigned int events)
+{
+    const u32 head = ring->head;
+    const u32 tail = ring->tail;
+    unsigned int readyEvents = 0;
+
+    if ((events & IPC_WAIT_CHANNEL_READABLE) && head != tail)
+        readyEvents |= IPC_WAIT_CHANNEL_READABLE;
+    if ((events & IPC_WAIT_CHANNEL_WRITABLE) && head - tail < ring->size)
+        readyEvents |= IPC_WAIT_CHANNEL_WRITABLE;
+
+    // Nothing will change anymore, the caller must not wait for the other side
+    if (ring->closed)
+        readyEvents = events;
+
+    return readyEvents;
+}
+/// @brief Retrieves the ring of the side of a channel held by a process, nullptr if the process isn't a side or closed it
+static IpcChannelRing * GetChannelRing(IpcChannel * const channel, Process * const process)
+{
+    if (process == channel->producerProcess)
+        return channel->producerRing;
+
+    if (process == channel->consumerProcess)
+        return channel->consumerRing;
+
+    return nullptr;
 }
\ No newline at end of file
@@ -4,16 +4,15 @@
 #include <kernel/lib/List.hpp>
 #include <kernel/arch/x86/Process.hpp>
 #include <kernel/handle/HandleManager.h>
+#include <kernel/syscalls/UKSyscallsCommon.h>
+
+#include "IpcRegistry.hpp"
 
 /// @file
 
 /// @addgroup TaskGroup
 /// @{
 
-typedef unsigned int IpcHandle;
-
-struct IpcObject;
-
 class IpcHandler
 {
 public:
@@ -34,52 +33,193 @@ public:
     /// @param[out] ipcHandle Pointer that will hold the server IpcHandle
     KeStatus ConnectToServer(const char* serverIdStr, Process * const clientProcess, IpcHandle* const ipcHandle);
 
-    /// @brief Adds a given message sent my a given process to the list of messages associated to a given handle
+    /// @brief Adds a given message sent my a given process to the ring buffer associated to a given handle.
+    ///        The caller waits until there is room for the whole message.
     /// @param[in] handle The handle on a Ipc object
     /// @param[in] clientProcess The client process sending the message
     /// @param[in] message A pointer to the message. The pointed memory is in the client process address space.
+    /// @param[in] size The message size in bytes, at most IPC_MAX_MESSAGE_SIZE
+    /// @return IPC_STATUS_SUCCESS on success, IPC_STATUS_MESSAGE_TOO_BIG if size is above IPC_MAX_MESSAGE_SIZE, an error code otherwise
+    KeStatus Send(const IpcHandle handle, Process* const clientProcess, const char* message, const unsigned int size);
+
+    /// @brief Adds a single message gathered from several buffers, as Send() does, without assembling it first
+    /// @param[in] handle The handle on a Ipc object
+    /// @param[in] clientProcess The client process sending the message
+    /// @param[in] vectors The buffers making the message, in order. The array is in kernel memory, the buffers are in the client process address space.
+    /// @param[in] nbVectors The number of buffers, at most IPC_MAX_IO_VECTORS
+    /// @return IPC_STATUS_SUCCESS on success, IPC_STATUS_MESSAGE_TOO_BIG if the buffer sizes sum is above IPC_MAX_MESSAGE_SIZE, an error code otherwise
+    KeStatus SendV(const IpcHandle handle, Process* const clientProcess, const IpcIoVector * const vectors, const unsigned int nbVectors);
+
+    /// @brief Pops a message sent to the Ipc object, a message is never split nor merged with another one.
+    ///        Each client has its own queue, the oldest message of the next client holding one is popped (round-robin).
+    /// @param[in]  handle The handle on a Ipc object
+    /// @param[in]  serverProcess The server process receiving the message
+    /// @param[in]  buffer A pointer to the memory where the message is copied. The memory is allocated by the caller (user process),
+    ///             it is checked again once a message is there.
+    /// @param[in]  size The buffer size in bytes
+    /// @param[out] bytesRead A pointer that will hold the message size, in kernel memory
+    /// @param[out,opt] sender A pointer that will hold the identity of the client that sent the message, or nullptr
+    /// @return IPC_STATUS_SUCCESS on success, IPC_STATUS_BUFFER_TOO_SMALL if the message doesn't fit in the buffer (bytesRead holds the
+    ///         size needed and the message is kept), an error code otherwise
+    KeStatus Receive(const IpcHandle handle, Process* const serverProcess, char * const buffer, const unsigned int size, unsigned int * const bytesRead, IpcSenderInfo * const sender = nullptr);
+
+    /// @brief Adds a page aligned message to the list of pages messages associated to a given handle, without copying it.
+    ///        The physical pages holding the message are moved or shared (copy-on-write) with the server address space.
+    /// @param[in] handle The handle on a Ipc object
+    /// @param[in] clientProcess The client process sending the message
+    /// @param[in] message A page aligned pointer to the message. The pointed memory is in the client process address space.
     /// @param[in] size The message size in bytes
+    /// @param[in] keepAccess Boolean telling if the client keeps access to the message pages (copy-on-write), or if they are moved to the server
     /// @return IPC_STATUS_SUCCESS on success, an error code otherwise
-    KeStatus Send(const IpcHandle handle, Process* const clientProcess, const char* message, const unsigned int size);
+    KeStatus SendPages(const IpcHandle handle, Process* const clientProcess, const char* message, const unsigned int size, const bool keepAccess);
 
-    /// @brief Pops the next stacked message in the list associated to the Ipc object
+    /// @brief Pops the next pages message associated to the Ipc object and maps its pages in the server address space
     /// @param[in]  handle The handle on a Ipc object
     /// @param[in]  serverProcess The server process receiving the message
-    /// @param[in]  message A pointer that will hold a pointer to the message. The memory is allocated by the caller (user process).
-    /// @param[in]  size The message size in bytes
-    /// @param[out] bytesRead A pointer that will hold the number of bytes copied in the buffer
+    /// @param[out] message A pointer in kernel memory that will hold a pointer to the message in the server address space.
+    ///             It must be released with ReleaseMemory().
+    /// @param[out] size A pointer in kernel memory that will hold the message size in bytes
+    /// @return IPC_STATUS_SUCCESS on success, an error code otherwise
+    KeStatus ReceivePages(const IpcHandle handle, Process* const serverProcess, char ** const message, unsigned int * const size);
+
+    /// @brief Disconnects a client from a server : its queue is removed with the messages the server didn't read yet,
+    ///        and freed once no thread of the client sends to it anymore. The client gets a new queue on its next message.
+    /// @param[in] handle The handle on a Ipc object
+    /// @param[in] clientProcess The client process disconnecting
+    /// @return IPC_STATUS_SUCCESS on success, an error code otherwise
+    KeStatus Disconnect(const IpcHandle handle, Process* const clientProcess);
+
+    /// @brief Sends a message to the server and waits for its reply. If the server thread is waiting in ReplyWait(),
+    ///        the processor is directly given to it, and given back to the client when it replies.
+    /// @param[in]     handle The handle on a Ipc object
+    /// @param[in]     clientThread The client thread sending the message
+    /// @param[in,out] message The message sent to the server, it holds the server reply on success
     /// @return IPC_STATUS_SUCCESS on success, an error code otherwise
-    KeStatus Receive(const IpcHandle handle, Process* const serverProcess, char * const buffer, const unsigned int size, unsigned int * const bytesRead);
+    KeStatus Call(const IpcHandle handle, Thread* const clientThread, IpcRegisterMessage* const message);
 
-    /// @brief Releases memory allocated for an IPC in a process address space
+    /// @brief Replies to the last call received by the server, if any, and waits for the next call
+    /// @param[in]     handle The handle on a Ipc object
+    /// @param[in]     serverThread The server thread replying
+    /// @param[in,out] message The reply to the last call, it holds the next call message on success
+    /// @return IPC_STATUS_SUCCESS on success, an error code otherwise
+    KeStatus ReplyWait(const IpcHandle handle, Thread* const serverThread, IpcRegisterMessage* const message);
+
+    /// @brief Creates a channel : a ring buffer mapped in the producer and consumer address spaces, and offers it to a server.
+    ///        The producer and the consumer exchange bytes without syscalls, they only call ChannelWait() and ChannelWake() to block and wake up.
+    /// @param[in]  handle The handle on the Ipc object of the server that will consume the channel
+    /// @param[in]  producerProcess The client process creating the channel
+    /// @param[in]  size The data ring size in bytes, a power of two between IPC_PAGE_SIZE and IPC_CHANNEL_MAX_SIZE
+    /// @param[out] channelHandle A pointer that will hold the channel handle
+    /// @param[out] ring A pointer that will hold the address of the ring in the producer address space
+    /// @return IPC_STATUS_SUCCESS on success, an error code otherwise
+    KeStatus CreateChannel(const IpcHandle handle, Process* const producerProcess, const unsigned int size, IpcHandle* const channelHandle, IpcChannelRing** const ring);
+
+    /// @brief Waits for the next channel offered to the server and maps its ring in the server address space
+    /// @param[in]  handle The handle on a Ipc object
+    /// @param[in]  consumerProcess The server process accepting the channel
+    /// @param[out] channelHandle A pointer that will hold the channel handle
+    /// @param[out] ring A pointer that will hold the address of the ring in the consumer address space
+    /// @return IPC_STATUS_SUCCESS on success, an error code otherwise
+    KeStatus AcceptChannel(const IpcHandle handle, Process* const consumerProcess, IpcHandle* const channelHandle, IpcChannelRing** const ring);
+
+    /// @brief Waits for the channel doorbell if a word of the ring still holds the expected value, as a futex would do.
+    ///        The caller must check its condition again when it returns.
+    /// @param[in] channelHandle The channel handle
+    /// @param[in] process The producer or consumer process
+    /// @param[in] word A pointer to a word of the ring header, in the process address space
+    /// @param[in] expectedValue The value the word holds when the caller decided to wait
+    /// @return IPC_STATUS_SUCCESS on success, an error code otherwise
+    KeStatus ChannelWait(const IpcHandle channelHandle, Process* const process, const u32 * const word, const u32 expectedValue);
+
+    /// @brief Rings the channel doorbell, waking up the other side if it waits in ChannelWait()
+    /// @param[in] channelHandle The channel handle
+    /// @param[in] process The producer or consumer process
+    /// @return IPC_STATUS_SUCCESS on success, an error code otherwise
+    KeStatus ChannelWake(const IpcHandle channelHandle, Process* const process);
+
+    /// @brief Closes the side of a channel held by a process : its ring is unmapped, and the other side sees the ring closed flag set
+    ///        and is woken up. The channel is freed once both sides closed it, a channel not accepted yet is freed by the next AcceptChannel().
+    /// @param[in] channelHandle The channel handle
+    /// @param[in] process The producer or consumer process
+    /// @return IPC_STATUS_SUCCESS on success, an error code otherwise
+    KeStatus CloseChannel(const IpcHandle channelHandle, Process* const process);
+
+    /// @brief Releases the ipc resources held by a process that is being deleted, it closes its side of every channel
+    ///        and disconnects it from every server it sent messages to
+    /// @param[in] process The process being deleted, none of its threads runs anymore
+    void ReleaseProcess(Process* const process);
+
+    /// @brief Waits until at least one of the given ipc server or channel handles is ready for one of its waited events.
+    ///        Every ready event is reported, the caller then receives, accepts, reads or writes without blocking.
+    /// @param[in]     process The process waiting, the server of the ipc objects or a side of the channels
+    /// @param[in,out] entries The handles and the events waited on, their readyEvents field is set on return
+    /// @param[in]     nbEntries The number of entries, IPC_WAIT_MAX_ENTRIES at most
+    /// @param[out]    nbReady A pointer that will hold the number of entries with at least one ready event
+    /// @return IPC_STATUS_SUCCESS on success, an error code otherwise
+    KeStatus WaitMultiple(Process* const process, IpcWaitEntry* const entries, const unsigned int nbEntries, unsigned int* const nbReady);
+
+    /// @brief Releases memory mapped by ReceivePages() in a process address space, any other memory block is refused
     /// @param[in] process The process in which the memory must be released
     /// @param[in] ptr Pointer to the memory to be released
     /// @return IPC_STATUS_SUCCESS on success, an error code otherwise
     KeStatus ReleaseMemory(Process* const process, void* ptr);
 
 private:
+    /// @brief Retrieves the queue of a client of an ipc object, and creates it if the client has none yet
+    /// @param[in]  ipcObject The ipc object the client sends to
+    /// @param[in]  clientProcess The client process
+    /// @param[out] clientQueue A pointer that will hold the client queue
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus _GetClientQueue(IpcObject* const ipcObject, Process* const clientProcess, IpcClientQueue** const clientQueue);
+
+    /// @brief Removes the queue of a client from an ipc object, see Disconnect()
+    /// @param[in] ipcObject The ipc object the client sends to
+    /// @param[in] clientProcess The client process
+    /// @return STATUS_SUCCESS on success, STATUS_NOT_FOUND if the client has no queue
+    KeStatus _DisconnectClient(IpcObject* const ipcObject, Process* const clientProcess);
+
+    /// @brief Removes the handle of a disconnected client queue and frees it with its buffer
+    /// @param[in] clientQueue The client queue, no thread sends to it anymore
+    void _FreeClientQueue(IpcClientQueue* const clientQueue);
+
     /// @brief Allocates memory in a given process address space
     /// @param[in]  process The process in which the memory must be allocated
     /// @param[in]  size The memory size in bytes that must be allocated
     /// @param[out] buffer Pointer that will hold a pointer to the allocated memory
     KeStatus _AllocateMemory(Process* processconst, unsigned int size, char** const buffer);
 
-    /// @brief Retrieves an ipc object from its handle
-    /// @param[in] handle The ipc object handle
-    /// @return A pointer to the found ipc object, or nullptr if not found
-    IpcObject* _FindIpcObjectByHandle(const IpcHandle handle) const ;
-
-    /// @brief Retrieves an ipc object from its server id
-    /// @param[in] serverId The ipc server id
-    /// @return A pointer to the found ipc object, or nullptr if not found
-    IpcObject* _FindIpcObjectByServerId(const char * serverId) const;
-
-    /// @brief Checks if the given server id string is already used by the same or another process
-    /// @param[in] serverIdStr The server id string
-    /// @return true if the string is already used, else false
-    bool _IsServerIdStrAlreadyUsed(const char * serverIdStr) const;
-
-    List * _ipcObjects;
+    /// @brief Raises the server thread priority up to the highest priority of the clients waiting for it
+    /// @warning The ipc object critical section must be held by the caller
+    /// @param[in] ipcObject The ipc object whose server thread inherits the priority
+    /// @param[in,opt] clientThread The client thread that has just sent a message, or nullptr
+    void _InheritClientPriority(IpcObject* const ipcObject, Thread* const clientThread);
+
+    /// @brief Gives back to the server thread the priority it had before inheriting its clients one
+    /// @warning The ipc object critical section must be held by the caller
+    /// @param[in] ipcObject The ipc object whose server thread priority is restored
+    void _RestoreServerPriority(IpcObject* const ipcObject);
+
+    /// @brief Retrieves a channel from its handle and takes a reference on it, so that it isn't freed while it is used
+    /// @param[in] channelHandle The channel handle
+    /// @return A pointer to the channel, or nullptr if the handle is not valid
+    IpcChannel * _AcquireChannel(const IpcHandle channelHandle);
+
+    /// @brief Drops a reference on a channel, the last one removes its handle and frees it with its ring pages
+    /// @param[in] channel The channel
+    void _ReleaseChannel(IpcChannel* const channel);
+
+    /// @brief Handle table and server id hash map of the ipc objects and channels
+    IpcRegistry _registry;
+
+    /// @brief Every channel, whatever its state, chained with IpcChannel::previous and IpcChannel::next
+    IpcChannel * _channels;
+    /// @brief Protects the channels chain, the channel sides and their references
+    CriticalSection _channelsCriticalSection;
+
+    /// @brief Every ipc object, chained with IpcObject::next
+    IpcObject * _servers;
+    /// @brief Protects the ipc objects chain
+    CriticalSection _serversCriticalSection;
 };
 
 #ifdef __IPC_HANDLER__
@@ -1,7 +1,7 @@
 #include "IpcBuffer.hpp"
 
 #include <kernel/Logger.hpp>
-#include <kernel/mem/PagePool.hpp>
+#include <kernel/lib/StdMem.hpp>
 
 #define KLOG(LOG_LEVEL, format, ...) KLOGGER("IPCBUFFER", LOG_LEVEL, format, ##__VA_ARGS__)
 #ifdef DEBUG_DEBUGGER
@@ -10,92 +10,85 @@
 #define DKLOG(LOG_LEVEL, format, ...)
 #endif
 
+#define IPC_BUFFER_OFFSET(count) ((count) & (IPC_BUFFER_SIZE - 1))
+
 IpcBuffer::IpcBuffer()
 {
 
 }
 
-void IpcBuffer::Init()
+KeStatus IpcBuffer::Init()
 {
-    currentPageWrite = nullptr;
-    currentPageRead = nullptr;
+    writeCount = 0;
+    readCount = 0;
 
-    currentPageWritePtr = nullptr;
-    currentPageReadPtr = nullptr;
+    ReadyToReadEvent = EventCreate();
+    ReadyToWriteEvent = EventCreate();
 
-    currentWriteLimit = nullptr;
-    currentReadLimit = nullptr;
+    data = (char*)HeapAlloc(IPC_BUFFER_SIZE);
+    if (data == nullptr)
+    {
+        KLOG(LOG_ERROR, "Couldn't allocate %d bytes", IPC_BUFFER_SIZE);
+        return STATUS_ALLOC_FAILED;
+    }
 
-    pagesList = ListCreate();
-    ReadyToReadEvent = EventCreate();
+    return STATUS_SUCCESS;
+}
+
+void IpcBuffer::Release()
+{
+    if (data != nullptr)
+    {
+        HeapFree(data);
+        data = nullptr;
+    }
+
+    writeCount = 0;
+    readCount = 0;
 }
 
-KeStatus IpcBuffer::AddBytes(const char* message, const unsigned int size)
+KeStatus IpcBuffer::AddMessage(const IpcIoVector * const vectors, const unsigned int nbVectors, const unsigned int size)
 {
-    KeStatus status = STATUS_FAILURE;
-    char * currentPage = nullptr;
-    char * localMessage = (char*)message;
-    unsigned int remainingBytes = size;
+    IpcMessageHeader header;
 
-    if (message == nullptr)
+    if (vectors == nullptr)
     {
-        KLOG(LOG_ERROR, "Invalid message parameter");
+        KLOG(LOG_ERROR, "Invalid vectors parameter");
         return STATUS_NULL_PARAMETER;
     }
 
-    if (size == 0)
+    if (nbVectors == 0)
     {
-        KLOG(LOG_ERROR, "Invalid size parameter");
+        KLOG(LOG_ERROR, "Invalid nbVectors parameter");
         return STATUS_INVALID_PARAMETER;
     }
 
-    if (this->currentPageWritePtr == nullptr)
+    if (size == 0 || size > IPC_MAX_MESSAGE_SIZE)
     {
-        status = AllocateWritePage();
-        if (FAILED(status))
-        {
-            KLOG(LOG_ERROR, "AllocateWritePage() failed with code %t", status);
-            goto clean;
-        }
+        KLOG(LOG_ERROR, "Invalid size parameter");
+        return STATUS_INVALID_PARAMETER;
     }
 
-    do
+    if (GetFreeBytes() < sizeof(IpcMessageHeader) + size)
     {
-        while (remainingBytes > 0 && (this->currentPageWritePtr < this->currentWriteLimit))
-        {
-            *(this->currentPageWritePtr) = *localMessage;
-
-            this->currentPageWritePtr++;
-            localMessage++;
-            remainingBytes--;
-
-            if (this->currentPageWrite == this->currentPageRead)
-                this->currentReadLimit++;
-        }
-        if (remainingBytes > 0)
-        {
-            status = AllocateWritePage();
-            if (FAILED(status))
-            {
-                KLOG(LOG_ERROR, "AllocateWritePage() failed with code %t", status);
-                goto clean;
-            }
-        }
-    } while (remainingBytes > 0);
+        KLOG(LOG_ERROR, "Not enough room for a message of %d bytes", size);
+        return STATUS_UNEXPECTED;
+    }
 
-    EventSignal(&this->ReadyToReadEvent);
+    header.size = size;
+    _Write((const char*)&header, sizeof(IpcMessageHeader));
+
+    for (unsigned int index = 0; index < nbVectors; index++)
+        _Write(vectors[index].buffer, vectors[index].size);
 
-    status = STATUS_SUCCESS;
+    EventSignal(&this->ReadyToReadEvent);
 
-clean:
-    return status;
+    return STATUS_SUCCESS;
 }
 
-KeStatus IpcBuffer::ReadBytes(char* const buffer, const unsigned int size, unsigned int* const bytesRead)
+KeStatus IpcBuffer::ReadMessage(char* const buffer, const unsigned int size, unsigned int* const messageSize)
 {
-    KeStatus status = STATUS_FAILURE;
-    unsigned int localSize = size;
-    char * localBuffer = buffer;
+    IpcMessageHeader header;
 
     if (buffer == nullptr)
     {
@@ -103,109 +96,76 @@ KeStatus IpcBuffer::ReadBytes(char* const buffer, const unsigned int size, unsig
         return STATUS_NULL_PARAMETER;
     }
 
-    if (size == 0)
-    {
-        KLOG(LOG_ERROR, "Invalid size parameter");
-        return STATUS_INVALID_PARAMETER;
-    }
-
-    if (bytesRead == nullptr)
+    if (messageSize == nullptr)
     {
-        KLOG(LOG_ERROR, "Invalid bytesRead parameter");
+        KLOG(LOG_ERROR, "Invalid messageSize parameter");
         return STATUS_NULL_PARAMETER;
     }
 
-    if (this->currentPageReadPtr == nullptr)
+    if (IsEmpty())
     {
-        Page * nextPage = (Page*)ListTop(this->pagesList);
-        this->currentPageRead = nextPage;
-        this->currentPageReadPtr = (char*)nextPage->vAddr;
-
-        if (this->currentPageRead == this->currentPageWrite)
-            this->currentReadLimit = this->currentPageWritePtr;
-        else
-            this->currentReadLimit = (char*)(nextPage->vAddr + PAGE_SIZE);
+        KLOG(LOG_ERROR, "No message to read");
+        return STATUS_UNEXPECTED;
     }
 
-    do
-    {
-        while (localSize > 0 && (this->currentPageReadPtr < this->currentReadLimit))
-        {
-            *localBuffer = *(this->currentPageReadPtr);
-            localBuffer++;
-            this->currentPageReadPtr++;
-            localSize--;
-        }
-
-        if (localSize > 0)
-        {
-            // If we are not on the last page, we may remove it from the list and free memory
-            if (this->currentPageWrite != this->currentPageRead)
-            {
-                // removing the older page, on the top of the list
-                Page * page = (Page*)ListPop(&this->pagesList);
-
-                // we release the page
-                gPagePool.Free(*page);
-
-                // And we take the next one
-                page = (Page*)ListTop(this->pagesList);
-
-                this->currentPageReadPtr = (char*)page->vAddr;
-                this->currentReadLimit = (char*)(page->vAddr + PAGE_SIZE);
-            }
-            else
-            {
-                break;
-            }
-        }
-    } while (localSize > 0);
-
-    *bytesRead = (localSize == 0 ? size : (size - localSize));
-
-    status = STATUS_SUCCESS;
-
-clean:
-    return status;
+    _Read(readCount, (char*)&header, sizeof(IpcMessageHeader));
+
+    *messageSize = header.size;
+
+    // The message stays in the buffer, the server can come back with a bigger buffer
+    if (header.size > size)
+        return IPC_STATUS_BUFFER_TOO_SMALL;
+
+    _Read(readCount + sizeof(IpcMessageHeader), buffer, header.size);
+
+    readCount += sizeof(IpcMessageHeader) + header.size;
+
+    EventSignal(&this->ReadyToWriteEvent);
+
+    return STATUS_SUCCESS;
 }
 
-Page * IpcBuffer::AllocatePage() const
+unsigned int IpcBuffer::GetNextMessageSize() const
 {
-    Page * newPage = nullptr;
-    Page p = gPagePool.Allocate();
-
-    if (p.vAddr == 0)
-    {
-        return nullptr;
-    }
+    IpcMessageHeader header;
 
-    newPage = (Page*)HeapAlloc(sizeof(Page));
-    if (newPage == nullptr)
-    {
-        KLOG(LOG_ERROR, "Couldn't allocate %d bytes", sizeof(Page));
-        return nullptr;
-    }
+    _Read(readCount, (char*)&header, sizeof(IpcMessageHeader));
 
-    newPage->pAddr = p.pAddr;
-    newPage->vAddr = p.vAddr;
+    return header.size;
+}
 
-    return newPage;
+bool IpcBuffer::IsEmpty() const
+{
+    return (writeCount == readCount);
 }
 
-KeStatus IpcBuffer::AllocateWritePage()
+unsigned int IpcBuffer::GetFreeBytes() const
 {
-    Page * newPage = AllocatePage();
-    if (newPage == nullptr)
-    {
-        KLOG(LOG_ERROR, "AllocatePage() failed");
-        return STATUS_ALLOC_FAILED;
-    }
+    return IPC_BUFFER_SIZE - (writeCount - readCount);
+}
+void IpcBuffer::_Write(const char* source, const unsigned int size)
+{
+    // At most two spans : up to the end of the buffer, then from its beginning
+    unsigned int offset = IPC_BUFFER_OFFSET(writeCount);
+    unsigned int firstSpanSize = IPC_BUFFER_SIZE - offset;
 
-    this->currentPageWrite = newPage;
-    this->currentPageWritePtr = (char*)newPage->vAddr;
-    this->currentWriteLimit = (char *)(newPage->vAddr + PAGE_SIZE);
+    if (firstSpanSize > size)
+        firstSpanSize = size;
 
-    ListPush(this->pagesList, newPage);
+    MemCopy(source, data + offset, firstSpanSize);
+    MemCopy(source + firstSpanSize, data, size - firstSpanSize);
 
-    return STATUS_SUCCESS;
+    writeCount += size;
+}
+
+void IpcBuffer::_Read(const u32 count, char* const destination, const unsigned int size) const
+{
+    unsigned int offset = IPC_BUFFER_OFFSET(count);
+    unsigned int firstSpanSize = IPC_BUFFER_SIZE - offset;
+
+    if (firstSpanSize > size)
+        firstSpanSize = size;
+
+    MemCopy(data + offset, destination, firstSpanSize);
+    MemCopy(data, destination + firstSpanSize, size - firstSpanSize);
 }
\ No newline at end of file
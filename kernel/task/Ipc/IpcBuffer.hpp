@@ -1,47 +1,89 @@
 #pragma once
 
 #include <kernel/lib/Status.hpp>
-#include <kernel/lib/List.hpp>
-#include <kernel/arch/x86/Vmm.hpp>
+#include <kernel/lib/Types.hpp>
 #include <kernel/task/Event.hpp>
+#include <kernel/syscalls/UKSyscallsCommon.h>
 
 /// @file
 
 /// @addgroup TaskGroup
 /// @{
 
+/// @brief Capacity in bytes of the ring buffer of an ipc object, it must be a power of two
+///        and hold at least one message of IPC_MAX_MESSAGE_SIZE bytes with its header
+#define IPC_BUFFER_SIZE 0x10000
+
+#if IPC_BUFFER_SIZE < (IPC_MAX_MESSAGE_SIZE + 4)
+#error "IPC_BUFFER_SIZE can't hold a message of IPC_MAX_MESSAGE_SIZE bytes"
+#endif
+
+/// @brief Written in the ring buffer before each message
+struct IpcMessageHeader
+{
+    /// @brief Size of the message following the header, in bytes
+    u32 size;
+};
+
+/// @brief Fixed capacity ring buffer holding the messages sent to an ipc server.
+///        It is allocated once, each message is framed by a header holding its size, and a full buffer makes the senders wait.
+/// @warning The buffer is not protected, the ipc object critical section must be held when using it
 class IpcBuffer
 {
 public:
     IpcBuffer();
 
-    void Init();
+    /// @brief Allocates the ring buffer
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus Init();
 
-    KeStatus AddBytes(const char* message, const unsigned int size);
-    KeStatus ReadBytes(char* const buffer, const unsigned int size, unsigned int* const bytesRead);
+    /// @brief Frees the ring buffer, the messages it still holds are lost
+    void Release();
 
-    Event ReadyToReadEvent;
+    /// @brief Adds a message gathered from several buffers, without waiting.
+    ///        The caller makes sure there is room for the message and its header with GetFreeBytes().
+    /// @param[in] vectors The buffers making the message, in order. The pointed memory is in the current address space.
+    /// @param[in] nbVectors The number of buffers
+    /// @param[in] size The message size in bytes, i.e. the sum of the buffer sizes
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus AddMessage(const IpcIoVector * const vectors, const unsigned int nbVectors, const unsigned int size);
 
-private:
-    Page * AllocatePage() const;
-    KeStatus AllocateWritePage();
+    /// @brief Copies the oldest message of the buffer and removes it, without waiting.
+    ///        The buffer must not be empty.
+    /// @param[in]  buffer A pointer to the memory where to copy the message
+    /// @param[in]  size The size of the memory pointed by buffer
+    /// @param[out] messageSize A pointer that will hold the message size, even if it doesn't fit in the buffer
+    /// @return STATUS_SUCCESS on success, IPC_STATUS_BUFFER_TOO_SMALL if the message is bigger than size (it is kept in the buffer),
+    ///         an error code otherwise
+    KeStatus ReadMessage(char* const buffer, const unsigned int size, unsigned int* const messageSize);
+
+    /// @brief Retrieves the size of the oldest message of the buffer, without removing it. The buffer must not be empty.
+    unsigned int GetNextMessageSize() const;
+
+    /// @brief Checks if every message written in the buffer has been read
+    /// @return true if there is nothing left to read, else false
+    bool IsEmpty() const;
 
-    /*
-        TODO : 
-         - ajouter un boolean disant si le buffer est pret a etre lu
-         - ventuellement ajouter une section critique/mutex...
-    */
+    /// @brief Retrieves the number of bytes that can be added before the buffer is full, headers included
+    unsigned int GetFreeBytes() const;
 
-    Page * currentPageWrite;
-    Page * currentPageRead;
+    /// @brief Signaled when a message is added
+    Event ReadyToReadEvent;
+    /// @brief Signaled when a message is read, i.e. when space is given back to the senders
+    Event ReadyToWriteEvent;
+
+private:
+    /// @brief Copies bytes at the write position, in at most two spans
+    void _Write(const char* source, const unsigned int size);
+    /// @brief Copies bytes from a given position, in at most two spans
+    void _Read(const u32 count, char* const destination, const unsigned int size) const;
 
-    char * currentPageWritePtr;
-    char * currentPageReadPtr;
-    
-    char * currentWriteLimit;
-    char * currentReadLimit;
+    char * data;
 
-    List * pagesList;
+    /// @brief Number of bytes written and read since the buffer creation. They may wrap around,
+    ///        only their difference and their position in the buffer (modulo IPC_BUFFER_SIZE) are used.
+    u32 writeCount;
+    u32 readCount;
 };
 
 /// @}
\ No newline at end of file
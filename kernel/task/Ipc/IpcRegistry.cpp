@@ -0,0 +1,292 @@
+#include "IpcRegistry.hpp"
+
+#include <kernel/Logger.hpp>
+#include <kernel/lib/StdLib.hpp>
+#include <kernel/lib/StdMem.hpp>
+#include <kernel/handle/HandleManager.h>
+
+#define KLOG(LOG_LEVEL, format, ...) KLOGGER("IPCREGISTRY", LOG_LEVEL, format, ##__VA_ARGS__)
+
+#define IPC_REGISTRY_NO_SLOT 0xFFFFFFFF
+
+#define IPC_HANDLE_GENERATION_MAX (0xFFFFFFFF >> IPC_HANDLE_INDEX_BITS)
+#define IPC_HANDLE_MAKE(index, generation) (((generation) << IPC_HANDLE_INDEX_BITS) | (index))
+#define IPC_HANDLE_INDEX(handle) ((handle) & IPC_HANDLE_INDEX_MASK)
+#define IPC_HANDLE_GENERATION(handle) ((handle) >> IPC_HANDLE_INDEX_BITS)
+
+/// @brief FNV-1a hash of a server id string
+static u32 HashServerId(const char * serverId)
+{
+    u32 hash = 2166136261;
+
+    while (*serverId != '\0')
+    {
+        hash ^= (u8)*serverId++;
+        hash *= 16777619;
+    }
+
+    return hash;
+}
+
+KeStatus IpcRegistry::Init()
+{
+    _criticalSection = CriticalSection();
+    _freeSlots = IPC_REGISTRY_NO_SLOT;
+
+    _slots = (Slot*)HeapAlloc(IPC_REGISTRY_MAX_OBJECTS * sizeof(Slot));
+    if (_slots == nullptr)
+    {
+        KLOG(LOG_ERROR, "Couldn't allocate %d bytes", IPC_REGISTRY_MAX_OBJECTS * sizeof(Slot));
+        return STATUS_ALLOC_FAILED;
+    }
+
+    _buckets = (u32*)HeapAlloc(IPC_REGISTRY_NAME_BUCKETS * sizeof(u32));
+    if (_buckets == nullptr)
+    {
+        KLOG(LOG_ERROR, "Couldn't allocate %d bytes", IPC_REGISTRY_NAME_BUCKETS * sizeof(u32));
+        HeapFree(_slots);
+        _slots = nullptr;
+        return STATUS_ALLOC_FAILED;
+    }
+
+    for (u32 bucket = 0; bucket < IPC_REGISTRY_NAME_BUCKETS; bucket++)
+        _buckets[bucket] = IPC_REGISTRY_NO_SLOT;
+
+    // Pushed in reverse order so that the first slots are used first
+    for (u32 index = IPC_REGISTRY_MAX_OBJECTS; index > 0; index--)
+    {
+        Slot * slot = &_slots[index - 1];
+
+        slot->type = SLOT_FREE;
+        slot->object = nullptr;
+        slot->serverId = nullptr;
+        slot->serverIdHash = 0;
+        slot->generation = 0;
+        slot->next = _freeSlots;
+
+        _freeSlots = index - 1;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+KeStatus IpcRegistry::Add(const char * serverId, IpcObject * const ipcObject, IpcHandle * const handle)
+{
+    if (serverId == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid serverId parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (ipcObject == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid ipcObject parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    return _Add(SLOT_SERVER, serverId, ipcObject, handle);
+}
+
+KeStatus IpcRegistry::AddChannel(IpcChannel * const channel, IpcHandle * const handle)
+{
+    if (channel == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid channel parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    return _Add(SLOT_CHANNEL, nullptr, channel, handle);
+}
+
+KeStatus IpcRegistry::AddClient(IpcClientQueue * const clientQueue, IpcHandle * const handle)
+{
+    if (clientQueue == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid clientQueue parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    return _Add(SLOT_CLIENT, nullptr, clientQueue, handle);
+}
+
+KeStatus IpcRegistry::Remove(const IpcHandle handle)
+{
+    KeStatus status = STATUS_FAILURE;
+    u32 index = IPC_HANDLE_INDEX(handle);
+    u32 * link = nullptr;
+    Slot * slot = nullptr;
+
+    if (index >= IPC_REGISTRY_MAX_OBJECTS)
+        return STATUS_NOT_FOUND;
+
+    _criticalSection.Enter();
+
+    slot = &_slots[index];
+    if (slot->type == SLOT_FREE || slot->generation != IPC_HANDLE_GENERATION(handle))
+    {
+        status = STATUS_NOT_FOUND;
+        goto clean;
+    }
+
+    // Unlinks the slot from its bucket
+    if (slot->serverId != nullptr)
+    {
+        link = &_buckets[slot->serverIdHash & (IPC_REGISTRY_NAME_BUCKETS - 1)];
+        while (*link != index)
+            link = &_slots[*link].next;
+        *link = slot->next;
+    }
+
+    slot->type = SLOT_FREE;
+    slot->object = nullptr;
+    slot->serverId = nullptr;
+    slot->next = _freeSlots;
+
+    _freeSlots = index;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    _criticalSection.Leave();
+
+    return status;
+}
+
+IpcObject * IpcRegistry::FindByHandle(const IpcHandle handle)
+{
+    return (IpcObject*)_Find(SLOT_SERVER, handle);
+}
+
+IpcChannel * IpcRegistry::FindChannelByHandle(const IpcHandle handle)
+{
+    return (IpcChannel*)_Find(SLOT_CHANNEL, handle);
+}
+
+KeStatus IpcRegistry::FindByServerId(const char * serverId, IpcHandle * const handle)
+{
+    KeStatus status = STATUS_FAILURE;
+    u32 index = IPC_REGISTRY_NO_SLOT;
+
+    if (serverId == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid serverId parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (handle == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid handle parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    _criticalSection.Enter();
+
+    index = _FindSlotByServerId(serverId, HashServerId(serverId));
+    if (index == IPC_REGISTRY_NO_SLOT)
+    {
+        status = STATUS_NOT_FOUND;
+        goto clean;
+    }
+
+    *handle = IPC_HANDLE_MAKE(index, _slots[index].generation);
+
+    status = STATUS_SUCCESS;
+
+clean:
+    _criticalSection.Leave();
+
+    return status;
+}
+
+KeStatus IpcRegistry::_Add(const SlotType type, const char * serverId, void * const object, IpcHandle * const handle)
+{
+    KeStatus status = STATUS_FAILURE;
+    u32 hash = 0;
+    u32 index = IPC_REGISTRY_NO_SLOT;
+    Slot * slot = nullptr;
+
+    if (handle == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid handle parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (serverId != nullptr)
+        hash = HashServerId(serverId);
+
+    _criticalSection.Enter();
+
+    if (serverId != nullptr && _FindSlotByServerId(serverId, hash) != IPC_REGISTRY_NO_SLOT)
+    {
+        status = IPC_STATUS_ID_STRING_ALREADY_USED;
+        goto clean;
+    }
+
+    if (_freeSlots == IPC_REGISTRY_NO_SLOT)
+    {
+        KLOG(LOG_ERROR, "No more than %d ipc objects can be registered", IPC_REGISTRY_MAX_OBJECTS);
+        status = STATUS_ALLOC_FAILED;
+        goto clean;
+    }
+
+    index = _freeSlots;
+    slot = &_slots[index];
+    _freeSlots = slot->next;
+
+    slot->generation = (slot->generation == IPC_HANDLE_GENERATION_MAX) ? 1 : slot->generation + 1;
+    slot->type = type;
+    slot->object = object;
+    slot->serverId = serverId;
+    slot->serverIdHash = hash;
+    slot->next = IPC_REGISTRY_NO_SLOT;
+
+    if (serverId != nullptr)
+    {
+        slot->next = _buckets[hash & (IPC_REGISTRY_NAME_BUCKETS - 1)];
+        _buckets[hash & (IPC_REGISTRY_NAME_BUCKETS - 1)] = index;
+    }
+
+    *handle = IPC_HANDLE_MAKE(index, slot->generation);
+
+    status = STATUS_SUCCESS;
+
+clean:
+    _criticalSection.Leave();
+
+    return status;
+}
+
+void * IpcRegistry::_Find(const SlotType type, const IpcHandle handle)
+{
+    void * object = nullptr;
+    u32 index = IPC_HANDLE_INDEX(handle);
+
+    if (handle == INVALID_HANDLE_VALUE || index >= IPC_REGISTRY_MAX_OBJECTS)
+        return nullptr;
+
+    _criticalSection.Enter();
+
+    if (_slots[index].type == type && _slots[index].generation == IPC_HANDLE_GENERATION(handle))
+        object = _slots[index].object;
+
+    _criticalSection.Leave();
+
+    return object;
+}
+
+u32 IpcRegistry::_FindSlotByServerId(const char * serverId, const u32 hash) const
+{
+    u32 index = _buckets[hash & (IPC_REGISTRY_NAME_BUCKETS - 1)];
+
+    while (index != IPC_REGISTRY_NO_SLOT)
+    {
+        const Slot * slot = &_slots[index];
+
+        if (slot->serverIdHash == hash && StrCmp(slot->serverId, serverId) == 0)
+            return index;
+
+        index = slot->next;
+    }
+
+    return IPC_REGISTRY_NO_SLOT;
+}
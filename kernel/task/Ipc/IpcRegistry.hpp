@@ -0,0 +1,124 @@
+#pragma once
+
+#include <kernel/lib/Status.hpp>
+#include <kernel/lib/Types.hpp>
+#include <kernel/lib/CriticalSection.hpp>
+#include <kernel/syscalls/UKSyscallsCommon.h>
+
+/// @file
+
+/// @addgroup TaskGroup
+/// @{
+
+typedef unsigned int IpcHandle;
+
+struct IpcObject;
+struct IpcChannel;
+struct IpcClientQueue;
+
+/// @brief Maximum number of ipc objects registered at the same time, it must be a power of two
+#define IPC_REGISTRY_MAX_OBJECTS 1024
+/// @brief Number of buckets of the server id hash map, it must be a power of two
+#define IPC_REGISTRY_NAME_BUCKETS 256
+
+/// @brief A handle is made of the index of its slot in the low bits, and of the slot generation in the high bits.
+///        The generation changes each time a slot is reused, so that a stale handle is never routed to a new object.
+#define IPC_HANDLE_INDEX_BITS 12
+#define IPC_HANDLE_INDEX_MASK ((1 << IPC_HANDLE_INDEX_BITS) - 1)
+
+#if IPC_REGISTRY_MAX_OBJECTS > (1 << IPC_HANDLE_INDEX_BITS)
+#error "IPC_HANDLE_INDEX_BITS is too small to index IPC_REGISTRY_MAX_OBJECTS slots"
+#endif
+
+#if IPC_CLIENT_INDEX_COUNT != (1 << IPC_HANDLE_INDEX_BITS)
+#error "IPC_CLIENT_INDEX() must extract the slot index of a client handle"
+#endif
+
+/// @brief Handle table and server id hash map of the ipc servers, channels and clients, every lookup costs O(1)
+///        however many objects are registered
+class IpcRegistry
+{
+public:
+    /// @brief Allocates the handle table and the hash map
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus Init();
+
+    /// @brief Registers an ipc object and creates its handle
+    /// @param[in]  serverId The server id string, it must stay valid until the object is removed
+    /// @param[in]  ipcObject The ipc object to register
+    /// @param[out] handle A pointer that will hold the new handle
+    /// @return STATUS_SUCCESS on success, IPC_STATUS_ID_STRING_ALREADY_USED if the server id is already registered, an error code otherwise
+    KeStatus Add(const char * serverId, IpcObject * const ipcObject, IpcHandle * const handle);
+
+    /// @brief Registers a channel and creates its handle, channels have no name
+    /// @param[in]  channel The channel to register
+    /// @param[out] handle A pointer that will hold the new handle
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus AddChannel(IpcChannel * const channel, IpcHandle * const handle);
+
+    /// @brief Registers the queue of a client of a server and creates its handle, it identifies the client to the server
+    /// @param[in]  clientQueue The client queue to register
+    /// @param[out] handle A pointer that will hold the new handle
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus AddClient(IpcClientQueue * const clientQueue, IpcHandle * const handle);
+
+    /// @brief Unregisters an ipc object, a channel or a client, its handle becomes invalid
+    /// @param[in] handle The ipc object handle
+    /// @return STATUS_SUCCESS on success, STATUS_NOT_FOUND if the handle is not valid
+    KeStatus Remove(const IpcHandle handle);
+
+    /// @brief Retrieves an ipc object from its handle
+    /// @param[in] handle The ipc object handle
+    /// @return A pointer to the found ipc object, or nullptr if the handle is not valid
+    IpcObject * FindByHandle(const IpcHandle handle);
+
+    /// @brief Retrieves a channel from its handle
+    /// @param[in] handle The channel handle
+    /// @return A pointer to the found channel, or nullptr if the handle is not valid
+    IpcChannel * FindChannelByHandle(const IpcHandle handle);
+
+    /// @brief Retrieves an ipc object handle from its server id
+    /// @param[in]  serverId The ipc server id
+    /// @param[out] handle A pointer that will hold the found handle
+    /// @return STATUS_SUCCESS on success, STATUS_NOT_FOUND if no object uses this server id
+    KeStatus FindByServerId(const char * serverId, IpcHandle * const handle);
+
+private:
+    enum SlotType
+    {
+        SLOT_FREE,
+        SLOT_SERVER,
+        SLOT_CHANNEL,
+        SLOT_CLIENT
+    };
+
+    struct Slot
+    {
+        SlotType type;
+        void * object;
+        /// @brief Only servers have an id, they are the only objects in the hash map
+        const char * serverId;
+        u32 serverIdHash;
+        /// @brief Changes each time the slot is given to a new object, never 0 so that a handle is never INVALID_HANDLE_VALUE
+        u32 generation;
+        /// @brief Next slot of the same hash bucket, or of the free slots list if the slot is not used
+        u32 next;
+    };
+
+    /// @brief Takes a free slot for a new object
+    KeStatus _Add(const SlotType type, const char * serverId, void * const object, IpcHandle * const handle);
+
+    /// @brief Retrieves the object of a given type referenced by a handle
+    void * _Find(const SlotType type, const IpcHandle handle);
+
+    /// @brief Looks for the slot used by a server id, the critical section must be held
+    /// @return The slot index, or IPC_REGISTRY_NO_SLOT if not found
+    u32 _FindSlotByServerId(const char * serverId, const u32 hash) const;
+
+    Slot * _slots;
+    u32 * _buckets;
+    u32 _freeSlots;
+    CriticalSection _criticalSection;
+};
+
+/// @}
@@ -3,11 +3,26 @@
 
 #include "Common.hpp"
 #include "Scheduler.hpp"
+#include "SharedData.hpp"
 #include <kernel/Kernel.hpp>
+#include <kernel/syscalls/UKSyscallsCommon.h>
+#include <kernel/task/Ipc/Ipc.hpp>
 
 #include <kernel/Logger.hpp>
 #define KLOG(LOG_LEVEL, format, ...) KLOGGER("TASK", LOG_LEVEL, format, ##__VA_ARGS__)
 
+struct MEMORY_STATS_CONTEXT
+{
+    /// @brief Process looked for by GetProcessMemoryStats(), -1 when every process is enumerated
+    int pid;
+    ProcessMemoryStats * stats;
+    /// @brief Number of processes found, and the maximum number of stats that can be written
+    unsigned int nbProcesses;
+    unsigned int maxProcesses;
+};
+
+static KeStatus MemoryStatsCallback(void* data, void* context);
+
 void ProcessManager::Init()
 {
     _processList = ListCreate();
@@ -50,6 +65,13 @@ KeStatus ProcessManager::CreateProcess(const char * name, u32 entryAddr, Process
         goto clean;
     }
 
+    status = gSharedData.MapInProcess(process);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "SharedDataPage::MapInProcess() failed with code %t", status);
+        goto clean;
+    }
+
     status = gThreadManager.CreateUserThread(entryAddr, process, attribute, &mainThread);
     if (FAILED(status))
     {
@@ -72,6 +94,82 @@ clean:
     return status;
 }
 
+KeStatus ProcessManager::SpawnProcess(Process * const templateProcess, u32 entryAddr, u32 argument, SecurityAttribute attribute, Process ** newProcess)
+{
+    KeStatus status = STATUS_FAILURE;
+    Process * process = nullptr;
+    Thread * mainThread = nullptr;
+
+    if (templateProcess == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid templateProcess parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (newProcess == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid newProcess parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = CreateProcess(templateProcess->name, entryAddr, &process, attribute, templateProcess);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "CreateProcess() failed with code %t", status);
+        goto clean;
+    }
+
+    status = templateProcess->CloneAddressSpace(process);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Process::CloneAddressSpace() failed with code %t", status);
+        goto clean;
+    }
+
+    mainThread = process->mainThread;
+
+    status = mainThread->CreateDefaultStack();
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "Thread::CreateDefaultStack() failed with code %t", status);
+        goto clean;
+    }
+
+    // The stack looks like the entry has just been called : a null return address, then the argument
+    {
+        u32 frame[2] = { 0, argument };
+
+        mainThread->regs.esp -= sizeof(frame);
+
+        status = process->MemoryCopy((u8*)frame, (u8*)mainThread->regs.esp, sizeof(frame));
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "Process::MemoryCopy() failed with code %t", status);
+            goto clean;
+        }
+    }
+
+    KLOG(LOG_INFO, "Process %d spawned from process %d", process->pid, templateProcess->pid);
+
+    *newProcess = process;
+    process = nullptr;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    // The process never ran, what the clone got so far is given back with it
+    if (process != nullptr)
+    {
+        gThreadManager.DeleteThread(process->mainThread);
+        process->mainThread = nullptr;
+
+        DeleteProcess(process);
+        process = nullptr;
+    }
+
+    return status;
+}
+
 KeStatus ProcessManager::CreateSystemProcess(Process ** newProcess)
 {
     KeStatus status = STATUS_FAILURE;
@@ -125,6 +223,13 @@ void ProcessManager::DeleteProcess(Process * process)
 
     const int pid = process->pid;
 
+    ListRemove(&_processList, process);
+
+    // The channel rings are unmapped from the process, its address space must still be there
+    gIpcHandler.ReleaseProcess(process);
+
+    process->ReleaseAddressSpace();
+
     Process::Delete(process);
 
     KLOG(LOG_INFO, "Process %d deleted", pid);
@@ -133,4 +238,121 @@ void ProcessManager::DeleteProcess(Process * process)
 Process * ProcessManager::GetCurrentProcess()
 {
     return gScheduler.GetCurrentProcess();
+}
+
+KeStatus ProcessManager::GetProcessMemoryStats(const int pid, ProcessMemoryStats * const stats)
+{
+    KeStatus status = STATUS_FAILURE;
+    MEMORY_STATS_CONTEXT context = { pid, stats, 0, 1 };
+
+    if (pid < 0)
+    {
+        KLOG(LOG_ERROR, "Invalid pid parameter");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (stats == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid stats parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = ListEnumerate(_processList, MemoryStatsCallback, &context);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "ListEnumerate() failed with code %t", status);
+        return status;
+    }
+
+    return (context.nbProcesses > 0) ? STATUS_SUCCESS : STATUS_NOT_FOUND;
+}
+
+KeStatus ProcessManager::GetAllProcessesMemoryStats(ProcessMemoryStats ** const stats, unsigned int * const nbProcesses)
+{
+    KeStatus status = STATUS_FAILURE;
+    MEMORY_STATS_CONTEXT context = { -1, nullptr, 0, 0 };
+
+    if (stats == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid stats parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (nbProcesses == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid nbProcesses parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    // A first pass counts the processes, the second one fills the array
+    status = ListEnumerate(_processList, MemoryStatsCallback, &context);
+    if (FAILED(status))
+    {
+        KLOG(LOG_ERROR, "ListEnumerate() failed with code %t", status);
+        goto clean;
+    }
+
+    context.maxProcesses = context.nbProcesses;
+    context.nbProcesses = 0;
+
+    if (context.maxProcesses > 0)
+    {
+        context.stats = (ProcessMemoryStats*)HeapAlloc(context.maxProcesses * sizeof(ProcessMemoryStats));
+        if (context.stats == nullptr)
+        {
+            KLOG(LOG_ERROR, "Couldn't allocate %d bytes", context.maxProcesses * sizeof(ProcessMemoryStats));
+            status = STATUS_ALLOC_FAILED;
+            goto clean;
+        }
+
+        status = ListEnumerate(_processList, MemoryStatsCallback, &context);
+        if (FAILED(status))
+        {
+            KLOG(LOG_ERROR, "ListEnumerate() failed with code %t", status);
+            HeapFree(context.stats);
+            goto clean;
+        }
+    }
+
+    *stats = context.stats;
+    *nbProcesses = context.nbProcesses;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
+static KeStatus MemoryStatsCallback(void* data, void* context)
+{
+    MEMORY_STATS_CONTEXT* statsContext = (MEMORY_STATS_CONTEXT*)context;
+    Process* process = (Process*)data;
+
+    if (data == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid data parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (context == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid context parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (statsContext->pid >= 0 && process->pid != statsContext->pid)
+        return STATUS_SUCCESS;
+
+    if (statsContext->stats != nullptr)
+    {
+        // A process created since the array was allocated is skipped
+        if (statsContext->nbProcesses == statsContext->maxProcesses)
+            return STATUS_LIST_STOP_ITERATING;
+
+        process->GetMemoryStats(&statsContext->stats[statsContext->nbProcesses]);
+    }
+
+    statsContext->nbProcesses++;
+
+    return (statsContext->pid >= 0) ? STATUS_LIST_STOP_ITERATING : STATUS_SUCCESS;
 }
\ No newline at end of file
@@ -28,13 +28,24 @@ public:
     /// @return STATUS_SUCCESS on success, an error code otherwise
     KeStatus CreateProcess(const char * name, u32 entryAddr, Process ** newProcess, SecurityAttribute attribute, Process * parent = nullptr);
 
+    /// @brief Creates a process from a template process : the template memory is shared copy-on-write (see Process::CloneAddressSpace()),
+    ///        and the main thread gets a new stack and starts at entryAddr as if it was called with argument as single parameter.
+    /// @warning This does not add the process to the scheduler process list
+    /// @param[in]  templateProcess The process cloned, it keeps running
+    /// @param[in]  entryAddr The virtual address of the code run by the main thread, in the template memory
+    /// @param[in]  argument The value given to the main thread entry
+    /// @param[in]  attribute The process security attribute(s), may be one of the SecurityAttribute enum.
+    /// @param[out] newProcess A pointer that will receive an pointer to the created process
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus SpawnProcess(Process * const templateProcess, u32 entryAddr, u32 argument, SecurityAttribute attribute, Process ** newProcess);
+
     /// @brief Creates the system process (must be unique)
     /// @param[out] newProcess A pointer that will receive an pointer to the created process
     /// @return STATUS_SUCCESS on success, an error code otherwise
     KeStatus CreateSystemProcess(Process ** process);
 
-    /// @brief Deletes a process
-    /// @warning This does not stop its execution, or erase it from the scheduler process list, it just frees the structure describing the process
+    /// @brief Deletes a process, after releasing the ipc resources it holds (see IpcHandler::ReleaseProcess()) and its user memory
+    /// @warning This does not stop its execution, or erase it from the scheduler, it just frees the process and removes it from the process list
     /// @param[in] process A pointer to the process to delete
     void DeleteProcess(Process * process);
 
@@ -42,6 +53,18 @@ public:
     /// @return A pointer to the current process structure
     Process * GetCurrentProcess();
 
+    /// @brief Retrieves the memory used by a process, see Process::GetMemoryStats()
+    /// @param[in]  pid The process id
+    /// @param[out] stats Pointer that will hold the process memory stats
+    /// @return STATUS_SUCCESS on success, STATUS_NOT_FOUND if there is no such process, an error code otherwise
+    KeStatus GetProcessMemoryStats(const int pid, ProcessMemoryStats * const stats);
+
+    /// @brief Retrieves the memory used by every process
+    /// @param[out] stats Pointer that will hold an array of nbProcesses stats, allocated on the kernel heap, it must be released with HeapFree()
+    /// @param[out] nbProcesses Pointer that will hold the number of processes
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus GetAllProcessesMemoryStats(ProcessMemoryStats ** const stats, unsigned int * const nbProcesses);
+
 private:
     List * _processList;
 };
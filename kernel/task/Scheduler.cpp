@@ -1,5 +1,6 @@
 #define __SCHEDULER__
 #include "Scheduler.hpp"
+#include "SharedData.hpp"
 
 #include <kernel/arch/x86/InterruptContext.hpp>
 #include <kernel/arch/x86/SchedulerX86.hpp>
@@ -38,6 +39,7 @@ void Scheduler::Init()
 
     _running = false;
     _currentThread = nullptr;
+    _handOffThread = nullptr;
     _nbThreads = 0;
 }
 
@@ -77,6 +79,19 @@ void Scheduler::Schedules(InterruptContext * context)
 
     if (_running && _nbThreads > 1)
     {
+        // A thread blocking on behalf of another one gives it the processor directly
+        if (_handOffThread != nullptr)
+        {
+            Thread * handOffThread = _handOffThread;
+            _handOffThread = nullptr;
+
+            if (handOffThread != _currentThread && RunnableThread(handOffThread->state))
+            {
+                _SwitchToThread(context, handOffThread);
+                return;
+            }
+        }
+
         // The current thread may be waiting
         bool IsCurrentThreadRunnable = (_currentThread != nullptr ? RunnableThread(_currentThread->state) : true);
 
@@ -86,30 +101,11 @@ void Scheduler::Schedules(InterruptContext * context)
             || HasHigherThreadPriority(_currentThread)
             || IsCurrentThreadRunnable == false)
         {
-            bool found = false;
-            Thread* foundThread = nullptr;
-            do
-            {
-                Thread* nextThread = _PickNextThread(_currentThread);
-
-                if (nextThread == nullptr && nextThread == _currentThread)
-                {
-                    found = true;
-                }
-                else
-                {
-                    foundThread = nextThread;
-
-                    if (foundThread->threadPriority >= _currentThread->threadPriority && RunnableThread(foundThread->state))
-                    {
-                        found = true;
-                    }
-                }
-            } while (!found);
-
-            if (found && _currentThread != foundThread)
+            Thread * nextThread = _PickNextThread(_currentThread);
+
+            if (nextThread != nullptr && nextThread != _currentThread)
             {
-                _SwitchToThread(context, foundThread);
+                _SwitchToThread(context, nextThread);
             }
         }
     }
@@ -120,6 +116,19 @@ void Scheduler::ContextSwitchInterrupt()
     __contextSwitchInt();
 }
 
+void Scheduler::HandOff(Thread * thread)
+{
+    if (thread == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid thread parameter");
+        return;
+    }
+
+    _handOffThread = thread;
+
+    __contextSwitchInt();
+}
+
 Process * Scheduler::GetCurrentProcess()
 {
     if (_currentThread == nullptr)
@@ -144,40 +153,40 @@ Thread * Scheduler::GetCurrentThread()
 
 Thread * Scheduler::_PickNextThread(Thread * currentThread)
 {
-    Thread * thread = nullptr;
+    Thread * foundThread = nullptr;
+    ListElem * currentElem = nullptr;
+    ListElem * elem = nullptr;
 
     // We didn't start any thread yet
     if (currentThread == nullptr)
+        return (Thread *)ListTop(_threadsList);
+
+    // TODO : we could be better, with a better list library
+    currentElem = (ListElem *)_threadsList;
+    while (currentElem != nullptr && (Thread *)currentElem->data != currentThread)
+        currentElem = currentElem->next;
+
+    if (currentElem == nullptr)
     {
-        thread = (Thread *)ListTop(_threadsList);
+        KLOG(LOG_ERROR, "Current thread %d not found in threads list", currentThread->tid);
+        return (Thread *)ListTop(_threadsList);
     }
-    else
+
+    // Every thread is looked at once, starting with the one following the current thread
+    // and going back to the top of the list, so that the current thread is the last one
+    elem = currentElem;
+    do
     {
-        // TODO : we could be better, with a better list library
-        ListElem * elem = (ListElem *)_threadsList;
-        while (elem != nullptr)
-        {
-            // If we are on the current thread node, we retrieve the next one
-            if ((Thread *)elem->data == currentThread)
-            {
-                if (elem->next != nullptr)
-                {
-                    thread = (Thread *)elem->next->data;
-                }
-                else
-                {
-                    // If there is no next one, we retrieve the top of the list
-                    thread = (Thread *)ListTop(_threadsList);
-                }
-
-                break;
-            }
+        Thread * thread = nullptr;
 
-            elem = elem->next;
-        }
-    }
+        elem = (elem->next != nullptr) ? elem->next : (ListElem *)_threadsList;
+        thread = (Thread *)elem->data;
+
+        if (RunnableThread(thread->state) && (foundThread == nullptr || thread->threadPriority > foundThread->threadPriority))
+            foundThread = thread;
+    } while (elem != currentElem);
 
-    return thread;
+    return foundThread;
 }
 
 void Scheduler::_SwitchToThread(InterruptContext * context, Thread * thread)
@@ -195,9 +204,15 @@ void Scheduler::_SwitchToThread(InterruptContext * context, Thread * thread)
     }
 
     _currentThread->SaveState(context);
-    _currentThread->state = THREAD_STATE_PAUSED;
+
+    // A waiting thread must not be picked again before its event is signaled
+    if (_currentThread->state == THREAD_STATE_RUNNING)
+        _currentThread->state = THREAD_STATE_PAUSED;
 
     _currentThread = thread;
+
+    gSharedData.SetRunningThread(_currentThread, _nbThreads, DEFAULT_THREAD_LIMIT_WORKING_TIME);
+
     _currentThread->StartOrResume();
 }
 
@@ -35,6 +35,12 @@ public:
     /// @brief Provokes a software interrupt, the associated routine will call the scheduler and start the next thread
     void ContextSwitchInterrupt();
 
+    /// @brief Provokes a context switch directly to the given thread, without looking for the next thread in the threads list.
+    ///        Used when the current thread blocks on behalf of another one (synchronous ipc for instance).
+    /// @note If the given thread is not runnable when the switch occurs, the next thread is picked as usual
+    /// @param[in] thread A pointer to the thread to be executed
+    void HandOff(Thread * thread);
+
     /// @brief Retrieves the current running process
     /// @return A pointer to the current process structure
     Process * GetCurrentProcess();
@@ -47,11 +53,13 @@ private:
     bool _running;
     List * _threadsList;
     Thread * _currentThread;
+    Thread * _handOffThread;
     unsigned int _nbThreads;
 
-    /// @brief Retrieves the next thread waiting to be executed
+    /// @brief Retrieves the next thread waiting to be executed : the runnable thread having the highest priority.
+    ///        Threads having the same priority are executed in turn, the current thread is picked last.
     /// @param[in] currentThread Pointer to the current thread
-    /// @return A pointer to the thread to be executed
+    /// @return A pointer to the thread to be executed, or nullptr if no thread is runnable
     Thread * _PickNextThread(Thread * currentThread);
 
     /// @brief Checks in the threads list if another thread has a higher priority than the given one
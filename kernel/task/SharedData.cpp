@@ -0,0 +1,102 @@
+#define __SHARED_DATA__
+#include "SharedData.hpp"
+
+#include <kernel/Kernel.hpp>
+#include <kernel/lib/StdMem.hpp>
+
+#include <kernel/Logger.hpp>
+#define KLOG(LOG_LEVEL, format, ...) KLOGGER("SHAREDDATA", LOG_LEVEL, format, ##__VA_ARGS__)
+
+/// @brief Prevents the compiler from moving the page accesses across the sequence updates.
+///        Loads and stores are not reordered between them on x86, readers are on the same processor anyway.
+#define COMPILER_BARRIER() asm volatile("" ::: "memory")
+
+void SharedDataPage::Init()
+{
+    Page page = PageAlloc();
+
+    if (page.vAddr == 0)
+    {
+        KLOG(LOG_ERROR, "PageAlloc() failed");
+        gKernel.Panic();
+    }
+
+    MemSet((void*)page.vAddr, 0, PAGE_SIZE);
+
+    _data = (KernelSharedData*)page.vAddr;
+    _pAddr = page.pAddr;
+}
+
+KeStatus SharedDataPage::MapInProcess(Process * const process)
+{
+    if (process == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid process parameter");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (_data == nullptr)
+    {
+        KLOG(LOG_ERROR, "The shared data page is not initialized");
+        return STATUS_UNEXPECTED;
+    }
+
+    return process->MapSharedDataPage(_pAddr);
+}
+
+void SharedDataPage::UpdateClock(const u32 seconds, const u32 milliseconds)
+{
+    // The clock starts before the memory managers are initialized
+    if (_data == nullptr)
+        return;
+
+    _BeginWrite();
+
+    _data->ticks++;
+    _data->seconds = seconds;
+    _data->milliseconds = milliseconds;
+
+    _EndWrite();
+}
+
+void SharedDataPage::SetRunningThread(const Thread * const thread, const u32 nbThreads, const u32 sliceTicks)
+{
+    if (_data == nullptr || thread == nullptr)
+        return;
+
+    _BeginWrite();
+
+    _data->currentPid = (thread->process != nullptr) ? thread->process->pid : 0;
+    _data->currentTid = thread->tid;
+    _data->threadPriority = thread->threadPriority;
+    _data->nbThreads = nbThreads;
+    _data->sliceStartTicks = _data->ticks;
+    _data->sliceTicks = sliceTicks;
+
+    _EndWrite();
+}
+
+void SharedDataPage::SetFastSyscallEntry(const bool enabled)
+{
+    if (_data == nullptr)
+        return;
+
+    _BeginWrite();
+
+    _data->fastSyscallEntry = enabled ? 1 : 0;
+
+    _EndWrite();
+}
+
+void SharedDataPage::_BeginWrite()
+{
+    // An odd sequence tells the readers that an update is in progress
+    _data->sequence++;
+    COMPILER_BARRIER();
+}
+
+void SharedDataPage::_EndWrite()
+{
+    COMPILER_BARRIER();
+    _data->sequence++;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <kernel/lib/Status.hpp>
+#include <kernel/lib/Types.hpp>
+
+#include <kernel/arch/x86/Thread.hpp>
+#include <kernel/arch/x86/Process.hpp>
+#include <kernel/syscalls/UKSyscallsCommon.h>
+
+/// @file
+
+/// @addgroup TaskGroup
+/// @{
+
+/// @brief Maintains the KernelSharedData page, mapped read-only at USER_SHARED_DATA_ADDR in every user process.
+///        Updates are made with interrupts disabled (clock and context switch interrupts), so there is a single writer at a time.
+class SharedDataPage
+{
+public:
+    /// @brief Allocates and clears the shared data page, panics on failure
+    void Init();
+
+    /// @brief Maps the shared data page read-only in a process address space
+    /// @param[in] process The process, its address space must not be used at USER_SHARED_DATA_ADDR
+    /// @return STATUS_SUCCESS on success, an error code otherwise
+    KeStatus MapInProcess(Process * const process);
+
+    /// @brief Called on each clock interrupt
+    /// @param[in] seconds Seconds since boot
+    /// @param[in] milliseconds Milliseconds in the current second
+    void UpdateClock(const u32 seconds, const u32 milliseconds);
+
+    /// @brief Called each time a thread is resumed, so that the page describes the running thread
+    /// @param[in] thread The resumed thread
+    /// @param[in] nbThreads Number of threads known by the scheduler
+    /// @param[in] sliceTicks Number of ticks the thread may run before being preempted
+    void SetRunningThread(const Thread * const thread, const u32 nbThreads, const u32 sliceTicks);
+
+    /// @brief Publishes the syscall entry the user stubs must use
+    /// @param[in] enabled True if the sysenter entry is set up, false if only the interrupt gate can be used
+    void SetFastSyscallEntry(const bool enabled);
+
+private:
+    void _BeginWrite();
+    void _EndWrite();
+
+    /// @brief Kernel mapping of the page, nullptr until Init() is called
+    KernelSharedData * _data;
+    /// @brief Physical address of the page
+    u32 _pAddr;
+};
+
+#ifdef __SHARED_DATA__
+SharedDataPage gSharedData;
+#else
+extern SharedDataPage gSharedData;
+#endif
+
+/// @}
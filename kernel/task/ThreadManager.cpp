@@ -87,7 +87,13 @@ clean:
 
 void ThreadManager::DeleteThread(Thread * thread)
 {
-    // TODO
+    if (thread == nullptr)
+    {
+        KLOG(LOG_ERROR, "Invalid thread parameter");
+        return;
+    }
+
+    Thread::Delete(thread);
 }
 
 Thread * ThreadManager::GetCurrentThread()
@@ -38,7 +38,7 @@ public:
     KeStatus CreateKernelThread(u32 entryAddr, Process * process, Thread ** thread);
 
     /// @brief Deletes a thread
-    /// @warning This does not stop its execution, or erase it from the scheduler, it just frees the structure describing the thread
+    /// @warning This does not stop its execution, or erase it from the scheduler, it just frees the structure describing the thread and its kernel stack
     /// @param[in] thread A pointer to the thread to delete
     void DeleteThread(Thread * thread);
 
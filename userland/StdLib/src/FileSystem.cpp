@@ -22,9 +22,7 @@ static Status FsInit()
     Status status = STATUS_FAILURE;
     IpcHandle serverHandle = INVALID_HANDLE_VALUE;
     IpcServer ipcServer;
-    LtFsRequest * connectRequest = nullptr;
     LtFsConnectParameter parameter;
-    unsigned int requestSize = 0;
 
     // TODO : find a way to generate a GUID
     const char uniqueIpcServerId[] = __TIME__;
@@ -41,23 +39,10 @@ static Status FsInit()
     // We send a connect request to the LtFs service so it can connect to our ipc server
     MemCopy((void*)uniqueIpcServerId, &(parameter.ipcServerId), StrLen(uniqueIpcServerId) + 1);
 
-    status = LtFsRequest::Create(LTFS_REQUEST_CONNECT, &parameter, sizeof(LtFsConnectParameter), &connectRequest);
+    status = LtFsRequest::Send(&gFsContext.ipcClient, serverHandle, LTFS_REQUEST_CONNECT, &parameter, sizeof(LtFsConnectParameter));
     if (FAILED(status))
         return status;
 
-    requestSize = sizeof(LtFsRequest) + sizeof(LtFsOpenFileParameters);
-
-    gFsContext.ipcClient.Send(serverHandle, (char*)connectRequest, requestSize);
-    if (FAILED(status))
-    {
-        if (connectRequest != nullptr)
-        {
-            HeapFree(connectRequest);
-            connectRequest = nullptr;
-        }
-        return status;
-    }
-
     gFsContext.isInitilaized = true;
     gFsContext.ltFsServiceHandle = serverHandle;
     gFsContext.ipcServer = ipcServer;
@@ -68,9 +53,7 @@ static Status FsInit()
 Status FsOpenFile(const char * filePath, const FileAccess access, const FileShareMode shareMode, Handle * const fileHandle)
 {
     Status status = STATUS_FAILURE;
-    LtFsRequest * request = nullptr;
     LtFsOpenFileParameters parameters;
-    unsigned int requestSize = 0;
 
     if (filePath == nullptr)
     {
@@ -112,15 +95,7 @@ Status FsOpenFile(const char * filePath, const FileAccess access, const FileShar
 
     MemCopy((void*)filePath, &(parameters.filePath), StrLen(filePath) + 1);
 
-    status = LtFsRequest::Create(LTFS_REQUEST_OPEN_FILE, &parameters, sizeof(LtFsOpenFileParameters), &request);
-    if (FAILED(status))
-    {
-        goto clean;
-    }
-
-    requestSize = sizeof(LtFsRequest) + sizeof(LtFsOpenFileParameters);
-
-    gFsContext.ipcClient.Send(gFsContext.ltFsServiceHandle, (char*)request, requestSize);
+    status = LtFsRequest::Send(&gFsContext.ipcClient, gFsContext.ltFsServiceHandle, LTFS_REQUEST_OPEN_FILE, &parameters, sizeof(LtFsOpenFileParameters));
     if (FAILED(status))
     {
         goto clean;
@@ -150,12 +125,6 @@ Status FsOpenFile(const char * filePath, const FileAccess access, const FileShar
     status = STATUS_SUCCESS;
 
 clean:
-    if (request != nullptr)
-    {
-        HeapFree(request);
-        request = nullptr;
-    }
-
     return status;
 }
 
@@ -0,0 +1,106 @@
+#include "IoRing.hpp"
+#include "syscalls.h"
+#include "stdio.h"
+
+/// The compiler must not move the entries accesses across the counters updates
+#define COMPILER_BARRIER() asm volatile("" ::: "memory")
+
+Status IoRing::Create(IoRing * const ring)
+{
+    Status status = STATUS_FAILURE;
+
+    if (ring == nullptr)
+    {
+        printf("Invalid ring parameter\n");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = (Status)_sysIoRingSetup(&ring->_queues);
+    if (FAILED(status))
+    {
+        printf("_sysIoRingSetup() failed with code %d\n", status);
+        goto clean;
+    }
+
+    ring->_nbPending = 0;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
+Status IoRing::Submit(const IoRingOpcode opcode, const int handle, void * const buffer, const unsigned int size, const unsigned int value, const unsigned int userData)
+{
+    const unsigned int tail = _queues->submissionTail;
+    IoRingSubmission * submission = nullptr;
+
+    if (opcode >= IO_RING_OP_MAX)
+    {
+        printf("Invalid opcode parameter\n");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (tail - _queues->submissionHead >= IO_RING_ENTRIES)
+        return STATUS_QUEUE_FULL;
+
+    submission = &_queues->submissions[tail & (IO_RING_ENTRIES - 1)];
+    submission->opcode = opcode;
+    submission->handle = handle;
+    submission->buffer = buffer;
+    submission->size = size;
+    submission->value = value;
+    submission->userData = userData;
+
+    COMPILER_BARRIER();
+
+    _queues->submissionTail = tail + 1;
+    _nbPending++;
+
+    return STATUS_SUCCESS;
+}
+
+Status IoRing::Enter(unsigned int * const nbExecuted)
+{
+    Status status = STATUS_FAILURE;
+    unsigned int executed = 0;
+
+    if (nbExecuted == nullptr)
+    {
+        printf("Invalid nbExecuted parameter\n");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = (Status)_sysIoRingEnter(_nbPending, &executed);
+    if (FAILED(status))
+    {
+        printf("_sysIoRingEnter() failed with code %d\n", status);
+        return status;
+    }
+
+    _nbPending -= executed;
+    *nbExecuted = executed;
+
+    return STATUS_SUCCESS;
+}
+
+bool IoRing::GetCompletion(IoRingCompletion * const completion)
+{
+    const unsigned int head = _queues->completionHead;
+
+    if (completion == nullptr)
+        return false;
+
+    if (head == _queues->completionTail)
+        return false;
+
+    COMPILER_BARRIER();
+
+    *completion = _queues->completions[head & (IO_RING_ENTRIES - 1)];
+
+    COMPILER_BARRIER();
+
+    _queues->completionHead = head + 1;
+
+    return true;
+}
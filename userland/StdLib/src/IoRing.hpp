@@ -0,0 +1,31 @@
+#pragma once
+
+#include "status.h"
+
+#include <kernel/syscalls/UKSyscallsCommon.h>
+
+/// Submission and completion queues shared with the kernel. Ipc operations are queued with Submit(), and a single
+/// syscall, Enter(), executes all of them in order and posts one completion per operation.
+/// The queues are not protected, a process must use its io ring from a single thread.
+class IoRing
+{
+public:
+    /// Maps the io ring of the process, a process has a single io ring
+    static Status Create(IoRing * const ring);
+
+    /// Queues an operation (see IoRingOpcode for the meaning of its parameters), STATUS_QUEUE_FULL is
+    /// returned if IO_RING_ENTRIES operations are already waiting for Enter()
+    Status Submit(const IoRingOpcode opcode, const int handle, void * const buffer, const unsigned int size, const unsigned int value, const unsigned int userData);
+
+    /// Executes every queued operation with a single syscall. nbExecuted may be lower than the number of queued operations
+    /// if the completion queue is full, the remaining ones are executed by the next Enter()
+    Status Enter(unsigned int * const nbExecuted);
+
+    /// Pops the oldest completion, returns false if there is none. The completion status is STATUS_SUCCESS or a kernel error code
+    bool GetCompletion(IoRingCompletion * const completion);
+
+private:
+    IoRingQueues * _queues;
+    /// Number of submissions queued since the last Enter()
+    unsigned int _nbPending;
+};
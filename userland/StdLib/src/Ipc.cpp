@@ -1,9 +1,15 @@
 #include "Ipc.hpp"
 #include "syscalls.h"
 #include "stdio.h"
+#include "stdlib.h"
 
 #include <kernel/syscalls/UKSyscallsCommon.h>
 
+/// The compiler must not move memory accesses across it
+#define COMPILER_BARRIER() asm volatile("" ::: "memory")
+/// Also orders a store with the following loads, which the processor may otherwise reorder
+#define MEMORY_BARRIER() __sync_synchronize()
+
 IpcStatus IpcServer::Create(const char * const serverName, IpcServer * const server)
 {
     IpcStatus status = STATUS_FAILURE;
@@ -39,7 +45,7 @@ clean:
     return status;
 }
 
-IpcStatus IpcServer::Receive(char * const buffer, const unsigned int size, unsigned int * const readBytes)
+IpcStatus IpcServer::Receive(char * const buffer, const unsigned int size, unsigned int * const readBytes, IpcSenderInfo * const sender)
 {
     IpcStatus status = STATUS_FAILURE;
     SysIpcReceiveParameter parameters;
@@ -66,10 +72,17 @@ IpcStatus IpcServer::Receive(char * const buffer, const unsigned int size, unsig
     parameters.buffer = buffer;
     parameters.size = size;
     parameters.readBytesPtr = readBytes;
+    parameters.senderPtr = sender;
+
+    *readBytes = 0;
 
     status = (IpcStatus)_sysIpcReceive(&parameters);
     if (FAILED(status))
     {
+        // The kernel only gives the message size back on failure when the buffer is too small
+        if (*readBytes > size)
+            return STATUS_BUFFER_TOO_SMALL;
+
         printf("_sysIpcReceive() failed with code %d\n", status);
         goto clean;
     }
@@ -80,6 +93,109 @@ clean:
     return status;
 }
 
+IpcStatus IpcServer::ReceivePages(IpcMessage * const message)
+{
+    IpcStatus status = STATUS_FAILURE;
+    SysIpcReceivePagesParameter parameters;
+
+    if (message == nullptr)
+    {
+        printf("Invalid message parameter\n");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    parameters.ipcHandle = _serverHandle;
+    parameters.bufferPtr = (char**)&message->data;
+    parameters.sizePtr = &message->size;
+
+    status = (IpcStatus)_sysIpcReceivePages(&parameters);
+    if (FAILED(status))
+    {
+        printf("_sysIpcReceivePages() failed with code %d\n", status);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
+IpcStatus IpcServer::ReplyWait(IpcRegisterMessage * const message)
+{
+    IpcStatus status = STATUS_FAILURE;
+
+    if (message == nullptr)
+    {
+        printf("Invalid message parameter\n");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = (IpcStatus)_sysIpcReplyWait(_serverHandle, message);
+    if (FAILED(status))
+    {
+        printf("_sysIpcReplyWait() failed with code %d\n", status);
+    }
+
+    return status;
+}
+
+IpcStatus IpcServer::AcceptChannel(IpcChannel * const channel)
+{
+    IpcStatus status = STATUS_FAILURE;
+    SysIpcChannelAcceptParameter parameters;
+
+    if (channel == nullptr)
+    {
+        printf("Invalid channel parameter\n");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    parameters.ipcHandle = _serverHandle;
+    parameters.channelHandlePtr = (unsigned int*)&channel->_channelHandle;
+    parameters.ringPtr = &channel->_ring;
+
+    status = (IpcStatus)_sysIpcChannelAccept(&parameters);
+    if (FAILED(status))
+    {
+        printf("_sysIpcChannelAccept() failed with code %d\n", status);
+        goto clean;
+    }
+
+    channel->_data = (char*)channel->_ring + IPC_MESSAGE_PAGE_SIZE;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
+IpcStatus IpcMessage::Release()
+{
+    IpcStatus status = STATUS_FAILURE;
+
+    if (data == nullptr)
+    {
+        printf("Invalid message data\n");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = (IpcStatus)_sysIpcReleaseMemory(data);
+    if (FAILED(status))
+    {
+        printf("_sysIpcReleaseMemory() failed with code %d\n", status);
+        goto clean;
+    }
+
+    data = nullptr;
+    size = 0;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
 IpcStatus IpcClient::ConnectToServer(const char * serverName, IpcServerHandle * const handle)
 {
     IpcStatus status = STATUS_FAILURE;
@@ -127,11 +243,423 @@ IpcStatus IpcClient::Send(const IpcServerHandle serverHandle, const char * messa
         return STATUS_INVALID_PARAMETER;
     }
 
+    if (size > IPC_MAX_MESSAGE_SIZE)
+    {
+        printf("The message can't be bigger than %d bytes\n", IPC_MAX_MESSAGE_SIZE);
+        return STATUS_MESSAGE_TOO_BIG;
+    }
+
     status = (IpcStatus)_sysIpcSend(serverHandle, message, size);
     if (FAILED(status))
     {
         printf("_sysIpcSend() failed with code %d\n", status);
     }
 
+    return status;
+}
+
+IpcStatus IpcClient::SendV(const IpcServerHandle serverHandle, const IpcIoVector * const vectors, const unsigned int nbVectors)
+{
+    IpcStatus status = STATUS_FAILURE;
+    SysIpcSendVParameter parameters;
+    unsigned int size = 0;
+
+    if (serverHandle == INVALID_HANDLE_VALUE)
+    {
+        printf("Invalid serverHandle parameter\n");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (vectors == nullptr)
+    {
+        printf("Invalid vectors parameter\n");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (nbVectors == 0 || nbVectors > IPC_MAX_IO_VECTORS)
+    {
+        printf("Invalid nbVectors parameter\n");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    for (unsigned int index = 0; index < nbVectors; index++)
+    {
+        if (vectors[index].size > IPC_MAX_MESSAGE_SIZE - size)
+        {
+            printf("The message can't be bigger than %d bytes\n", IPC_MAX_MESSAGE_SIZE);
+            return STATUS_MESSAGE_TOO_BIG;
+        }
+
+        size += vectors[index].size;
+    }
+
+    if (size == 0)
+    {
+        printf("Invaid size parameter\n");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    parameters.ipcHandle = serverHandle;
+    parameters.vectors = vectors;
+    parameters.nbVectors = nbVectors;
+
+    status = (IpcStatus)_sysIpcSendV(&parameters);
+    if (FAILED(status))
+    {
+        printf("_sysIpcSendV() failed with code %d\n", status);
+    }
+
+    return status;
+}
+
+IpcStatus IpcClient::SendPages(const IpcServerHandle serverHandle, const char * message, const unsigned int size, const bool keepAccess)
+{
+    IpcStatus status = STATUS_FAILURE;
+    SysIpcSendPagesParameter parameters;
+
+    if (serverHandle == INVALID_HANDLE_VALUE)
+    {
+        printf("Invalid serverHandle parameter\n");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (message == nullptr)
+    {
+        printf("Invalid message parameter\n");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (((unsigned int)message % IPC_MESSAGE_PAGE_SIZE) != 0)
+    {
+        printf("The message must be page aligned\n");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (size == 0)
+    {
+        printf("Invaid size parameter\n");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    parameters.ipcHandle = serverHandle;
+    parameters.buffer = (char*)message;
+    parameters.size = size;
+    parameters.flags = keepAccess ? IPC_SEND_PAGES_KEEP_ACCESS : IPC_SEND_PAGES_MOVE;
+
+    status = (IpcStatus)_sysIpcSendPages(&parameters);
+    if (FAILED(status))
+    {
+        printf("_sysIpcSendPages() failed with code %d\n", status);
+    }
+
+    return status;
+}
+IpcStatus IpcClient::Call(const IpcServerHandle serverHandle, IpcRegisterMessage * const message)
+{
+    IpcStatus status = STATUS_FAILURE;
+
+    if (serverHandle == INVALID_HANDLE_VALUE)
+    {
+        printf("Invalid serverHandle parameter\n");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (message == nullptr)
+    {
+        printf("Invalid message parameter\n");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    status = (IpcStatus)_sysIpcCall(serverHandle, message);
+    if (FAILED(status))
+    {
+        printf("_sysIpcCall() failed with code %d\n", status);
+    }
+
+    return status;
+}
+
+IpcStatus IpcClient::Disconnect(const IpcServerHandle serverHandle)
+{
+    IpcStatus status = STATUS_FAILURE;
+
+    if (serverHandle == INVALID_HANDLE_VALUE)
+    {
+        printf("Invalid serverHandle parameter\n");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    status = (IpcStatus)_sysIpcServerDisconnect(serverHandle);
+    if (FAILED(status))
+    {
+        printf("_sysIpcServerDisconnect() failed with code %d\n", status);
+    }
+
+    return status;
+}
+IpcStatus IpcChannel::Create(const IpcServerHandle serverHandle, const unsigned int size, IpcChannel * const channel)
+{
+    IpcStatus status = STATUS_FAILURE;
+    SysIpcChannelCreateParameter parameters;
+
+    if (serverHandle == INVALID_HANDLE_VALUE)
+    {
+        printf("Invalid serverHandle parameter\n");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (size < IPC_MESSAGE_PAGE_SIZE || size > IPC_CHANNEL_MAX_SIZE || (size & (size - 1)) != 0)
+    {
+        printf("Invalid size parameter\n");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (channel == nullptr)
+    {
+        printf("Invalid channel parameter\n");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    parameters.ipcHandle = serverHandle;
+    parameters.size = size;
+    parameters.channelHandlePtr = (unsigned int*)&channel->_channelHandle;
+    parameters.ringPtr = &channel->_ring;
+
+    status = (IpcStatus)_sysIpcChannelCreate(&parameters);
+    if (FAILED(status))
+    {
+        printf("_sysIpcChannelCreate() failed with code %d\n", status);
+        goto clean;
+    }
+
+    channel->_data = (char*)channel->_ring + IPC_MESSAGE_PAGE_SIZE;
+
+    status = STATUS_SUCCESS;
+
+clean:
+    return status;
+}
+
+IpcStatus IpcChannel::Write(const char * buffer, const unsigned int size)
+{
+    IpcStatus status = STATUS_FAILURE;
+    unsigned int written = 0;
+
+    if (buffer == nullptr)
+    {
+        printf("Invalid buffer parameter\n");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    while (written < size)
+    {
+        const unsigned int head = _ring->head;
+        const unsigned int tail = _ring->tail;
+        unsigned int nbBytes = _ring->size - (head - tail);
+        unsigned int offset = 0;
+        unsigned int firstSpanSize = 0;
+
+        if (_ring->closed)
+            return STATUS_CHANNEL_CLOSED;
+
+        if (nbBytes == 0)
+        {
+            // The consumer checks this flag after moving the tail, so either it sees it, or we see the new tail
+            _ring->producerWaiting = 1;
+            MEMORY_BARRIER();
+
+            if (_ring->tail == tail)
+            {
+                status = (IpcStatus)_sysIpcChannelWait(_channelHandle, &_ring->tail, tail);
+                if (FAILED(status))
+                {
+                    printf("_sysIpcChannelWait() failed with code %d\n", status);
+                    return status;
+                }
+            }
+
+            _ring->producerWaiting = 0;
+            continue;
+        }
+
+        if (nbBytes > size - written)
+            nbBytes = size - written;
+
+        offset = head & (_ring->size - 1);
+        firstSpanSize = _ring->size - offset;
+        if (firstSpanSize > nbBytes)
+            firstSpanSize = nbBytes;
+
+        MemCopy((void*)(buffer + written), _data + offset, firstSpanSize);
+        MemCopy((void*)(buffer + written + firstSpanSize), _data, nbBytes - firstSpanSize);
+
+        // The bytes are published once they are written, stores are not reordered by the processor
+        COMPILER_BARRIER();
+        _ring->head = head + nbBytes;
+        MEMORY_BARRIER();
+
+        if (_ring->consumerWaiting)
+        {
+            status = (IpcStatus)_sysIpcChannelWake(_channelHandle);
+            if (FAILED(status))
+            {
+                printf("_sysIpcChannelWake() failed with code %d\n", status);
+                return status;
+            }
+        }
+
+        written += nbBytes;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+IpcStatus IpcChannel::Read(char * const buffer, const unsigned int size, unsigned int * const readBytes)
+{
+    IpcStatus status = STATUS_FAILURE;
+
+    if (buffer == nullptr)
+    {
+        printf("Invalid buffer parameter\n");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (size == 0)
+    {
+        printf("Invalid size parameter\n");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (readBytes == nullptr)
+    {
+        printf("Invalid readBytes parameter\n");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    while (1)
+    {
+        const unsigned int head = _ring->head;
+        const unsigned int tail = _ring->tail;
+        unsigned int nbBytes = head - tail;
+        unsigned int offset = 0;
+        unsigned int firstSpanSize = 0;
+
+        if (nbBytes == 0)
+        {
+            // The head isn't moved after the close, if it didn't move since it was read every byte has been read
+            if (_ring->closed)
+            {
+                COMPILER_BARRIER();
+                if (_ring->head == head)
+                    return STATUS_CHANNEL_CLOSED;
+
+                continue;
+            }
+
+            _ring->consumerWaiting = 1;
+            MEMORY_BARRIER();
+
+            if (_ring->head == head)
+            {
+                status = (IpcStatus)_sysIpcChannelWait(_channelHandle, &_ring->head, head);
+                if (FAILED(status))
+                {
+                    printf("_sysIpcChannelWait() failed with code %d\n", status);
+                    return status;
+                }
+            }
+
+            _ring->consumerWaiting = 0;
+            continue;
+        }
+
+        if (nbBytes > size)
+            nbBytes = size;
+
+        offset = tail & (_ring->size - 1);
+        firstSpanSize = _ring->size - offset;
+        if (firstSpanSize > nbBytes)
+            firstSpanSize = nbBytes;
+
+        // The head has been read before the bytes it publishes, loads are not reordered by the processor
+        COMPILER_BARRIER();
+        MemCopy(_data + offset, buffer, firstSpanSize);
+        MemCopy(_data, buffer + firstSpanSize, nbBytes - firstSpanSize);
+
+        COMPILER_BARRIER();
+        _ring->tail = tail + nbBytes;
+        MEMORY_BARRIER();
+
+        if (_ring->producerWaiting)
+        {
+            status = (IpcStatus)_sysIpcChannelWake(_channelHandle);
+            if (FAILED(status))
+            {
+                printf("_sysIpcChannelWake() failed with code %d\n", status);
+                return status;
+            }
+        }
+
+        *readBytes = nbBytes;
+
+        return STATUS_SUCCESS;
+    }
+}
+
+IpcStatus IpcChannel::Close()
+{
+    IpcStatus status = STATUS_FAILURE;
+
+    status = (IpcStatus)_sysIpcChannelClose(_channelHandle);
+    if (FAILED(status))
+    {
+        printf("_sysIpcChannelClose() failed with code %d\n", status);
+        return status;
+    }
+
+    _channelHandle = INVALID_HANDLE_VALUE;
+    _ring = nullptr;
+    _data = nullptr;
+
+    return STATUS_SUCCESS;
+}
+
+IpcStatus IpcWaitMultiple(IpcWaitEntry * const entries, const unsigned int nbEntries, unsigned int * const nbReady)
+{
+    IpcStatus status = STATUS_FAILURE;
+    SysIpcWaitMultipleParameter parameters;
+
+    if (entries == nullptr)
+    {
+        printf("Invalid entries parameter\n");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    if (nbEntries == 0 || nbEntries > IPC_WAIT_MAX_ENTRIES)
+    {
+        printf("Invalid nbEntries parameter\n");
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (nbReady == nullptr)
+    {
+        printf("Invalid nbReady parameter\n");
+        return STATUS_NULL_PARAMETER;
+    }
+
+    parameters.entries = entries;
+    parameters.nbEntries = nbEntries;
+    parameters.nbReadyPtr = nbReady;
+
+    status = (IpcStatus)_sysIpcWaitMultiple(&parameters);
+    if (FAILED(status))
+    {
+        printf("_sysIpcWaitMultiple() failed with code %d\n", status);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
     return status;
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "status.h"
 
+#include <kernel/syscalls/UKSyscallsCommon.h>
+
 #define INVALID_HANDLE_VALUE 0
 
 typedef Status IpcStatus;
@@ -11,12 +13,48 @@ typedef IpcHandle IpcServerHandle;
 // tmp
 typedef int ProcessHandle;
 
+/// Message size granularity of the zero copy ipc, a pages message must be aligned on it
+#define IPC_MESSAGE_PAGE_SIZE IPC_PAGE_SIZE
+
 struct IpcMessage
 {
     void * data;
     unsigned int size;
 
-    // void Release();
+    /// Unmaps the message pages received with IpcServer::ReceivePages()
+    IpcStatus Release();
+};
+
+/// Ring buffer shared by a producer process and a consumer server. Bytes are written and read without
+/// syscalls, the kernel is only entered to wait when the ring is full or empty and to wake the other side up.
+/// A channel has a single producer and a single consumer.
+class IpcChannel
+{
+public:
+    /// Creates a channel with a data ring of size bytes (a power of two, at least IPC_MESSAGE_PAGE_SIZE) and offers it to
+    /// the server, which gets it with IpcServer::AcceptChannel(). The calling process is the producer.
+    static IpcStatus Create(const IpcServerHandle serverHandle, const unsigned int size, IpcChannel * const channel);
+
+    /// Copies the whole buffer in the ring, waiting for the consumer when the ring is full.
+    /// STATUS_CHANNEL_CLOSED is returned once the consumer closed the channel.
+    IpcStatus Write(const char * buffer, const unsigned int size);
+
+    /// Copies at most size bytes from the ring, waiting for the producer while the ring is empty.
+    /// STATUS_CHANNEL_CLOSED is returned once the producer closed the channel and every byte was read.
+    IpcStatus Read(char * const buffer, const unsigned int size, unsigned int * const readBytes);
+
+    /// Unmaps the ring and wakes the other side up, the channel is freed once both sides closed it
+    IpcStatus Close();
+
+    /// Handle to give to IpcWaitMultiple()
+    IpcHandle GetHandle() const { return _channelHandle; }
+
+private:
+    friend class IpcServer;
+
+    IpcHandle _channelHandle;
+    IpcChannelRing * _ring;
+    char * _data;
 };
 
 class IpcServer
@@ -24,7 +62,25 @@ class IpcServer
 public:
     static IpcStatus Create(const char * const serverName, IpcServer * const server);
 
-    IpcStatus Receive(char * const buffer, const unsigned int size, unsigned int * const readByteses);
+    /// Receives exactly one message. If it doesn't fit in the buffer, STATUS_BUFFER_TOO_SMALL is returned,
+    /// readBytes holds the message size and the message is kept until a big enough buffer is given.
+    /// The clients are served in turn, one message each. If sender is given, it holds the identity of the client
+    /// that sent the message, stamped by the kernel.
+    IpcStatus Receive(char * const buffer, const unsigned int size, unsigned int * const readBytes, IpcSenderInfo * const sender = nullptr);
+
+    /// Receives a message sent with IpcClient::SendPages(), the message pages are mapped
+    /// in the process without copy and must be released with IpcMessage::Release()
+    IpcStatus ReceivePages(IpcMessage * const message);
+
+    /// Replies to the last call received (the message content is ignored if there is none), waits
+    /// for the next call made with IpcClient::Call() and copies its content in message
+    IpcStatus ReplyWait(IpcRegisterMessage * const message);
+
+    /// Waits for a channel created with IpcChannel::Create() and maps its ring, the server is the consumer
+    IpcStatus AcceptChannel(IpcChannel * const channel);
+
+    /// Handle to give to IpcWaitMultiple()
+    IpcHandle GetHandle() const { return _serverHandle; }
 
 private:
     IpcHandle _serverHandle;
@@ -35,5 +91,27 @@ class IpcClient
 public:
     IpcStatus ConnectToServer(const char * serverName, IpcServerHandle * const handle);
 
+    /// Sends a message of at most IPC_MAX_MESSAGE_SIZE bytes, it is received as a whole by the server
     IpcStatus Send(const IpcServerHandle serverHandle, const char * message, const unsigned int size);
-};
\ No newline at end of file
+
+    /// Sends a single message made of several buffers (at most IPC_MAX_IO_VECTORS), without assembling
+    /// them in a contiguous copy first. The server receives it as if it was sent with Send().
+    IpcStatus SendV(const IpcServerHandle serverHandle, const IpcIoVector * const vectors, const unsigned int nbVectors);
+
+    /// Sends a page aligned message without copy. If keepAccess is true, the message pages
+    /// are shared (copy-on-write), else they are moved to the server and their content is lost.
+    IpcStatus SendPages(const IpcServerHandle serverHandle, const char * message, const unsigned int size, const bool keepAccess);
+
+    /// Sends a message passed in registers and waits for the server reply, which is copied in message.
+    /// The processor is directly given to the server thread if it is waiting in IpcServer::ReplyWait().
+    IpcStatus Call(const IpcServerHandle serverHandle, IpcRegisterMessage * const message);
+
+    /// Frees the queue the kernel keeps for this client on the server, with the messages the server didn't read yet.
+    /// Threads of the client blocked in Send() on a full queue fail, a next message gets a new queue.
+    IpcStatus Disconnect(const IpcServerHandle serverHandle);
+};
+
+/// Waits until at least one of the entries is ready for one of its IPC_WAIT_* events, so that a single thread can serve
+/// several ipc servers and channels. An entry handle is an IpcServer or an IpcChannel handle, see their GetHandle().
+/// The readyEvents field of every entry is set, nbReady holds the number of entries with at least one ready event.
+IpcStatus IpcWaitMultiple(IpcWaitEntry * const entries, const unsigned int nbEntries, unsigned int * const nbReady);
\ No newline at end of file
@@ -20,6 +20,11 @@
 
 #define PAGE_SIZE 4096
 
+/// @brief Blocks of at least this size (header included) get their own mapping, given back to the system when they are freed
+#define MAPPED_BLOCK_THRESHOLD PAGE_SIZE
+/// @brief Size stored in the header of a mapped block, a heap block is never empty
+#define MAPPED_BLOCK_SIZE 0
+
 /// @brief Describes a block
 struct MemBlock
 {
@@ -34,6 +39,7 @@ struct MemBlock
 static void * _Allocate(MemBlock * block, unsigned int size);
 static void _SplitBlock(MemBlock * block, unsigned int size);
 static MemBlock * _Sbrk(int n);
+static void * _MapBlock(unsigned int size);
 
 /* TODO : find a way to implemet mod */
 static unsigned int _local_mod(unsigned int a, unsigned int b)
@@ -89,6 +95,11 @@ void * HeapAlloc(int size)
         return nullptr;
     }
 
+    blockSize = ClosestPow((unsigned int)size + BLOCK_HEADER_SIZE, 4);
+
+    if (blockSize >= MAPPED_BLOCK_THRESHOLD)
+        return _MapBlock(blockSize);
+
     if (g_baseBlock == nullptr)
     {
         g_baseBlock = (MemBlock*)_Sbrk(1);
@@ -98,8 +109,6 @@ void * HeapAlloc(int size)
         g_lastBlock = g_baseBlock;
     }
 
-    blockSize = ClosestPow((unsigned int)size + BLOCK_HEADER_SIZE, 4);
-
     void * res = nullptr;
     res = _Allocate(g_baseBlock, (int)blockSize);
     if (res == nullptr)
@@ -120,6 +129,13 @@ void HeapFree(void * ptr)
 
     MemBlock * block = (MemBlock*)((u32)ptr - BLOCK_HEADER_SIZE);
 
+    // The header of a mapped block is at the base of its mapping, the whole mapping is released
+    if (block->size == MAPPED_BLOCK_SIZE)
+    {
+        Unmap(block);
+        return;
+    }
+
     if (block->state == BLOCK_FREE)
     {
         //__debugbreak();
@@ -183,6 +199,21 @@ static void _SplitBlock(MemBlock * block, unsigned int size)
     block->size = size;
 }
 
+/// @brief The mapping is zero-filled and committed page by page on first access, so a large block costs
+///        only the pages the process touches
+static void * _MapBlock(unsigned int size)
+{
+    MemBlock * block = nullptr;
+
+    if (FAILED(MapAnonymous(size, MEMORY_PROTECTION_READ_WRITE, (void**)&block)))
+        return nullptr;
+
+    block->size = MAPPED_BLOCK_SIZE;
+    block->state = BLOCK_USED;
+
+    return &(block->data);
+}
+
 static MemBlock * _Sbrk(int n)
 {
     if (n <= 0)
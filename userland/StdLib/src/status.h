@@ -16,6 +16,10 @@
     STATUS_ELEM (STATUS_PATH_TOO_LONG)                \
     STATUS_ELEM (STATUS_LIST_STOP_ITERATING)          \
     STATUS_ELEM (STATUS_ACCESS_DENIED)                \
+    STATUS_ELEM (STATUS_BUFFER_TOO_SMALL)             \
+    STATUS_ELEM (STATUS_MESSAGE_TOO_BIG)              \
+    STATUS_ELEM (STATUS_QUEUE_FULL)                   \
+    STATUS_ELEM (STATUS_CHANNEL_CLOSED)               \
 
 enum Status
 {
@@ -96,4 +96,47 @@ void RaiseThreadPriority()
 void LowerThreadPriority()
 {
     _sysLowerThreadPriority();
+}
+Status Spawn(void (*entry)(void *), void * const argument, int * const pid)
+{
+    return (Status)_sysSpawn(entry, argument, pid);
+}
+Status AllocateLargePages(const unsigned int size, void ** const address)
+{
+    return (Status)_sysMapLargePages(size, address);
+}
+
+Status ReleaseLargePages(void * const address)
+{
+    return (Status)_sysUnmap(address);
+}
+Status MapAnonymous(const unsigned int size, const unsigned int protection, void ** const address)
+{
+    return (Status)_sysMapAnonymous(size, protection, address);
+}
+
+Status Unmap(void * const address)
+{
+    return (Status)_sysUnmap(address);
+}
+
+Status Protect(void * const address, const unsigned int protection)
+{
+    return (Status)_sysProtect(address, protection);
+}Status GetMemoryStats(const unsigned int pid, ProcessMemoryStats * const stats)
+{
+    SysMemoryStatsParameter parameters = { MEMORY_STATS_GET, pid, stats };
+
+    return (Status)_sysMemoryStats(&parameters);
+}
+
+Status SetMemoryLimits(const unsigned int residentPagesLimit, const unsigned int committedBytesLimit)
+{
+    ProcessMemoryStats limits = { 0 };
+    SysMemoryStatsParameter parameters = { MEMORY_STATS_SET_LIMITS, 0, &limits };
+
+    limits.residentPagesLimit = residentPagesLimit;
+    limits.committedBytesLimit = committedBytesLimit;
+
+    return (Status)_sysMemoryStats(&parameters);
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "FileSystem.h"
 #include "types.h"
 
+#include <kernel/syscalls/UKSyscallsCommon.h>
+
 #define __debugbreak() asm("int $3")
 
 #define FlagOn(a, b) (((a) & (b)) != 0)
@@ -45,3 +47,54 @@ void MemSet(void * src, u8 byte, unsigned int size);
 // TODO : put that somewhere else
 void RaiseThreadPriority();
 void LowerThreadPriority();
+
+/// @brief Creates a new process cloning the current one : the memory is shared copy-on-write, so spawning is cheap.
+///        The new process main thread runs entry(argument) on its own stack, entry must never return.
+/// @param[in]  entry The function run by the new process
+/// @param[in]  argument The entry parameter, a pointer to the current process memory is valid in the new process
+/// @param[out] pid Pointer that will hold the new process id, may be nullptr
+/// @return STATUS_SUCCESS on success, an error code otherwise
+Status Spawn(void (*entry)(void *), void * const argument, int * const pid);
+
+/// @brief Maps memory with 4Mo pages, a single TLB entry covers each of them. The memory is committed immediately, zero-filled.
+///        It can't be sent with IpcClient::SendPages(), and a process spawned from the current one gets a copy of it.
+/// @param[in]  size The size in bytes, rounded up to a multiple of 4Mo
+/// @param[out] address Pointer that will hold the 4Mo aligned memory address
+/// @return STATUS_SUCCESS on success, an error code otherwise (the processor may not support large pages)
+Status AllocateLargePages(const unsigned int size, void ** const address);
+
+/// @brief Releases memory mapped with AllocateLargePages()
+/// @param[in] address The address given by AllocateLargePages()
+/// @return STATUS_SUCCESS on success, an error code otherwise
+Status ReleaseLargePages(void * const address);
+
+/// @brief Maps zero-filled memory in a new area of the address space. No physical page is used until a page is first touched.
+/// @param[in]  size The size in bytes, rounded up to a multiple of the page size
+/// @param[in]  protection MEMORY_PROTECTION_READ_ONLY or MEMORY_PROTECTION_READ_WRITE
+/// @param[out] address Pointer that will hold the page aligned memory address
+/// @return STATUS_SUCCESS on success, an error code otherwise
+Status MapAnonymous(const unsigned int size, const unsigned int protection, void ** const address);
+
+/// @brief Unmaps a whole area mapped with MapAnonymous(), its physical pages are given back to the system
+/// @param[in] address The address given by MapAnonymous()
+/// @return STATUS_SUCCESS on success, an error code otherwise
+Status Unmap(void * const address);
+
+/// @brief Changes the protection of a whole area mapped with MapAnonymous()
+/// @param[in] address The address given by MapAnonymous()
+/// @param[in] protection MEMORY_PROTECTION_READ_ONLY or MEMORY_PROTECTION_READ_WRITE
+/// @return STATUS_SUCCESS on success, an error code otherwise
+Status Protect(void * const address, const unsigned int protection);
+
+/// @brief Retrieves the memory used by a process
+/// @param[in]  pid The process id, MEMORY_STATS_CURRENT_PROCESS for the current process
+/// @param[out] stats Pointer that will hold the process memory stats
+/// @return STATUS_SUCCESS on success, an error code otherwise
+Status GetMemoryStats(const unsigned int pid, ProcessMemoryStats * const stats);
+
+/// @brief Limits the memory of the current process and of the processes it spawns afterwards.
+///        An allocation or a first access to a page that would exceed a limit fails, the faulting thread is terminated.
+/// @param[in] residentPagesLimit Maximum number of pages backed by physical memory, 0 if unlimited
+/// @param[in] committedBytesLimit Maximum number of bytes of mapped memory, 0 if unlimited
+/// @return STATUS_SUCCESS on success, an error code otherwise
+Status SetMemoryLimits(const unsigned int residentPagesLimit, const unsigned int committedBytesLimit);
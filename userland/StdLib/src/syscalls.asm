@@ -2,6 +2,10 @@
 
 %define SYSCALL_INTERRUPT                 0x30
 
+%define USER_SHARED_DATA_ADDR             0xFFBFF000
+;;; Offset of fastSyscallEntry in the KernelSharedData structure
+%define SHARED_DATA_FAST_ENTRY_OFFSET     40
+
 %define SYSCALL_PRINT_CHAR                0x0
 %define SYSCALL_PRINT_STR                 0x1
 %define SYSCALL_SBRK                      0x2
@@ -13,6 +17,28 @@
 %define SYS_LEAVE_SCREEN_CRITICAL_SECTION 0x8
 %define SYS_RAISE_THREAD_PRIORITY         0x9
 %define SYS_LOWER_THREAD_PRIORITY         0xA
+%define SYS_IPC_SEND_PAGES                0xB
+%define SYS_IPC_RECEIVE_PAGES             0xC
+%define SYS_IPC_RELEASE_MEMORY            0xD
+%define SYS_IPC_CALL                      0xE
+%define SYS_IPC_REPLY_WAIT                0xF
+%define SYS_IPC_SEND_V                    0x10
+%define SYS_IPC_CHANNEL_CREATE            0x11
+%define SYS_IPC_CHANNEL_ACCEPT            0x12
+%define SYS_IPC_CHANNEL_WAIT              0x13
+%define SYS_IPC_CHANNEL_WAKE              0x14
+%define SYS_IO_RING_SETUP                 0x15
+%define SYS_IO_RING_ENTER                 0x16
+%define SYS_IPC_WAIT_MULTIPLE             0x17
+%define SYS_SYSCALL_STATS                 0x18
+%define SYS_SPAWN                         0x19
+%define SYS_MAP_LARGE_PAGES               0x1A
+%define SYS_MAP_ANONYMOUS                 0x1B
+%define SYS_UNMAP                         0x1C
+%define SYS_PROTECT                       0x1D
+%define SYS_MEMORY_STATS                  0x1E
+%define SYS_IPC_CHANNEL_CLOSE             0x1F
+%define SYS_IPC_SERVER_DISCONNECT         0x20
 
 global _sysPrint
 global _sysPrintChar
@@ -25,6 +51,83 @@ global _sysEnterScreenCriticalSection
 global _sysLeaveScreenCriticalSection
 global _sysRaiseThreadPriority
 global _sysLowerThreadPriority
+global _sysIpcSendPages
+global _sysIpcReceivePages
+global _sysIpcReleaseMemory
+global _sysIpcCall
+global _sysIpcReplyWait
+global _sysIpcSendV
+global _sysIpcChannelCreate
+global _sysIpcChannelAccept
+global _sysIpcChannelWait
+global _sysIpcChannelWake
+global _sysIoRingSetup
+global _sysIoRingEnter
+global _sysIpcWaitMultiple
+global _sysSyscallStats
+global _sysSpawn
+global _sysMapLargePages
+global _sysMapAnonymous
+global _sysUnmap
+global _sysProtect
+global _sysMemoryStats
+global _sysIpcChannelClose
+global _sysIpcServerDisconnect
+global _sysSelectEntry
+
+;;; Enters the kernel through the entry selected in _syscallEntry, with the syscall id in eax and
+;;; the parameters in ebx, ecx, edx, esi and edi, as with int SYSCALL_INTERRUPT.
+;;; ecx and edx are not preserved, the syscalls that give values back in them use the interrupt.
+%macro SYSCALL_ENTER 0
+    call [_syscallEntry]
+%endmacro
+
+section .data
+
+;;; The entry is chosen on the first syscall, see _syscallProbe
+_syscallEntry dd _syscallProbe
+
+section .text
+
+;;; Syscall through the interrupt gate, works on every processor
+_syscallInterrupt:
+    int SYSCALL_INTERRUPT
+    ret
+
+;;; Fast syscall, the kernel returns with sysexit to the address on top of the stack we pass in ebp,
+;;; and pops it the way ret would
+_syscallSysenter:
+    push ebp
+    push _syscallSysenterReturn
+    mov ebp, esp
+
+    sysenter
+
+_syscallSysenterReturn:
+    pop ebp
+    ret
+
+;;; Gives back in eax the entry the kernel set up, as published in the shared data page
+_syscallGetBestEntry:
+    cmp dword [USER_SHARED_DATA_ADDR + SHARED_DATA_FAST_ENTRY_OFFSET], 0
+    je .interrupt
+
+    mov eax, _syscallSysenter
+    ret
+
+.interrupt:
+    mov eax, _syscallInterrupt
+    ret
+
+;;; First entry of every process, selects the entry used by the next syscalls and goes on with it
+_syscallProbe:
+    push eax
+    call _syscallGetBestEntry
+    mov [_syscallEntry], eax
+    pop eax
+
+    jmp [_syscallEntry]
+
 
 _sysPrint:
     push ebp
@@ -33,7 +136,7 @@ _sysPrint:
     mov ebx, [ebp+8] ; we retrieve the pointer to the string on the stack
     mov eax, SYSCALL_PRINT_STR
 
-    int SYSCALL_INTERRUPT
+    SYSCALL_ENTER
 
     leave
     ret
@@ -45,7 +148,7 @@ _sysPrintChar:
     mov ebx, [ebp+8] ; we retrieve the char on the stack
     mov eax, SYSCALL_PRINT_CHAR
 
-    int SYSCALL_INTERRUPT
+    SYSCALL_ENTER
 
     leave
     ret
@@ -57,7 +160,7 @@ _sysSbrk:
     mov ebx, [ebp+8] ; we retrieve the parameter on the stack
     mov eax, SYSCALL_SBRK
 
-    int SYSCALL_INTERRUPT
+    SYSCALL_ENTER
 
     leave
     ret
@@ -70,8 +173,9 @@ _sysIpcServerCreate:
 	mov ecx, [ebp+12]  ; we retrieve the second parameter (handle) on the stack
     mov eax, SYS_IPC_SERVER_CREATE
 
-    int SYSCALL_INTERRUPT
+    SYSCALL_ENTER
 
+	mov ecx, [ebp+12] ; ecx is not preserved by the syscall
 	mov [ecx], ebx
 
     leave
@@ -85,8 +189,9 @@ _sysIpcServerConnect:
 	mov ecx, [ebp+12]  ; we retrieve the second parameter (handle) on the stack
     mov eax, SYS_IPC_SERVER_CONNECT
 
-    int SYSCALL_INTERRUPT
+    SYSCALL_ENTER
 
+	mov ecx, [ebp+12] ; ecx is not preserved by the syscall
 	mov [ecx], ebx
 
     leave
@@ -101,7 +206,7 @@ _sysIpcSend:
 	mov edx, [ebp+16] ; we retrieve the third parameter (size) on the stack
     mov eax, SYS_IPC_SEND
 
-    int SYSCALL_INTERRUPT
+    SYSCALL_ENTER
 
     leave
     ret
@@ -113,7 +218,7 @@ _sysIpcReceive:
     mov ebx, [ebp+8]  ; we retrieve the ipc receive syscall parameter pointer on the stack
     mov eax, SYS_IPC_RECEIVE
 
-    int SYSCALL_INTERRUPT
+    SYSCALL_ENTER
 
     leave
     ret
@@ -124,7 +229,7 @@ _sysEnterScreenCriticalSection:
 
     mov eax, SYS_ENTER_SCREEN_CRITICAL_SECTION
 
-    int SYSCALL_INTERRUPT
+    SYSCALL_ENTER
 
     leave
     ret
@@ -135,7 +240,7 @@ _sysLeaveScreenCriticalSection:
 
     mov eax, SYS_LEAVE_SCREEN_CRITICAL_SECTION
 
-    int SYSCALL_INTERRUPT
+    SYSCALL_ENTER
 
     leave
     ret
@@ -146,7 +251,7 @@ _sysRaiseThreadPriority:
 
     mov eax, SYS_RAISE_THREAD_PRIORITY
 
-    int SYSCALL_INTERRUPT
+    SYSCALL_ENTER
 
     leave
     ret
@@ -157,7 +262,369 @@ _sysLowerThreadPriority:
 
     mov eax, SYS_LOWER_THREAD_PRIORITY
 
+    SYSCALL_ENTER
+
+    leave
+    ret
+_sysIpcSendPages:
+    push ebp
+    mov ebp, esp
+
+    mov ebx, [ebp+8]  ; we retrieve the ipc send pages syscall parameter pointer on the stack
+    mov eax, SYS_IPC_SEND_PAGES
+
+    SYSCALL_ENTER
+
+    leave
+    ret
+
+_sysIpcReceivePages:
+    push ebp
+    mov ebp, esp
+
+    mov ebx, [ebp+8]  ; we retrieve the ipc receive pages syscall parameter pointer on the stack
+    mov eax, SYS_IPC_RECEIVE_PAGES
+
+    SYSCALL_ENTER
+
+    leave
+    ret
+
+_sysIpcReleaseMemory:
+    push ebp
+    mov ebp, esp
+
+    mov ebx, [ebp+8]  ; we retrieve the pointer to the memory to release on the stack
+    mov eax, SYS_IPC_RELEASE_MEMORY
+
+    SYSCALL_ENTER
+
+    leave
+    ret
+_sysIpcCall:
+    push ebp
+    mov ebp, esp
+    push ebx
+    push esi
+    push edi
+
+    mov eax, [ebp+12] ; we retrieve the second parameter (message pointer) on the stack
+    mov ecx, [eax]    ; the message words are passed in ecx, edx, esi and edi
+    mov edx, [eax+4]
+    mov esi, [eax+8]
+    mov edi, [eax+12]
+    mov ebx, [ebp+8]  ; we retrieve the first parameter (ipcHandle) on the stack
+    mov eax, SYS_IPC_CALL
+
+    int SYSCALL_INTERRUPT
+
+    mov ebx, [ebp+12] ; the reply words are given back in the same registers
+    mov [ebx], ecx
+    mov [ebx+4], edx
+    mov [ebx+8], esi
+    mov [ebx+12], edi
+
+    pop edi
+    pop esi
+    pop ebx
+    leave
+    ret
+
+_sysIpcReplyWait:
+    push ebp
+    mov ebp, esp
+    push ebx
+    push esi
+    push edi
+
+    mov eax, [ebp+12] ; we retrieve the second parameter (reply pointer) on the stack
+    mov ecx, [eax]    ; the reply words are passed in ecx, edx, esi and edi
+    mov edx, [eax+4]
+    mov esi, [eax+8]
+    mov edi, [eax+12]
+    mov ebx, [ebp+8]  ; we retrieve the first parameter (ipcHandle) on the stack
+    mov eax, SYS_IPC_REPLY_WAIT
+
     int SYSCALL_INTERRUPT
 
+    mov ebx, [ebp+12] ; the next message words are given back in the same registers
+    mov [ebx], ecx
+    mov [ebx+4], edx
+    mov [ebx+8], esi
+    mov [ebx+12], edi
+
+    pop edi
+    pop esi
+    pop ebx
+    leave
+    ret
+_sysIpcSendV:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the ipc vectored send syscall parameter pointer on the stack
+    mov eax, SYS_IPC_SEND_V
+
+    SYSCALL_ENTER
+
+    pop ebx
+    leave
+    ret
+
+_sysIpcChannelCreate:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the channel create syscall parameter pointer on the stack
+    mov eax, SYS_IPC_CHANNEL_CREATE
+
+    SYSCALL_ENTER
+
+    pop ebx
+    leave
+    ret
+
+_sysIpcChannelAccept:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the channel accept syscall parameter pointer on the stack
+    mov eax, SYS_IPC_CHANNEL_ACCEPT
+
+    SYSCALL_ENTER
+
+    pop ebx
+    leave
+    ret
+
+_sysIpcChannelWait:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the channel handle on the stack
+    mov ecx, [ebp+12] ; the ring word to watch
+    mov edx, [ebp+16] ; and the value it must still hold for the thread to wait
+    mov eax, SYS_IPC_CHANNEL_WAIT
+
+    SYSCALL_ENTER
+
+    pop ebx
+    leave
+    ret
+
+_sysIpcChannelWake:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the channel handle on the stack
+    mov eax, SYS_IPC_CHANNEL_WAKE
+
+    SYSCALL_ENTER
+
+    pop ebx
     leave
-    ret
\ No newline at end of file
+    ret
+
+_sysIoRingSetup:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the pointer that will hold the io ring address on the stack
+    mov eax, SYS_IO_RING_SETUP
+
+    SYSCALL_ENTER
+
+    pop ebx
+    leave
+    ret
+
+_sysIoRingEnter:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the number of submissions to execute on the stack
+    mov ecx, [ebp+12] ; and the pointer that will hold the number of executed submissions
+    mov eax, SYS_IO_RING_ENTER
+
+    SYSCALL_ENTER
+
+    mov ecx, [ebp+12] ; ecx is not preserved by the syscall
+    mov [ecx], ebx
+
+    pop ebx
+    leave
+    ret
+
+_sysIpcWaitMultiple:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the wait multiple syscall parameter pointer on the stack
+    mov eax, SYS_IPC_WAIT_MULTIPLE
+
+    SYSCALL_ENTER
+
+    pop ebx
+    leave
+    ret
+
+_sysSyscallStats:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the syscall stats parameter pointer on the stack
+    mov eax, SYS_SYSCALL_STATS
+
+    SYSCALL_ENTER
+
+    pop ebx
+    leave
+    ret
+
+_sysSpawn:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the first parameter (entry) on the stack
+    mov ecx, [ebp+12] ; we retrieve the second parameter (argument) on the stack
+    mov edx, [ebp+16] ; we retrieve the third parameter (pid pointer) on the stack
+    mov eax, SYS_SPAWN
+
+    SYSCALL_ENTER
+
+    pop ebx
+    leave
+    ret
+
+_sysMapLargePages:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the first parameter (size) on the stack
+    mov ecx, [ebp+12] ; we retrieve the second parameter (address pointer) on the stack
+    mov eax, SYS_MAP_LARGE_PAGES
+
+    SYSCALL_ENTER
+
+    pop ebx
+    leave
+    ret
+
+_sysMapAnonymous:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the first parameter (size) on the stack
+    mov ecx, [ebp+12] ; we retrieve the second parameter (protection) on the stack
+    mov edx, [ebp+16] ; we retrieve the third parameter (address pointer) on the stack
+    mov eax, SYS_MAP_ANONYMOUS
+
+    SYSCALL_ENTER
+
+    pop ebx
+    leave
+    ret
+
+_sysUnmap:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the first parameter (address) on the stack
+    mov eax, SYS_UNMAP
+
+    SYSCALL_ENTER
+
+    pop ebx
+    leave
+    ret
+
+_sysProtect:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the first parameter (address) on the stack
+    mov ecx, [ebp+12] ; we retrieve the second parameter (protection) on the stack
+    mov eax, SYS_PROTECT
+
+    SYSCALL_ENTER
+
+    pop ebx
+    leave
+    ret
+
+_sysMemoryStats:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the first parameter (SysMemoryStatsParameter pointer) on the stack
+    mov eax, SYS_MEMORY_STATS
+
+    SYSCALL_ENTER
+
+    pop ebx
+    leave
+    ret
+
+_sysIpcChannelClose:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the channel handle on the stack
+    mov eax, SYS_IPC_CHANNEL_CLOSE
+
+    SYSCALL_ENTER
+
+    pop ebx
+    leave
+    ret
+
+_sysIpcServerDisconnect:
+    push ebp
+    mov ebp, esp
+    push ebx
+
+    mov ebx, [ebp+8]  ; we retrieve the server handle on the stack
+    mov eax, SYS_IPC_SERVER_DISCONNECT
+
+    SYSCALL_ENTER
+
+    pop ebx
+    leave
+    ret
+
+;;; Selects the entry used by the next syscalls, the fastest one if the parameter is not 0, else the
+;;; interrupt (the benchmarks use it to compare both). Gives back 1 if sysenter is used afterwards.
+_sysSelectEntry:
+    push ebp
+    mov ebp, esp
+
+    mov eax, _syscallInterrupt
+    cmp dword [ebp+8], 0
+    je .select
+    call _syscallGetBestEntry
+
+.select:
+    mov [_syscallEntry], eax
+
+    cmp eax, _syscallSysenter
+    sete al
+    movzx eax, al
+
+    leave
+    ret
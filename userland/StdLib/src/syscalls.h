@@ -15,6 +15,30 @@ extern "C" int _sysIpcSend(const int ipcHandle, const char * message, const unsi
 extern "C" int _sysIpcReceive(SysIpcReceiveParameter * const parameters);
 extern "C" void _sysRaiseThreadPriority();
 extern "C" void _sysLowerThreadPriority();
+extern "C" int _sysIpcSendPages(SysIpcSendPagesParameter * const parameters);
+extern "C" int _sysIpcReceivePages(SysIpcReceivePagesParameter * const parameters);
+extern "C" int _sysIpcReleaseMemory(void * const ptr);
+extern "C" int _sysIpcCall(const int ipcHandle, IpcRegisterMessage * const message);
+extern "C" int _sysIpcReplyWait(const int ipcHandle, IpcRegisterMessage * const message);
+extern "C" int _sysIpcSendV(SysIpcSendVParameter * const parameters);
+extern "C" int _sysIpcChannelCreate(SysIpcChannelCreateParameter * const parameters);
+extern "C" int _sysIpcChannelAccept(SysIpcChannelAcceptParameter * const parameters);
+extern "C" int _sysIpcChannelWait(const int channelHandle, const volatile unsigned int * const word, const unsigned int expectedValue);
+extern "C" int _sysIpcChannelWake(const int channelHandle);
+extern "C" int _sysIoRingSetup(IoRingQueues ** const queues);
+extern "C" int _sysIoRingEnter(const unsigned int nbSubmissions, unsigned int * const nbExecuted);
+extern "C" int _sysIpcWaitMultiple(SysIpcWaitMultipleParameter * const parameters);
+extern "C" int _sysSyscallStats(SysSyscallStatsParameter * const parameters);
+extern "C" int _sysSpawn(void (*entry)(void *), void * const argument, int * const pid);
+extern "C" int _sysMapLargePages(const unsigned int size, void ** const address);
+extern "C" int _sysMapAnonymous(const unsigned int size, const unsigned int protection, void ** const address);
+extern "C" int _sysUnmap(void * const address);
+extern "C" int _sysProtect(void * const address, const unsigned int protection);
+extern "C" int _sysMemoryStats(SysMemoryStatsParameter * const parameters);
+extern "C" int _sysIpcChannelClose(const int channelHandle);
+extern "C" int _sysIpcServerDisconnect(const int serverHandle);
+/// Selects the fastest syscall entry if fast is not 0 (sysenter when supported), else the interrupt. Returns 1 if sysenter is used.
+extern "C" int _sysSelectEntry(const int fast);
 // TMP
 extern "C" void _sysEnterScreenCriticalSection();
 extern "C" void _sysLeaveScreenCriticalSection();
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "sysinfo.h"
+
+#define SharedData ((const KernelSharedData *)USER_SHARED_DATA_ADDR)
+
+/// Prevents the compiler from moving the page reads across the sequence reads
+#define COMPILER_BARRIER() asm volatile("" ::: "memory")
+
+/// Waits for the kernel to finish its current update, returns the sequence to check after the reads
+static unsigned int ReadBegin()
+{
+    unsigned int sequence = 0;
+
+    do
+    {
+        sequence = SharedData->sequence;
+    } while ((sequence & 1) != 0);
+
+    COMPILER_BARRIER();
+
+    return sequence;
+}
+
+/// Returns true if the kernel updated the page since ReadBegin(), the reads must be done again
+static bool ReadRetry(const unsigned int sequence)
+{
+    COMPILER_BARRIER();
+
+    return SharedData->sequence != sequence;
+}
+
+unsigned int GetTickCount()
+{
+    return SharedData->ticks;
+}
+
+void GetMonotonicTime(unsigned int * const seconds, unsigned int * const milliseconds)
+{
+    unsigned int sequence = 0;
+    unsigned int currentSeconds = 0;
+    unsigned int currentMilliseconds = 0;
+
+    do
+    {
+        sequence = ReadBegin();
+
+        currentSeconds = SharedData->seconds;
+        currentMilliseconds = SharedData->milliseconds;
+    } while (ReadRetry(sequence));
+
+    if (seconds != nullptr)
+        *seconds = currentSeconds;
+
+    if (milliseconds != nullptr)
+        *milliseconds = currentMilliseconds;
+}
+
+unsigned int GetCurrentProcessId()
+{
+    return SharedData->currentPid;
+}
+
+unsigned int GetCurrentThreadId()
+{
+    return SharedData->currentTid;
+}
+
+unsigned int GetRemainingTimeSlice()
+{
+    unsigned int sequence = 0;
+    unsigned int elapsed = 0;
+    unsigned int sliceTicks = 0;
+
+    do
+    {
+        sequence = ReadBegin();
+
+        elapsed = SharedData->ticks - SharedData->sliceStartTicks;
+        sliceTicks = SharedData->sliceTicks;
+    } while (ReadRetry(sequence));
+
+    return (elapsed < sliceTicks) ? sliceTicks - elapsed : 0;
+}
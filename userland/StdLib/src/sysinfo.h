@@ -0,0 +1,21 @@
+#pragma once
+
+#include <kernel/syscalls/UKSyscallsCommon.h>
+
+/// Readers of the kernel shared data page (see KernelSharedData), mapped read-only in every process.
+/// They don't make any syscall, their cost is a few memory reads.
+
+/// Returns the number of clock ticks since boot
+unsigned int GetTickCount();
+
+/// Retrieves the monotonic time since boot
+void GetMonotonicTime(unsigned int * const seconds, unsigned int * const milliseconds);
+
+/// Returns the current process id
+unsigned int GetCurrentProcessId();
+
+/// Returns the current thread id
+unsigned int GetCurrentThreadId();
+
+/// Returns the number of ticks the current thread may still run before being preempted, 0 if its time slice is over
+unsigned int GetRemainingTimeSlice();
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <types.h>
+#include <stdlib.h>
+#include <logger.h>
+
+#define IPC_BENCH_SERVER_NAME "IpcBenchServer"
+#define IPC_BENCH_CLIENT_NAME "IpcBenchClient"
+
+/// @brief Message sizes go from IPC_BENCH_MIN_MESSAGE_SIZE to IPC_BENCH_MAX_MESSAGE_SIZE, doubled each time
+#define IPC_BENCH_MIN_MESSAGE_SIZE 64
+#define IPC_BENCH_MAX_MESSAGE_SIZE 0x100000
+
+/// @brief Number of bytes sent for each message size.
+///        Messages are queued in the kernel until the server reads them, it bounds the kernel memory used by the benchmark.
+#define IPC_BENCH_BYTES_PER_SIZE 0x100000
+#define IPC_BENCH_MIN_MESSAGES   2
+#define IPC_BENCH_MAX_MESSAGES   1024
+
+/// @brief Size of the data ring of the channel mode
+#define IPC_BENCH_CHANNEL_SIZE 0x10000
+
+/// @brief Number of round trips measured by the latency modes
+#define IPC_BENCH_ROUND_TRIPS 1000
+
+/// @brief Number of IpcBenchScale.sys instances loaded by grub.cfg. Each one registers a server named IPC_BENCH_SCALE_NAME
+///        followed by its index, the client tells them through it when to send messages to the bench server.
+#define IPC_BENCH_SCALE_NAME    "IpcBenchScale"
+#define IPC_BENCH_SCALE_CLIENTS 4
+
+#if IPC_BENCH_SCALE_CLIENTS > 10
+#error The scaling clients index must be a single digit
+#endif
+
+/// @brief The way messages are sent to the server
+enum IpcBenchMode
+{
+    /// @brief Messages are copied through the kernel ipc buffer (IpcClient::Send)
+    IPC_BENCH_MODE_COPY = 0,
+    /// @brief Same as IPC_BENCH_MODE_COPY, but the sends are batched in the io ring, one syscall per IO_RING_ENTRIES messages (IoRing::Enter)
+    IPC_BENCH_MODE_COPY_BATCHED,
+    /// @brief Message pages are moved to the server (IpcClient::SendPages)
+    IPC_BENCH_MODE_PAGES_MOVE,
+    /// @brief Message pages are shared copy-on-write with the server (IpcClient::SendPages)
+    IPC_BENCH_MODE_PAGES_SHARE,
+    /// @brief Messages are written in a ring shared with the server (IpcChannel::Write)
+    IPC_BENCH_MODE_CHANNEL,
+    /// @brief Same as IPC_BENCH_MODE_COPY, but the messages are sent concurrently by several IpcBenchScale.sys processes
+    IPC_BENCH_MODE_COPY_SCALING,
+    /// @brief Round trips made of a message sent to the server and a reply sent to the client ipc server (IpcClient::Send)
+    IPC_BENCH_MODE_LATENCY_SEND_REPLY,
+    /// @brief Round trips made with synchronous calls (IpcClient::Call and IpcServer::ReplyWait).
+    ///        The server only handles calls once it received this mode, it must be the last one.
+    IPC_BENCH_MODE_LATENCY_CALL
+};
+
+/// @brief Sent by the client before each batch of messages
+struct IpcBenchRequest
+{
+    unsigned int mode;
+    unsigned int size;
+    unsigned int nbMessages;
+};
+
+/// @brief Sent by the server once a batch of messages has been received
+struct IpcBenchAck
+{
+    unsigned int bytesReceived;
+};
+
+/// @brief Builds the server name of the scaling client with the given index
+/// @param[out] name Buffer of at least sizeof(IPC_BENCH_SCALE_NAME) + 1 bytes
+static inline void GetScaleServerName(const unsigned int index, char * const name)
+{
+    const unsigned int length = sizeof(IPC_BENCH_SCALE_NAME) - 1;
+
+    StrCpy(IPC_BENCH_SCALE_NAME, name);
+    name[length] = (char)('0' + index);
+    name[length + 1] = '\0';
+}
+
+/// @brief Reads the processor time stamp counter
+static inline u64 ReadTsc()
+{
+    u32 low = 0;
+    u32 high = 0;
+
+    asm volatile("rdtsc" : "=a"(low), "=d"(high));
+
+    return ((u64)high << 32) | low;
+}
+
+/// @brief Divides a 64 bits value by a 32 bits one, there is no runtime library providing 64 bits divisions
+/// @return The quotient, saturated to 0xFFFFFFFF
+static inline u32 Div64(u64 dividend, const u32 divisor)
+{
+    u64 quotient = 0;
+    u64 remainder = 0;
+
+    if (divisor == 0)
+        return 0xFFFFFFFF;
+
+    for (int bit = 63; bit >= 0; bit--)
+    {
+        remainder = (remainder << 1) | ((dividend >> bit) & 1);
+        if (remainder >= divisor)
+        {
+            remainder -= divisor;
+            quotient |= ((u64)1 << bit);
+        }
+    }
+
+    return (quotient > 0xFFFFFFFF) ? 0xFFFFFFFF : (u32)quotient;
+}
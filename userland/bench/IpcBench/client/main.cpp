@@ -0,0 +1,650 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <Ipc.hpp>
+#include <IoRing.hpp>
+#include <syscalls.h>
+#include <sysinfo.h>
+
+#include "../Common.h"
+#define LOG(LOG_LEVEL, format, ...) LOGGER("IPCBENCH", LOG_LEVEL, format, ##__VA_ARGS__)
+
+/// @brief Messages are sent from this buffer, it is page aligned so that it can be sent with IpcClient::SendPages()
+static char MessageBuffer[IPC_BENCH_MAX_MESSAGE_SIZE] __attribute__((aligned(IPC_MESSAGE_PAGE_SIZE)));
+
+/// @brief Cycles of every round trip of a latency mode, sorted to get the percentiles
+static u32 LatencySamples[IPC_BENCH_ROUND_TRIPS];
+
+/// @brief Syscalls counters, there are less syscalls than entries
+static SyscallStatsEntry SyscallStats[32];
+
+static const char * SyscallEntryNames[] = { "int", "sysenter" };
+
+static const char * ModeNames[] = { "copy", "copy_batched", "pages_move", "pages_share", "channel", "copy_scaling", "send_reply", "call" };
+
+static Status ConnectToBenchServer(IpcClient * const client, const char * const serverName, IpcHandle * const serverHandle);
+static unsigned int GetMessagesCount(const unsigned int size);
+static Status RunSyscallLatency(IoRing * const ring);
+static Status RunThroughput(IpcServer * const ackServer, IpcClient * const client, const IpcHandle serverHandle, IpcChannel * const channel, IoRing * const ring, const IpcBenchMode mode, const unsigned int size);
+static Status SendMessage(IpcClient * const client, const IpcHandle serverHandle, IpcChannel * const channel, const IpcBenchMode mode, const unsigned int size);
+static Status SendBatchedMessages(IoRing * const ring, const IpcHandle serverHandle, const unsigned int size, const unsigned int nbMessages);
+static Status RunScaling(IpcServer * const ackServer, IpcClient * const client, const IpcHandle serverHandle, const IpcHandle * const scaleHandles, const unsigned int nbClients, const unsigned int size);
+static Status RunLatency(IpcServer * const ackServer, IpcClient * const client, const IpcHandle serverHandle, const IpcBenchMode mode);
+static void SortSamples(u32 * const samples, const unsigned int nbSamples);
+static u32 GetPercentile(const u32 * const sortedSamples, const unsigned int nbSamples, const unsigned int percent);
+static Status ReceiveMessage(IpcServer * const ackServer, char * const buffer, const unsigned int size);
+static Status PrintSyscallStats();
+
+void main()
+{
+    Status status = STATUS_FAILURE;
+    IpcServer ackServer;
+    IpcClient client;
+    IpcChannel channel;
+    IoRing ring;
+    IpcHandle serverHandle = INVALID_HANDLE_VALUE;
+    IpcHandle scaleHandles[IPC_BENCH_SCALE_CLIENTS];
+
+    LOG(LOG_INFO, "Starting IpcBench client (pid %d, tid %d)", GetCurrentProcessId(), GetCurrentThreadId());
+
+    InitMalloc();
+
+    // The server connects to this one to send acks once a batch of messages has been received
+    status = IpcServer::Create(IPC_BENCH_CLIENT_NAME, &ackServer);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "IpcServer::Create() failed with code %t", status);
+        goto clean;
+    }
+
+    status = ConnectToBenchServer(&client, IPC_BENCH_SERVER_NAME, &serverHandle);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "ConnectToBenchServer() failed with code %t", status);
+        goto clean;
+    }
+
+    for (unsigned int index = 0; index < IPC_BENCH_SCALE_CLIENTS; index++)
+    {
+        char scaleName[sizeof(IPC_BENCH_SCALE_NAME) + 1];
+
+        GetScaleServerName(index, scaleName);
+
+        status = ConnectToBenchServer(&client, scaleName, &scaleHandles[index]);
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "ConnectToBenchServer() failed with code %t (%s)", status, scaleName);
+            goto clean;
+        }
+    }
+
+    // The server accepts it when the channel mode starts
+    status = IpcChannel::Create(serverHandle, IPC_BENCH_CHANNEL_SIZE, &channel);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "IpcChannel::Create() failed with code %t", status);
+        goto clean;
+    }
+
+    status = IoRing::Create(&ring);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "IoRing::Create() failed with code %t", status);
+        goto clean;
+    }
+
+    status = RunSyscallLatency(&ring);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "RunSyscallLatency() failed with code %t", status);
+        goto clean;
+    }
+
+    for (unsigned int mode = IPC_BENCH_MODE_COPY; mode <= IPC_BENCH_MODE_CHANNEL; mode++)
+    {
+        for (unsigned int size = IPC_BENCH_MIN_MESSAGE_SIZE; size <= IPC_BENCH_MAX_MESSAGE_SIZE; size *= 2)
+        {
+            // A copied message can't be bigger than the kernel ring buffer allows
+            if ((mode == IPC_BENCH_MODE_COPY || mode == IPC_BENCH_MODE_COPY_BATCHED) && size > IPC_MAX_MESSAGE_SIZE)
+                continue;
+
+            status = RunThroughput(&ackServer, &client, serverHandle, &channel, &ring, (IpcBenchMode)mode, size);
+            if (FAILED(status))
+            {
+                LOG(LOG_ERROR, "RunThroughput() failed with code %t (mode %s, size %d)", status, ModeNames[mode], size);
+                goto clean;
+            }
+        }
+    }
+
+    for (unsigned int nbClients = 1; nbClients <= IPC_BENCH_SCALE_CLIENTS; nbClients *= 2)
+    {
+        for (unsigned int size = IPC_BENCH_MIN_MESSAGE_SIZE; size <= IPC_MAX_MESSAGE_SIZE; size *= 2)
+        {
+            status = RunScaling(&ackServer, &client, serverHandle, scaleHandles, nbClients, size);
+            if (FAILED(status))
+            {
+                LOG(LOG_ERROR, "RunScaling() failed with code %t (clients %d, size %d)", status, nbClients, size);
+                goto clean;
+            }
+        }
+    }
+
+    // The call mode must be the last one, the server only handles calls afterwards
+    for (unsigned int mode = IPC_BENCH_MODE_LATENCY_SEND_REPLY; mode <= IPC_BENCH_MODE_LATENCY_CALL; mode++)
+    {
+        status = RunLatency(&ackServer, &client, serverHandle, (IpcBenchMode)mode);
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "RunLatency() failed with code %t (mode %s)", status, ModeNames[mode]);
+            goto clean;
+        }
+    }
+
+    status = PrintSyscallStats();
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "PrintSyscallStats() failed with code %t", status);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    LOG(LOG_INFO, "[IPCBENCH] done status=%t", status);
+
+    while (1);
+}
+
+/// @brief The server may not be created yet when the client starts, we keep trying until it is
+static Status ConnectToBenchServer(IpcClient * const client, const char * const serverName, IpcHandle * const serverHandle)
+{
+    Status status = STATUS_FAILURE;
+
+    do
+    {
+        status = client->ConnectToServer(serverName, serverHandle);
+    } while (FAILED(status));
+
+    return status;
+}
+
+/// @brief Number of messages sent for a message size, so that about IPC_BENCH_BYTES_PER_SIZE bytes are sent
+static unsigned int GetMessagesCount(const unsigned int size)
+{
+    unsigned int nbMessages = IPC_BENCH_BYTES_PER_SIZE / size;
+
+    if (nbMessages < IPC_BENCH_MIN_MESSAGES)
+        nbMessages = IPC_BENCH_MIN_MESSAGES;
+    else if (nbMessages > IPC_BENCH_MAX_MESSAGES)
+        nbMessages = IPC_BENCH_MAX_MESSAGES;
+
+    return nbMessages;
+}
+
+/// @brief Measures round trips to the kernel through the syscall interrupt, then through sysenter.
+///        An io ring enter with nothing to execute is used, it returns as soon as it is in the kernel.
+///        The cost of reading the time from the kernel shared data page is printed as a reference.
+static Status RunSyscallLatency(IoRing * const ring)
+{
+    Status status = STATUS_FAILURE;
+    u64 sharedDataStart = 0;
+    u32 sharedDataCycles = 0;
+    unsigned int seconds = 0;
+    unsigned int milliseconds = 0;
+
+    for (int fastEntry = 0; fastEntry <= 1; fastEntry++)
+    {
+        u64 totalCycles = 0;
+
+        if (_sysSelectEntry(fastEntry) != fastEntry)
+        {
+            LOG(LOG_INFO, "[IPCBENCH] syscall entry=%s unsupported", SyscallEntryNames[fastEntry]);
+            continue;
+        }
+
+        for (unsigned int index = 0; index < IPC_BENCH_ROUND_TRIPS; index++)
+        {
+            unsigned int nbExecuted = 0;
+            u64 start = ReadTsc();
+            u32 cycles = 0;
+
+            status = ring->Enter(&nbExecuted);
+
+            cycles = (u32)(ReadTsc() - start);
+
+            if (FAILED(status))
+            {
+                LOG(LOG_ERROR, "IoRing::Enter() failed with code %t", status);
+                return status;
+            }
+
+            totalCycles += cycles;
+            LatencySamples[index] = cycles;
+        }
+
+        SortSamples(LatencySamples, IPC_BENCH_ROUND_TRIPS);
+
+        LOG(LOG_INFO, "[IPCBENCH] syscall entry=%s round_trips=%d min_cycles=%d avg_cycles=%d p50_cycles=%d p90_cycles=%d p99_cycles=%d max_cycles=%d",
+            SyscallEntryNames[fastEntry],
+            IPC_BENCH_ROUND_TRIPS,
+            LatencySamples[0],
+            Div64(totalCycles, IPC_BENCH_ROUND_TRIPS),
+            GetPercentile(LatencySamples, IPC_BENCH_ROUND_TRIPS, 50),
+            GetPercentile(LatencySamples, IPC_BENCH_ROUND_TRIPS, 90),
+            GetPercentile(LatencySamples, IPC_BENCH_ROUND_TRIPS, 99),
+            LatencySamples[IPC_BENCH_ROUND_TRIPS - 1]);
+    }
+
+    sharedDataStart = ReadTsc();
+
+    for (unsigned int index = 0; index < IPC_BENCH_ROUND_TRIPS; index++)
+        GetMonotonicTime(&seconds, &milliseconds);
+
+    sharedDataCycles = (u32)(ReadTsc() - sharedDataStart);
+
+    LOG(LOG_INFO, "[IPCBENCH] shared_data read=monotonic_time reads=%d avg_cycles=%d seconds=%d milliseconds=%d",
+        IPC_BENCH_ROUND_TRIPS,
+        sharedDataCycles / IPC_BENCH_ROUND_TRIPS,
+        seconds,
+        milliseconds);
+
+    // The rest of the benchmark uses the fastest entry
+    _sysSelectEntry(1);
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Sends a batch of messages of the given size to the server and prints the elapsed cycles
+///        between the first message and the server ack
+static Status RunThroughput(IpcServer * const ackServer, IpcClient * const client, const IpcHandle serverHandle, IpcChannel * const channel, IoRing * const ring, const IpcBenchMode mode, const unsigned int size)
+{
+    Status status = STATUS_FAILURE;
+    IpcBenchRequest request;
+    IpcBenchAck ack;
+    const unsigned int nbMessages = GetMessagesCount(size);
+    u64 start = 0;
+    u64 end = 0;
+    u32 kcycles = 0;
+
+    request.mode = mode;
+    request.size = size;
+    request.nbMessages = nbMessages;
+
+    status = client->Send(serverHandle, (char*)&request, sizeof(IpcBenchRequest));
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "IpcClient::Send() failed with code %t", status);
+        return status;
+    }
+
+    start = ReadTsc();
+
+    if (mode == IPC_BENCH_MODE_COPY_BATCHED)
+    {
+        status = SendBatchedMessages(ring, serverHandle, size, nbMessages);
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "SendBatchedMessages() failed with code %t", status);
+            return status;
+        }
+    }
+    else
+    {
+        for (unsigned int index = 0; index < nbMessages; index++)
+        {
+            status = SendMessage(client, serverHandle, channel, mode, size);
+            if (FAILED(status))
+            {
+                LOG(LOG_ERROR, "SendMessage() failed with code %t", status);
+                return status;
+            }
+        }
+    }
+
+    status = ReceiveMessage(ackServer, (char*)&ack, sizeof(IpcBenchAck));
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "ReceiveMessage() failed with code %t", status);
+        return status;
+    }
+
+    end = ReadTsc();
+
+    if (ack.bytesReceived != size * nbMessages)
+    {
+        LOG(LOG_ERROR, "The server received %d bytes instead of %d", ack.bytesReceived, size * nbMessages);
+        return STATUS_UNEXPECTED;
+    }
+
+    kcycles = Div64(end - start, 1000);
+
+    LOG(LOG_INFO, "[IPCBENCH] throughput mode=%s size=%d msgs=%d kcycles=%d cycles_per_msg=%d bytes_per_kcycle=%d",
+        ModeNames[mode],
+        size,
+        nbMessages,
+        kcycles,
+        Div64(end - start, nbMessages),
+        (kcycles == 0) ? 0 : Div64((u64)size * nbMessages, kcycles));
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Writes one byte per page of the message, as a producer would do, and sends it
+static Status SendMessage(IpcClient * const client, const IpcHandle serverHandle, IpcChannel * const channel, const IpcBenchMode mode, const unsigned int size)
+{
+    for (unsigned int offset = 0; offset < size; offset += IPC_MESSAGE_PAGE_SIZE)
+        MessageBuffer[offset] = (char)offset;
+
+    if (mode == IPC_BENCH_MODE_COPY)
+        return client->Send(serverHandle, MessageBuffer, size);
+
+    if (mode == IPC_BENCH_MODE_CHANNEL)
+        return channel->Write(MessageBuffer, size);
+
+    return client->SendPages(serverHandle, MessageBuffer, size, (mode == IPC_BENCH_MODE_PAGES_SHARE));
+}
+
+/// @brief Queues the sends in the io ring and executes them IO_RING_ENTRIES at a time, with a single syscall per batch
+static Status SendBatchedMessages(IoRing * const ring, const IpcHandle serverHandle, const unsigned int size, const unsigned int nbMessages)
+{
+    Status status = STATUS_FAILURE;
+    unsigned int nbSent = 0;
+
+    for (unsigned int offset = 0; offset < size; offset += IPC_MESSAGE_PAGE_SIZE)
+        MessageBuffer[offset] = (char)offset;
+
+    while (nbSent < nbMessages)
+    {
+        unsigned int nbBatched = 0;
+        unsigned int nbExecuted = 0;
+        IoRingCompletion completion;
+
+        while (nbBatched < IO_RING_ENTRIES && nbSent + nbBatched < nbMessages)
+        {
+            // The message is copied when the send is executed, every submission can use the same buffer
+            status = ring->Submit(IO_RING_OP_IPC_SEND, serverHandle, MessageBuffer, size, 0, nbSent + nbBatched);
+            if (FAILED(status))
+            {
+                LOG(LOG_ERROR, "IoRing::Submit() failed with code %t", status);
+                return status;
+            }
+
+            nbBatched++;
+        }
+
+        status = ring->Enter(&nbExecuted);
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "IoRing::Enter() failed with code %t", status);
+            return status;
+        }
+
+        // The completion queue is drained after each batch, so there is always room for a whole batch
+        if (nbExecuted != nbBatched)
+        {
+            LOG(LOG_ERROR, "%d sends executed instead of %d", nbExecuted, nbBatched);
+            return STATUS_UNEXPECTED;
+        }
+
+        while (ring->GetCompletion(&completion))
+        {
+            if (completion.status != STATUS_SUCCESS)
+            {
+                LOG(LOG_ERROR, "Send %d failed with kernel code %d", completion.userData, completion.status);
+                return STATUS_FAILURE;
+            }
+        }
+
+        nbSent += nbBatched;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Makes nbClients scaling clients send their share of a batch of copied messages to the server at the same time,
+///        and prints the elapsed cycles between the start of the clients and the server ack
+static Status RunScaling(IpcServer * const ackServer, IpcClient * const client, const IpcHandle serverHandle, const IpcHandle * const scaleHandles, const unsigned int nbClients, const unsigned int size)
+{
+    Status status = STATUS_FAILURE;
+    IpcBenchRequest request;
+    IpcBenchRequest clientRequest;
+    IpcBenchAck ack;
+    unsigned int nbMessages = GetMessagesCount(size) / nbClients;
+    u64 start = 0;
+    u64 end = 0;
+    u32 kcycles = 0;
+
+    if (nbMessages < IPC_BENCH_MIN_MESSAGES)
+        nbMessages = IPC_BENCH_MIN_MESSAGES;
+
+    request.mode = IPC_BENCH_MODE_COPY_SCALING;
+    request.size = size;
+    request.nbMessages = nbMessages * nbClients;
+
+    status = client->Send(serverHandle, (char*)&request, sizeof(IpcBenchRequest));
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "IpcClient::Send() failed with code %t", status);
+        return status;
+    }
+
+    // The server acks the request before the clients are started, their messages can't be taken for it
+    status = ReceiveMessage(ackServer, (char*)&ack, sizeof(IpcBenchAck));
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "ReceiveMessage() failed with code %t", status);
+        return status;
+    }
+
+    clientRequest.mode = IPC_BENCH_MODE_COPY;
+    clientRequest.size = size;
+    clientRequest.nbMessages = nbMessages;
+
+    start = ReadTsc();
+
+    for (unsigned int index = 0; index < nbClients; index++)
+    {
+        status = client->Send(scaleHandles[index], (char*)&clientRequest, sizeof(IpcBenchRequest));
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "IpcClient::Send() failed with code %t (scaling client %d)", status, index);
+            return status;
+        }
+    }
+
+    status = ReceiveMessage(ackServer, (char*)&ack, sizeof(IpcBenchAck));
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "ReceiveMessage() failed with code %t", status);
+        return status;
+    }
+
+    end = ReadTsc();
+
+    if (ack.bytesReceived != size * request.nbMessages)
+    {
+        LOG(LOG_ERROR, "The server received %d bytes instead of %d", ack.bytesReceived, size * request.nbMessages);
+        return STATUS_UNEXPECTED;
+    }
+
+    kcycles = Div64(end - start, 1000);
+
+    LOG(LOG_INFO, "[IPCBENCH] scaling mode=%s clients=%d size=%d msgs=%d kcycles=%d cycles_per_msg=%d bytes_per_kcycle=%d",
+        ModeNames[IPC_BENCH_MODE_COPY],
+        nbClients,
+        size,
+        request.nbMessages,
+        kcycles,
+        Div64(end - start, request.nbMessages),
+        (kcycles == 0) ? 0 : Div64((u64)size * request.nbMessages, kcycles));
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Measures round trips of a message passed in registers, either sent and replied through the copy
+///        ipc buffers of both processes, or with synchronous calls
+static Status RunLatency(IpcServer * const ackServer, IpcClient * const client, const IpcHandle serverHandle, const IpcBenchMode mode)
+{
+    Status status = STATUS_FAILURE;
+    IpcBenchRequest request;
+    IpcRegisterMessage message;
+    u64 totalCycles = 0;
+
+    request.mode = mode;
+    request.size = sizeof(IpcRegisterMessage);
+    request.nbMessages = IPC_BENCH_ROUND_TRIPS;
+
+    status = client->Send(serverHandle, (char*)&request, sizeof(IpcBenchRequest));
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "IpcClient::Send() failed with code %t", status);
+        return status;
+    }
+
+    for (unsigned int index = 0; index < IPC_BENCH_ROUND_TRIPS; index++)
+    {
+        u64 start = 0;
+        u32 cycles = 0;
+
+        for (unsigned int word = 0; word < IPC_REGISTER_MESSAGE_WORDS; word++)
+            message.words[word] = index + word;
+
+        start = ReadTsc();
+
+        if (mode == IPC_BENCH_MODE_LATENCY_CALL)
+        {
+            status = client->Call(serverHandle, &message);
+        }
+        else
+        {
+            status = client->Send(serverHandle, (char*)&message, sizeof(IpcRegisterMessage));
+            if (!FAILED(status))
+                status = ReceiveMessage(ackServer, (char*)&message, sizeof(IpcRegisterMessage));
+        }
+
+        cycles = (u32)(ReadTsc() - start);
+
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "Round trip %d failed with code %t", index, status);
+            return status;
+        }
+
+        if (message.words[0] != index)
+        {
+            LOG(LOG_ERROR, "Round trip %d got the reply %d", index, message.words[0]);
+            return STATUS_UNEXPECTED;
+        }
+
+        totalCycles += cycles;
+        LatencySamples[index] = cycles;
+    }
+
+    SortSamples(LatencySamples, IPC_BENCH_ROUND_TRIPS);
+
+    LOG(LOG_INFO, "[IPCBENCH] latency mode=%s round_trips=%d min_cycles=%d avg_cycles=%d p50_cycles=%d p90_cycles=%d p99_cycles=%d max_cycles=%d",
+        ModeNames[mode],
+        IPC_BENCH_ROUND_TRIPS,
+        LatencySamples[0],
+        Div64(totalCycles, IPC_BENCH_ROUND_TRIPS),
+        GetPercentile(LatencySamples, IPC_BENCH_ROUND_TRIPS, 50),
+        GetPercentile(LatencySamples, IPC_BENCH_ROUND_TRIPS, 90),
+        GetPercentile(LatencySamples, IPC_BENCH_ROUND_TRIPS, 99),
+        LatencySamples[IPC_BENCH_ROUND_TRIPS - 1]);
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Insertion sort, the samples are only sorted once the round trips are measured
+static void SortSamples(u32 * const samples, const unsigned int nbSamples)
+{
+    for (unsigned int index = 1; index < nbSamples; index++)
+    {
+        const u32 sample = samples[index];
+        unsigned int position = index;
+
+        while (position > 0 && samples[position - 1] > sample)
+        {
+            samples[position] = samples[position - 1];
+            position--;
+        }
+
+        samples[position] = sample;
+    }
+}
+
+/// @brief Nearest-rank percentile of sorted samples
+static u32 GetPercentile(const u32 * const sortedSamples, const unsigned int nbSamples, const unsigned int percent)
+{
+    unsigned int rank = (nbSamples * percent + 99) / 100;
+
+    if (rank == 0)
+        rank = 1;
+
+    return sortedSamples[rank - 1];
+}
+
+/// @brief Receives one message from the copy ipc buffer and checks it has the expected size
+static Status ReceiveMessage(IpcServer * const ackServer, char * const buffer, const unsigned int size)
+{
+    Status status = STATUS_FAILURE;
+    unsigned int bytesRead = 0;
+
+    status = ackServer->Receive(buffer, size, &bytesRead);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "IpcServer::Receive() failed with code %t", status);
+        return status;
+    }
+
+    if (bytesRead != size)
+    {
+        LOG(LOG_ERROR, "Received a message of %d bytes instead of %d", bytesRead, size);
+        return STATUS_UNEXPECTED;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Prints the kernel counters of every syscall made since boot, by all the processes.
+///        The median is given by its histogram bucket, as the bound it is below.
+static Status PrintSyscallStats()
+{
+    Status status = STATUS_FAILURE;
+    SysSyscallStatsParameter parameters;
+    unsigned int nbEntries = 0;
+
+    parameters.operation = SYSCALL_STATS_GET;
+    parameters.buffer = SyscallStats;
+    parameters.size = sizeof(SyscallStats) / sizeof(SyscallStatsEntry);
+    parameters.countPtr = &nbEntries;
+
+    status = (Status)_sysSyscallStats(&parameters);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "_sysSyscallStats() failed with code %t", status);
+        return status;
+    }
+
+    for (unsigned int id = 0; id < nbEntries; id++)
+    {
+        const SyscallStatsEntry * entry = &SyscallStats[id];
+        unsigned int bucket = 0;
+        unsigned int nbCalls = entry->histogram[0];
+
+        if (entry->count == 0)
+            continue;
+
+        while (nbCalls * 2 < entry->count && bucket < SYSCALL_STATS_HISTOGRAM_BUCKETS - 1)
+            nbCalls += entry->histogram[++bucket];
+
+        LOG(LOG_INFO, "[IPCBENCH] syscall id=%d count=%d avg_cycles=%d max_cycles=%d p50_cycles_below=%d",
+            id,
+            entry->count,
+            Div64(entry->totalCycles, entry->count),
+            entry->maxCycles,
+            1 << (bucket + SYSCALL_STATS_HISTOGRAM_SHIFT + 1));
+    }
+
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <Ipc.hpp>
+
+#include "../Common.h"
+#define LOG(LOG_LEVEL, format, ...) LOGGER("IPCBENCH_SCALE", LOG_LEVEL, format, ##__VA_ARGS__)
+
+/// @brief Messages are sent from this buffer, it can hold the biggest copied message
+static char MessageBuffer[IPC_MAX_MESSAGE_SIZE];
+
+static Status CreateScaleServer(IpcServer * const scaleServer, unsigned int * const index);
+static Status SendMessages(IpcClient * const client, const IpcHandle serverHandle, const IpcBenchRequest * const request);
+
+void main()
+{
+    Status status = STATUS_FAILURE;
+    IpcServer scaleServer;
+    IpcClient client;
+    IpcHandle serverHandle = INVALID_HANDLE_VALUE;
+    unsigned int index = 0;
+
+    InitMalloc();
+
+    status = CreateScaleServer(&scaleServer, &index);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "CreateScaleServer() failed with code %t", status);
+        goto clean;
+    }
+
+    LOG(LOG_INFO, "Starting IpcBench scaling client %d", index);
+
+    // The server may not be created yet when we start, we keep trying until it is
+    do
+    {
+        status = client.ConnectToServer(IPC_BENCH_SERVER_NAME, &serverHandle);
+    } while (FAILED(status));
+
+    while (1)
+    {
+        IpcBenchRequest request;
+        unsigned int bytesRead = 0;
+
+        status = scaleServer.Receive((char*)&request, sizeof(IpcBenchRequest), &bytesRead);
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "IpcServer::Receive() failed with code %t", status);
+            goto clean;
+        }
+
+        if (bytesRead != sizeof(IpcBenchRequest) || request.size > IPC_MAX_MESSAGE_SIZE)
+        {
+            LOG(LOG_ERROR, "Invalid request (%d bytes, size %d)", bytesRead, request.size);
+            status = STATUS_UNEXPECTED;
+            goto clean;
+        }
+
+        status = SendMessages(&client, serverHandle, &request);
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "SendMessages() failed with code %t", status);
+            goto clean;
+        }
+    }
+
+clean:
+    LOG(LOG_INFO, "Terminating IpcBench scaling client %d (%t)", index, status);
+
+    while (1);
+}
+
+/// @brief Every instance runs the same binary, the index of the first free server name is used as our index
+static Status CreateScaleServer(IpcServer * const scaleServer, unsigned int * const index)
+{
+    char name[sizeof(IPC_BENCH_SCALE_NAME) + 1];
+
+    for (unsigned int current = 0; current < IPC_BENCH_SCALE_CLIENTS; current++)
+    {
+        GetScaleServerName(current, name);
+
+        if (!FAILED(IpcServer::Create(name, scaleServer)))
+        {
+            *index = current;
+            return STATUS_SUCCESS;
+        }
+    }
+
+    LOG(LOG_ERROR, "More than %d scaling clients are loaded", IPC_BENCH_SCALE_CLIENTS);
+
+    return STATUS_UNEXPECTED;
+}
+
+/// @brief Sends the messages asked by the client to the bench server, the server acks the whole batch to the client
+static Status SendMessages(IpcClient * const client, const IpcHandle serverHandle, const IpcBenchRequest * const request)
+{
+    Status status = STATUS_FAILURE;
+
+    for (unsigned int offset = 0; offset < request->size; offset += IPC_MESSAGE_PAGE_SIZE)
+        MessageBuffer[offset] = (char)offset;
+
+    for (unsigned int index = 0; index < request->nbMessages; index++)
+    {
+        status = client->Send(serverHandle, MessageBuffer, request->size);
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "IpcClient::Send() failed with code %t", status);
+            return status;
+        }
+    }
+
+    return STATUS_SUCCESS;
+}
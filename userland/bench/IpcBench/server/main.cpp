@@ -0,0 +1,291 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <Ipc.hpp>
+
+#include "../Common.h"
+#define LOG(LOG_LEVEL, format, ...) LOGGER("IPCBENCH_SRV", LOG_LEVEL, format, ##__VA_ARGS__)
+
+/// @brief Copied messages are read in this buffer, it can hold the biggest one
+static char ReceiveBuffer[IPC_MAX_MESSAGE_SIZE];
+
+static Status ReceiveMessage(IpcServer * const server, char * const buffer, const unsigned int size);
+static Status ReceiveCopiedMessages(IpcServer * const server, const IpcBenchRequest * const request, unsigned int * const bytesReceived);
+static Status ReceivePagesMessages(IpcServer * const server, const IpcBenchRequest * const request, unsigned int * const bytesReceived);
+static Status ReceiveChannelMessages(IpcChannel * const channel, const IpcBenchRequest * const request, unsigned int * const bytesReceived);
+static Status ReplyToMessages(IpcServer * const server, IpcClient * const client, const IpcHandle clientHandle, const IpcBenchRequest * const request);
+static Status ReplyToCalls(IpcServer * const server);
+
+void main()
+{
+    Status status = STATUS_FAILURE;
+    IpcServer server;
+    IpcClient client;
+    IpcChannel channel;
+    bool channelAccepted = false;
+    IpcHandle clientHandle = INVALID_HANDLE_VALUE;
+
+    LOG(LOG_INFO, "Starting IpcBench server");
+
+    InitMalloc();
+
+    status = IpcServer::Create(IPC_BENCH_SERVER_NAME, &server);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "IpcServer::Create() failed with code %t", status);
+        goto clean;
+    }
+
+    while (1)
+    {
+        IpcBenchRequest request;
+        IpcBenchAck ack;
+
+        status = ReceiveMessage(&server, (char*)&request, sizeof(IpcBenchRequest));
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "ReceiveMessage() failed with code %t", status);
+            goto clean;
+        }
+
+        // The client creates its own server to receive acks before sending its first request
+        if (clientHandle == INVALID_HANDLE_VALUE)
+        {
+            status = client.ConnectToServer(IPC_BENCH_CLIENT_NAME, &clientHandle);
+            if (FAILED(status))
+            {
+                LOG(LOG_ERROR, "IpcClient::ConnectToServer() failed with code %t", status);
+                goto clean;
+            }
+        }
+
+        if (request.mode == IPC_BENCH_MODE_LATENCY_CALL)
+        {
+            status = ReplyToCalls(&server);
+            goto clean;
+        }
+
+        if (request.mode == IPC_BENCH_MODE_LATENCY_SEND_REPLY)
+        {
+            status = ReplyToMessages(&server, &client, clientHandle, &request);
+            if (FAILED(status))
+            {
+                LOG(LOG_ERROR, "ReplyToMessages() failed with code %t", status);
+                goto clean;
+            }
+
+            continue;
+        }
+
+        // The client created the channel at startup, it is only accepted when it is first used
+        if (request.mode == IPC_BENCH_MODE_CHANNEL && !channelAccepted)
+        {
+            status = server.AcceptChannel(&channel);
+            if (FAILED(status))
+            {
+                LOG(LOG_ERROR, "IpcServer::AcceptChannel() failed with code %t", status);
+                goto clean;
+            }
+
+            channelAccepted = true;
+        }
+
+        ack.bytesReceived = 0;
+
+        // The scaling clients are only started once we are ready, so that their messages can't be taken for a request
+        if (request.mode == IPC_BENCH_MODE_COPY_SCALING)
+        {
+            status = client.Send(clientHandle, (char*)&ack, sizeof(IpcBenchAck));
+            if (FAILED(status))
+            {
+                LOG(LOG_ERROR, "IpcClient::Send() failed with code %t", status);
+                goto clean;
+            }
+        }
+
+        if (request.mode == IPC_BENCH_MODE_COPY || request.mode == IPC_BENCH_MODE_COPY_BATCHED || request.mode == IPC_BENCH_MODE_COPY_SCALING)
+            status = ReceiveCopiedMessages(&server, &request, &ack.bytesReceived);
+        else if (request.mode == IPC_BENCH_MODE_CHANNEL)
+            status = ReceiveChannelMessages(&channel, &request, &ack.bytesReceived);
+        else
+            status = ReceivePagesMessages(&server, &request, &ack.bytesReceived);
+
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "Failed to receive messages, mode %d, size %d (%t)", request.mode, request.size, status);
+            goto clean;
+        }
+
+        status = client.Send(clientHandle, (char*)&ack, sizeof(IpcBenchAck));
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "IpcClient::Send() failed with code %t", status);
+            goto clean;
+        }
+    }
+
+clean:
+    LOG(LOG_INFO, "Terminating IpcBench server (%t)", status);
+
+    while (1);
+}
+
+/// @brief Receives one message from the copy ipc buffer and checks it has the expected size
+static Status ReceiveMessage(IpcServer * const server, char * const buffer, const unsigned int size)
+{
+    Status status = STATUS_FAILURE;
+    unsigned int bytesRead = 0;
+
+    status = server->Receive(buffer, size, &bytesRead);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "IpcServer::Receive() failed with code %t", status);
+        return status;
+    }
+
+    if (bytesRead != size)
+    {
+        LOG(LOG_ERROR, "Received a message of %d bytes instead of %d", bytesRead, size);
+        return STATUS_UNEXPECTED;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Receives every message sent with IpcClient::Send(), one at a time
+static Status ReceiveCopiedMessages(IpcServer * const server, const IpcBenchRequest * const request, unsigned int * const bytesReceived)
+{
+    Status status = STATUS_FAILURE;
+    unsigned int totalBytes = 0;
+
+    for (unsigned int index = 0; index < request->nbMessages; index++)
+    {
+        unsigned int bytesRead = 0;
+
+        status = server->Receive(ReceiveBuffer, IPC_MAX_MESSAGE_SIZE, &bytesRead);
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "IpcServer::Receive() failed with code %t", status);
+            return status;
+        }
+
+        totalBytes += bytesRead;
+    }
+
+    *bytesReceived = totalBytes;
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Maps and releases every message sent with IpcClient::SendPages(), one byte per page is read
+///        so that the mapping cost is not hidden
+static Status ReceivePagesMessages(IpcServer * const server, const IpcBenchRequest * const request, unsigned int * const bytesReceived)
+{
+    Status status = STATUS_FAILURE;
+    unsigned int totalBytes = 0;
+    volatile char dummy = 0;
+
+    for (unsigned int index = 0; index < request->nbMessages; index++)
+    {
+        IpcMessage message;
+
+        status = server->ReceivePages(&message);
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "IpcServer::ReceivePages() failed with code %t", status);
+            return status;
+        }
+
+        for (unsigned int offset = 0; offset < message.size; offset += IPC_MESSAGE_PAGE_SIZE)
+            dummy = ((char*)message.data)[offset];
+
+        totalBytes += message.size;
+
+        status = message.Release();
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "IpcMessage::Release() failed with code %t", status);
+            return status;
+        }
+    }
+
+    (void)dummy;
+
+    *bytesReceived = totalBytes;
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Reads the bytes of every message written in the channel, the ring keeps no message boundaries
+static Status ReceiveChannelMessages(IpcChannel * const channel, const IpcBenchRequest * const request, unsigned int * const bytesReceived)
+{
+    Status status = STATUS_FAILURE;
+    const unsigned int totalSize = request->size * request->nbMessages;
+    unsigned int totalBytes = 0;
+
+    while (totalBytes < totalSize)
+    {
+        unsigned int bytesRead = 0;
+        unsigned int remainingBytes = totalSize - totalBytes;
+
+        status = channel->Read(ReceiveBuffer, (remainingBytes < IPC_MAX_MESSAGE_SIZE) ? remainingBytes : IPC_MAX_MESSAGE_SIZE, &bytesRead);
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "IpcChannel::Read() failed with code %t", status);
+            return status;
+        }
+
+        totalBytes += bytesRead;
+    }
+
+    *bytesReceived = totalBytes;
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Sends back every message to the client ipc server, the way LtFsService replies to its clients
+static Status ReplyToMessages(IpcServer * const server, IpcClient * const client, const IpcHandle clientHandle, const IpcBenchRequest * const request)
+{
+    Status status = STATUS_FAILURE;
+    IpcRegisterMessage message;
+
+    for (unsigned int index = 0; index < request->nbMessages; index++)
+    {
+        status = ReceiveMessage(server, (char*)&message, sizeof(IpcRegisterMessage));
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "ReceiveMessage() failed with code %t", status);
+            return status;
+        }
+
+        status = client->Send(clientHandle, (char*)&message, sizeof(IpcRegisterMessage));
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "IpcClient::Send() failed with code %t", status);
+            return status;
+        }
+    }
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Replies to every call with the message it holds, it never returns on success
+static Status ReplyToCalls(IpcServer * const server)
+{
+    Status status = STATUS_FAILURE;
+    IpcRegisterMessage message;
+
+    // The message is ignored by the first call, there is nothing to reply to yet
+    MemSet(&message, 0, sizeof(IpcRegisterMessage));
+
+    while (1)
+    {
+        status = server->ReplyWait(&message);
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "IpcServer::ReplyWait() failed with code %t", status);
+            return status;
+        }
+    }
+
+    return status;
+}
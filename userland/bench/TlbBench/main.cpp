@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <logger.h>
+
+#define LOG(LOG_LEVEL, format, ...) LOGGER("TLBBENCH", LOG_LEVEL, format, ##__VA_ARGS__)
+
+/// @brief Size of each buffer, 4096 pages of 4Ko is far beyond the TLB reach, while 4 pages of 4Mo fit in it
+#define TLB_BENCH_SIZE (16 * 1024 * 1024)
+
+#define TLB_BENCH_PAGE_SIZE 4096
+#define TLB_BENCH_PAGES     (TLB_BENCH_SIZE / TLB_BENCH_PAGE_SIZE)
+
+/// @brief Pages visited between two accesses. It is odd, so that a pass visits every page once,
+///        in an order that the prefetchers can't follow
+#define TLB_BENCH_STRIDE 1031
+
+/// @brief Number of times each buffer is walked
+#define TLB_BENCH_PASSES 16
+
+/// @brief Buffer mapped with 4Ko pages : the .bss is demand paged
+static char SmallPagesBuffer[TLB_BENCH_SIZE] __attribute__((aligned(TLB_BENCH_PAGE_SIZE)));
+
+/// @brief Reads the processor time stamp counter
+static inline u64 ReadTsc()
+{
+    u32 low = 0;
+    u32 high = 0;
+
+    asm volatile("rdtsc" : "=a"(low), "=d"(high));
+
+    return ((u64)high << 32) | low;
+}
+
+/// @brief Divides a 64 bits value by a 32 bits one, there is no runtime library providing 64 bits divisions
+/// @return The quotient, saturated to 0xFFFFFFFF
+static inline u32 Div64(u64 dividend, const u32 divisor)
+{
+    u64 quotient = 0;
+    u64 remainder = 0;
+
+    if (divisor == 0)
+        return 0xFFFFFFFF;
+
+    for (int bit = 63; bit >= 0; bit--)
+    {
+        remainder = (remainder << 1) | ((dividend >> bit) & 1);
+        if (remainder >= divisor)
+        {
+            remainder -= divisor;
+            quotient |= ((u64)1 << bit);
+        }
+    }
+
+    return (quotient > 0xFFFFFFFF) ? 0xFFFFFFFF : (u32)quotient;
+}
+
+/// @brief Writes to each page of a buffer, so that every page is present before the buffer is walked
+static void TouchPages(volatile char * const buffer)
+{
+    for (unsigned int page = 0; page < TLB_BENCH_PAGES; page++)
+        buffer[page * TLB_BENCH_PAGE_SIZE] = (char)page;
+}
+
+/// @brief Reads one byte in each page of a buffer, TLB_BENCH_PASSES times.
+///        A different cache line is read in each page, the lines read stay in the cache : the cost measured is the address translation.
+/// @return The average number of cycles per access
+static u32 WalkPages(volatile char * const buffer)
+{
+    unsigned int page = 0;
+    unsigned int sum = 0;
+    u64 start = ReadTsc();
+
+    for (unsigned int access = 0; access < TLB_BENCH_PAGES * TLB_BENCH_PASSES; access++)
+    {
+        sum += buffer[page * TLB_BENCH_PAGE_SIZE + (page & 63) * 64];
+        page = (page + TLB_BENCH_STRIDE) & (TLB_BENCH_PAGES - 1);
+    }
+
+    u64 cycles = ReadTsc() - start;
+
+    // Keeps the reads from being optimized out
+    if (sum == 0xFFFFFFFF)
+        LOG(LOG_DEBUG, "sum=%d", sum);
+
+    return Div64(cycles, TLB_BENCH_PAGES * TLB_BENCH_PASSES);
+}
+
+/// @brief Walks a buffer mapped with 4Ko pages and one mapped with 4Mo pages, both with one access per 4Ko page.
+///        With 4Ko pages almost every access misses the TLB, with 4Mo pages the whole buffer is covered by 4 TLB entries.
+void main()
+{
+    Status status = STATUS_FAILURE;
+    char * largePagesBuffer = nullptr;
+    u64 start = 0;
+    u32 commitCycles = 0;
+
+    LOG(LOG_INFO, "Starting TlbBench");
+
+    InitMalloc();
+
+    start = ReadTsc();
+    TouchPages(SmallPagesBuffer);
+    commitCycles = Div64(ReadTsc() - start, TLB_BENCH_PAGES);
+
+    LOG(LOG_INFO, "[TLBBENCH] pages=4K size=%d commit_avg_cycles=%d access_avg_cycles=%d",
+        TLB_BENCH_SIZE, commitCycles, WalkPages(SmallPagesBuffer));
+
+    start = ReadTsc();
+
+    status = AllocateLargePages(TLB_BENCH_SIZE, (void**)&largePagesBuffer);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "AllocateLargePages() failed with code %t, the processor may not support large pages", status);
+        goto clean;
+    }
+
+    TouchPages(largePagesBuffer);
+    commitCycles = Div64(ReadTsc() - start, TLB_BENCH_PAGES);
+
+    LOG(LOG_INFO, "[TLBBENCH] pages=4M size=%d commit_avg_cycles=%d access_avg_cycles=%d",
+        TLB_BENCH_SIZE, commitCycles, WalkPages(largePagesBuffer));
+
+    status = ReleaseLargePages(largePagesBuffer);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "ReleaseLargePages() failed with code %t", status);
+        goto clean;
+    }
+
+    status = STATUS_SUCCESS;
+
+clean:
+    LOG(LOG_INFO, "[TLBBENCH] done status=%t", status);
+
+    while (1);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <types.h>
+#include <stdlib.h>
+#include <logger.h>
+
+#define VAD_BENCH_SERVER_NAME "VadBenchServer"
+
+/// @brief Number of one page regions mapped in the server, each message received with IpcServer::ReceivePages() gets its own vad
+#define VAD_BENCH_REGIONS 4096
+
+/// @brief The mapping and fault costs are printed each time this number of regions has been added
+#define VAD_BENCH_STEP 512
+
+/// @brief Reads the processor time stamp counter
+static inline u64 ReadTsc()
+{
+    u32 low = 0;
+    u32 high = 0;
+
+    asm volatile("rdtsc" : "=a"(low), "=d"(high));
+
+    return ((u64)high << 32) | low;
+}
+
+/// @brief Divides a 64 bits value by a 32 bits one, there is no runtime library providing 64 bits divisions
+/// @return The quotient, saturated to 0xFFFFFFFF
+static inline u32 Div64(u64 dividend, const u32 divisor)
+{
+    u64 quotient = 0;
+    u64 remainder = 0;
+
+    if (divisor == 0)
+        return 0xFFFFFFFF;
+
+    for (int bit = 63; bit >= 0; bit--)
+    {
+        remainder = (remainder << 1) | ((dividend >> bit) & 1);
+        if (remainder >= divisor)
+        {
+            remainder -= divisor;
+            quotient |= ((u64)1 << bit);
+        }
+    }
+
+    return (quotient > 0xFFFFFFFF) ? 0xFFFFFFFF : (u32)quotient;
+}
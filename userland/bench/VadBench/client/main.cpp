@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <Ipc.hpp>
+
+#include "../Common.h"
+#define LOG(LOG_LEVEL, format, ...) LOGGER("VADBENCH_CLT", LOG_LEVEL, format, ##__VA_ARGS__)
+
+/// @brief The same page is shared with the server for every region, the server copy is made when it writes to it
+static char RegionPage[IPC_MESSAGE_PAGE_SIZE] __attribute__((aligned(IPC_MESSAGE_PAGE_SIZE)));
+
+void main()
+{
+    Status status = STATUS_FAILURE;
+    IpcClient client;
+    IpcHandle serverHandle = INVALID_HANDLE_VALUE;
+    unsigned int nbRegions = VAD_BENCH_REGIONS;
+
+    LOG(LOG_INFO, "Starting VadBench client");
+
+    InitMalloc();
+
+    RegionPage[0] = 1;
+
+    // The server may not be created yet when we start, we keep trying until it is
+    do
+    {
+        status = client.ConnectToServer(VAD_BENCH_SERVER_NAME, &serverHandle);
+    } while (FAILED(status));
+
+    // Every message is queued before the server is told to start, so that its measures don't include waiting for us
+    for (unsigned int index = 0; index < VAD_BENCH_REGIONS; index++)
+    {
+        status = client.SendPages(serverHandle, RegionPage, IPC_MESSAGE_PAGE_SIZE, true);
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "IpcClient::SendPages() failed with code %t (region %d)", status, index);
+            goto clean;
+        }
+    }
+
+    status = client.Send(serverHandle, (char*)&nbRegions, sizeof(nbRegions));
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "IpcClient::Send() failed with code %t", status);
+        goto clean;
+    }
+
+clean:
+    LOG(LOG_INFO, "Terminating VadBench client (%t)", status);
+
+    while (1);
+}
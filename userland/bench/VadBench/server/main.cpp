@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <Ipc.hpp>
+
+#include "../Common.h"
+#define LOG(LOG_LEVEL, format, ...) LOGGER("VADBENCH", LOG_LEVEL, format, ##__VA_ARGS__)
+
+/// @brief Regions received from the client, each one is described by its own vad
+static IpcMessage Regions[VAD_BENCH_REGIONS];
+
+static Status MapRegions(IpcServer * const server);
+static Status ReleaseRegions(const unsigned int first, const unsigned int pass);
+
+/// @brief Maps thousands of one page regions and faults them, then releases them.
+///        Each region is a vad of the server: the costs printed along the way show how the address lookups
+///        of the allocations and page faults grow with the number of vads.
+void main()
+{
+    Status status = STATUS_FAILURE;
+    IpcServer server;
+    unsigned int nbRegions = 0;
+    unsigned int bytesRead = 0;
+
+    LOG(LOG_INFO, "Starting VadBench server");
+
+    InitMalloc();
+
+    status = IpcServer::Create(VAD_BENCH_SERVER_NAME, &server);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "IpcServer::Create() failed with code %t", status);
+        goto clean;
+    }
+
+    // The client sends this message once every region is queued
+    status = server.Receive((char*)&nbRegions, sizeof(nbRegions), &bytesRead);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "IpcServer::Receive() failed with code %t", status);
+        goto clean;
+    }
+
+    if (bytesRead != sizeof(nbRegions) || nbRegions != VAD_BENCH_REGIONS)
+    {
+        LOG(LOG_ERROR, "Unexpected start message (%d bytes, %d regions)", bytesRead, nbRegions);
+        status = STATUS_UNEXPECTED;
+        goto clean;
+    }
+
+    status = MapRegions(&server);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "MapRegions() failed with code %t", status);
+        goto clean;
+    }
+
+    // Every other region is released first, the free vads left can't be merged with their reserved neighbors.
+    // The second pass merges each released region with both of its neighbors.
+    status = ReleaseRegions(1, 1);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "ReleaseRegions() failed with code %t (pass 1)", status);
+        goto clean;
+    }
+
+    status = ReleaseRegions(0, 2);
+    if (FAILED(status))
+    {
+        LOG(LOG_ERROR, "ReleaseRegions() failed with code %t (pass 2)", status);
+        goto clean;
+    }
+
+clean:
+    LOG(LOG_INFO, "[VADBENCH] done status=%t", status);
+
+    while (1);
+}
+
+/// @brief Receives the regions VAD_BENCH_STEP at a time, then writes to each one of them.
+///        The regions are shared copy-on-write with the client, so every first write is a page fault
+///        resolved after looking for the vad of the faulting address.
+static Status MapRegions(IpcServer * const server)
+{
+    Status status = STATUS_FAILURE;
+
+    for (unsigned int step = 0; step < VAD_BENCH_REGIONS; step += VAD_BENCH_STEP)
+    {
+        u64 mapCycles = 0;
+        u64 faultCycles = 0;
+        u64 start = 0;
+
+        for (unsigned int index = step; index < step + VAD_BENCH_STEP; index++)
+        {
+            start = ReadTsc();
+
+            status = server->ReceivePages(&Regions[index]);
+
+            mapCycles += ReadTsc() - start;
+
+            if (FAILED(status))
+            {
+                LOG(LOG_ERROR, "IpcServer::ReceivePages() failed with code %t (region %d)", status, index);
+                return status;
+            }
+        }
+
+        for (unsigned int index = step; index < step + VAD_BENCH_STEP; index++)
+        {
+            start = ReadTsc();
+
+            *(volatile char*)Regions[index].data = (char)index;
+
+            faultCycles += ReadTsc() - start;
+        }
+
+        LOG(LOG_INFO, "[VADBENCH] map regions=%d map_avg_cycles=%d fault_avg_cycles=%d",
+            step + VAD_BENCH_STEP,
+            Div64(mapCycles, VAD_BENCH_STEP),
+            Div64(faultCycles, VAD_BENCH_STEP));
+    }
+
+    return STATUS_SUCCESS;
+}
+
+/// @brief Releases one region out of two, starting from the first index
+static Status ReleaseRegions(const unsigned int first, const unsigned int pass)
+{
+    Status status = STATUS_FAILURE;
+    u64 releaseCycles = 0;
+    unsigned int nbReleased = 0;
+
+    for (unsigned int index = first; index < VAD_BENCH_REGIONS; index += 2)
+    {
+        u64 start = ReadTsc();
+
+        status = Regions[index].Release();
+
+        releaseCycles += ReadTsc() - start;
+
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "IpcMessage::Release() failed with code %t (region %d)", status, index);
+            return status;
+        }
+
+        nbReleased++;
+    }
+
+    LOG(LOG_INFO, "[VADBENCH] release pass=%d regions=%d release_avg_cycles=%d",
+        pass,
+        nbReleased,
+        Div64(releaseCycles, nbReleased));
+
+    return STATUS_SUCCESS;
+}
@@ -6,49 +6,37 @@
 
 #include <stdio.h>
 
-Status LtFsRequest::Create(const LtFsRequestType type, void * const parameters, const unsigned int size, LtFsRequest ** outRequest)
+Status LtFsRequest::Send(IpcClient * const client, const IpcServerHandle serverHandle, const LtFsRequestType type, const void * const parameters, const unsigned int size)
 {
-    Status status = STATUS_FAILURE;
-    LtFsRequest * request = nullptr;
-
-    if (type >= LTFS_REQUEST_MAX)
-    {
-        return STATUS_INVALID_PARAMETER;
-    }
+    IpcIoVector request[2];
 
-    if (parameters == nullptr)
+    if (client == nullptr)
     {
         return STATUS_NULL_PARAMETER;
     }
 
-    if (size == 0)
+    if (type >= LTFS_REQUEST_MAX)
     {
         return STATUS_INVALID_PARAMETER;
     }
 
-    if (outRequest == nullptr)
+    if (parameters == nullptr)
     {
         return STATUS_NULL_PARAMETER;
     }
 
-    request = (LtFsRequest*)HeapAlloc(sizeof(LtFsRequest) + size);
-    if (request == nullptr)
+    if (size == 0)
     {
-        status = STATUS_ALLOC_FAILED;
-        goto clean;
+        return STATUS_INVALID_PARAMETER;
     }
 
-    request->type = type;
-    
-    MemCopy(parameters, &(request->parameters), size);
-
-    *outRequest = request;
-    request = nullptr;
+    // Same layout as a LtFsRequest : the type, then the parameters in place of the parameters field
+    request[0].buffer = (const char*)&type;
+    request[0].size = sizeof(LtFsRequestType);
+    request[1].buffer = (const char*)parameters;
+    request[1].size = size;
 
-    status = STATUS_SUCCESS;
-
-clean:
-    return status;
+    return client->SendV(serverHandle, request, 2);
 }
 
 Status LtFsResponse::Create(const Status resStatus, void * const data, const unsigned int size, LtFsResponse ** outResponse)
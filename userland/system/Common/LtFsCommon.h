@@ -2,6 +2,7 @@
 
 #include <status.h>
 #include <types.h>
+#include <Ipc.hpp>
 
 #define SERVICE_TERMINATE_CMD "terminate"
 #define SERVICE_TEST_CMD "Hello world"
@@ -37,7 +38,9 @@ struct LtFsRequest
     LtFsRequestType type;
     void * parameters;
 
-    static Status Create(const LtFsRequestType type, void * const parameters, const unsigned int size, LtFsRequest ** outRequest);
+    /// Sends the request type followed by its parameters as a single message, without copying them in a contiguous buffer.
+    /// The service receives it as a LtFsRequest whose parameters start at &request->parameters.
+    static Status Send(IpcClient * const client, const IpcServerHandle serverHandle, const LtFsRequestType type, const void * const parameters, const unsigned int size);
 };
 
 struct LtFsResponse
@@ -28,7 +28,8 @@ struct FileEntry
 
 struct ServiceCommandContext
 {
-    List * processes;
+    /// Connected processes, indexed with IPC_CLIENT_INDEX() of their client handle
+    ProcessEntry * processes[IPC_CLIENT_INDEX_COUNT];
     List * fileEntries;
 };
 
@@ -46,7 +47,6 @@ Handle gCurrentFileHandle = INVALID_HANDLE_VALUE;
 
 void ServiceCommandInit()
 {
-    gSvcContext.processes = ListCreate();
     gSvcContext.fileEntries = ListCreate();
     gCurrentFileHandle = 0;
 }
@@ -124,7 +124,7 @@ static Status RequestConnect(const ProcessHandle processHandle, LtFsConnectParam
         goto clean;
     }
 
-    ListPush(gSvcContext.processes, process);
+    gSvcContext.processes[IPC_CLIENT_INDEX(processHandle)] = process;
     process = nullptr;
 
     status = STATUS_SUCCESS;
@@ -170,8 +170,6 @@ static Status RequestOpenFile(const ProcessHandle processHandle, LtFsOpenFilePar
 
     LOG(LOG_INFO, "Openning %s", parameters->filePath);
 
-    RaiseThreadPriority();
-
     status = OpenFileFromName(parameters->filePath, &file);
     if (FAILED(status))
     {
@@ -244,8 +242,6 @@ static Status RequestOpenFile(const ProcessHandle processHandle, LtFsOpenFilePar
     status = STATUS_SUCCESS;
 
 clean:
-    LowerThreadPriority();
-
     /*
         TODO : free memory
     */
@@ -279,6 +275,7 @@ static Status CreateProcessEntry(ProcessHandle processHandle, ProcessEntry ** pr
     }
 
     localProcess->processHandle = processHandle;
+    localProcess->fileEntries = ListCreate();
 
     *process = localProcess;
     localProcess = nullptr;
@@ -289,42 +286,9 @@ clean:
     return status;
 }
 
-struct LOOK_FOR_PROCESS_CONTEXT
-{
-    ProcessHandle processHandle;
-    ProcessEntry * processEntry;
-};
-
-static Status LookForProcessFromHandleCallback(void * data, void * context)
-{
-    ProcessEntry * entry = (ProcessEntry*)data;
-    LOOK_FOR_PROCESS_CONTEXT * ctx = (LOOK_FOR_PROCESS_CONTEXT*)context;
-
-    if (data == nullptr)
-    {
-        LOG(LOG_ERROR, "Invalid data parameter");
-        return STATUS_NULL_PARAMETER;
-    }
-
-    if (context == nullptr)
-    {
-        LOG(LOG_ERROR, "Invalid context parameter");
-        return STATUS_NULL_PARAMETER;
-    }
-
-    if (entry->processHandle == ctx->processHandle)
-    {
-        ctx->processEntry = entry;
-        return STATUS_LIST_STOP_ITERATING;
-    }
-
-    return STATUS_SUCCESS;
-}
-
 static Status LookForProcessFromHandle(ProcessHandle processHandle, ProcessEntry ** process)
 {
-    Status status = STATUS_FAILURE;
-    LOOK_FOR_PROCESS_CONTEXT context = { 0 };
+    ProcessEntry * entry = nullptr;
 
     if (processHandle == INVALID_HANDLE_VALUE)
     {
@@ -338,22 +302,14 @@ static Status LookForProcessFromHandle(ProcessHandle processHandle, ProcessEntry
         return STATUS_NULL_PARAMETER;
     }
 
-    context.processHandle = processHandle;
-    context.processEntry = nullptr;
-
-    status = ListEnumerate(gSvcContext.processes, LookForProcessFromHandleCallback, &context);
-    if (FAILED(status) && status != STATUS_LIST_STOP_ITERATING)
-    {
-        LOG(LOG_ERROR, "ListEnumerate() failed with code %t", status);
-        goto clean;
-    }
-
-    *process = context.processEntry;
+    // The slot may still hold a process that disconnected, whose index has been reused since
+    entry = gSvcContext.processes[IPC_CLIENT_INDEX(processHandle)];
+    if (entry != nullptr && entry->processHandle != processHandle)
+        entry = nullptr;
 
-    status = STATUS_SUCCESS;
+    *process = entry;
 
-clean:
-    return status;
+    return STATUS_SUCCESS;
 }
 
 struct LOOK_FOR_FILE_ENTRY_CONTEXT
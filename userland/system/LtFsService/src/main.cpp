@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <Ipc.hpp>
 #include <ServiceNames.h>
+#include <LtFsCommon.h>
 
 #include "AtaDriver.h"
 #include "FsManager.h"
@@ -13,6 +14,9 @@ static void StartListening();
 
 AtaDevice gDevice = { 0 };
 
+/// Requests are read in this buffer, it can hold the biggest message a client can send
+static char RequestBuffer[IPC_MAX_MESSAGE_SIZE];
+
 void main()
 {
     LOG(LOG_INFO, "Starting LtFs service...");
@@ -79,31 +83,30 @@ static void StartListening()
         return;
     }
 
-    char buffer[512];
-    unsigned int bytesRead = 0;
-    status = server.Receive(buffer, 512, &bytesRead);
-    LOG(LOG_INFO, "Message : %s", buffer);
-    LOG(LOG_INFO, "Bytes : %d", bytesRead);
-
-    //do
-    //{
-    //    IpcMessage message;
-    //    ProcessHandle clientHandle = INVALID_HANDLE_VALUE;
-
-    //    status = server.Receive(&message, &clientHandle);
-    //    if (FAILED(status))
-    //    {
-    //        LOG(LOG_ERROR, "IpcServer::Receive() failed with code %t", status);
-    //        break;
-    //    }
-
-    //    status = ServiceExecuteCommand(clientHandle, (char*)message.data, message.size, &serviceTerminate);
-    //    if (FAILED(status))
-    //    {
-    //        LOG(LOG_ERROR, "ServiceExecuteCommand() failed with code %t", status);
-    //        break;
-    //    }
-
-    //    // message.Release();
-    //} while (!serviceTerminate);
+    do
+    {
+        IpcSenderInfo sender;
+        unsigned int bytesRead = 0;
+
+        // The kernel tells us which client sent the request, it doesn't have to be part of the message
+        status = server.Receive(RequestBuffer, IPC_MAX_MESSAGE_SIZE, &bytesRead, &sender);
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "IpcServer::Receive() failed with code %t", status);
+            break;
+        }
+
+        if (bytesRead < sizeof(LtFsRequestType))
+        {
+            LOG(LOG_ERROR, "Ignoring a message of %d bytes from process %d", bytesRead, sender.pid);
+            continue;
+        }
+
+        // A bad request from a client is not a reason to stop serving the others
+        status = ServiceExecuteCommand((ProcessHandle)sender.clientHandle, RequestBuffer, bytesRead, &serviceTerminate);
+        if (FAILED(status))
+        {
+            LOG(LOG_ERROR, "ServiceExecuteCommand() failed with code %t (process %d)", status, sender.pid);
+        }
+    } while (!serviceTerminate);
 }
\ No newline at end of file